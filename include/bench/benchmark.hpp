@@ -0,0 +1,68 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace rng
+{
+
+    struct BenchmarkOptions
+    {
+        size_t warmup = 2;
+        size_t repetitions = 11;
+        double min_seconds = 0.02; // each repetition loops the body at least this long
+        std::vector<size_t> sizes = {1 << 11, 1 << 15, 1 << 20, 1 << 24};
+        size_t test_size = 1 << 20; // numbers per test run
+        std::string filter;         // only cases whose name contains this
+    };
+
+    struct BenchmarkResult
+    {
+        std::string group;   // "generator", "test" or "bit_test"
+        std::string name;    // generator or test name
+        std::string variant; // code path measured
+        size_t size = 0;     // numbers processed per call
+        size_t repetitions = 0;
+        double median_ns = 0.0; // per number
+        double p10_ns = 0.0;
+        double p90_ns = 0.0;
+        double min_ns = 0.0;
+        double gb_per_s = 0.0; // bytes of doubles produced or consumed, at the median
+
+        std::string key() const;
+    };
+
+    // Times body(), which handles `size` numbers per call: warm-up calls
+    // first, then `repetitions` samples of ns per number, each averaging
+    // as many calls as fit in min_seconds
+    BenchmarkResult measure(const std::string &group, const std::string &name, const std::string &variant,
+                            size_t size, const BenchmarkOptions &options, const std::function<void()> &body);
+
+    // Every generator's generate(), generate_sequence() and fill() at every
+    // size, then every test's run_test() on options.test_size numbers and
+    // every bit test's on the raw bits of as many outputs (timed per output)
+    std::vector<BenchmarkResult> run_benchmarks(const BenchmarkOptions &options, std::ostream *progress);
+
+    // CPU model, core count, frequency scaling state and build type, with a
+    // warning when the numbers are likely to be noisy
+    std::vector<std::pair<std::string, std::string>> describe_environment();
+
+    void write_benchmarks_csv(std::ostream &out, const std::vector<BenchmarkResult> &results);
+    void write_benchmarks_json(std::ostream &out, const std::vector<BenchmarkResult> &results);
+    void write_benchmarks_table(std::ostream &out, const std::vector<BenchmarkResult> &results);
+
+    // Reads results written by write_benchmarks_csv(); throws std::runtime_error
+    std::vector<BenchmarkResult> read_benchmarks_csv(const std::string &path);
+
+    // Compares medians with a baseline by key. A case is a regression when it
+    // is slower by more than `threshold` (0.1 = 10%). Writes one line per
+    // case found in both and returns the number of regressions.
+    size_t compare_benchmarks(std::ostream &out, const std::vector<BenchmarkResult> &baseline,
+                              const std::vector<BenchmarkResult> &current, double threshold);
+
+} // namespace rng
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,140 @@
+#ifndef RNG_C_H
+#define RNG_C_H
+
+/*
+ * C interface of rng_core for callers outside C++.
+ *
+ * Generators and streaming tests are opaque handles owned by the caller and
+ * released with the matching _destroy call. Numbers cross the boundary in
+ * whole buffers: one rng_generator_fill() or rng_test_update() call handles
+ * any number of values. Calls that can fail return an rng_status; the message
+ * of the last failure on the calling thread is available from
+ * rng_last_error(). A handle may be used by one thread at a time.
+ *
+ * Generators and tests are created by kind: a fixed lowercase key such as
+ * "mrg32k3a" or "poker", listed by the _kind_name() calls. Keys do not change
+ * within an ABI version, unlike the display names from rng_generator_name()
+ * and rng_test_name().
+ *
+ * The ABI is versioned by RNG_C_ABI_VERSION. Existing functions keep their
+ * signatures and meaning within a version; new ones may be added.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(RNG_CORE_SHARED)
+#ifdef RNG_CORE_BUILDING
+#define RNG_API __declspec(dllexport)
+#else
+#define RNG_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define RNG_API __attribute__((visibility("default")))
+#else
+#define RNG_API
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define RNG_C_ABI_VERSION 1
+
+    typedef struct rng_generator rng_generator;
+    typedef struct rng_test rng_test;
+
+    typedef enum rng_status
+    {
+        RNG_OK = 0,
+        RNG_ERROR_INVALID_ARGUMENT = 1, /* null pointer, unknown kind, bad state */
+        RNG_ERROR_RUNTIME = 2,
+        RNG_ERROR_OUT_OF_MEMORY = 3
+    } rng_status;
+
+    /* Version the library was built with; compare with RNG_C_ABI_VERSION */
+    RNG_API uint32_t rng_abi_version(void);
+
+    /* Message of the last failed call on this thread, "" if none */
+    RNG_API const char *rng_last_error(void);
+
+    /* ---- Generators ---- */
+
+    /* Kinds accepted by rng_generator_create(), index 0 .. count-1 */
+    RNG_API size_t rng_generator_kind_count(void);
+    RNG_API const char *rng_generator_kind_name(size_t index);
+
+    RNG_API rng_status rng_generator_create(const char *kind, uint64_t seed, rng_generator **out);
+    RNG_API rng_status rng_generator_clone(const rng_generator *generator, rng_generator **out);
+    RNG_API void rng_generator_destroy(rng_generator *generator);
+
+    /* Display name with the parameters, valid until the handle is destroyed */
+    RNG_API const char *rng_generator_name(const rng_generator *generator);
+
+    RNG_API rng_status rng_generator_seed(rng_generator *generator, uint64_t seed);
+
+    /* Next `count` uniform numbers in [0, 1) */
+    RNG_API rng_status rng_generator_fill(rng_generator *generator, double *out, size_t count);
+
+    /* Next `count` raw outputs; only the low rng_generator_raw_bits() bits carry randomness */
+    RNG_API rng_status rng_generator_fill_raw(rng_generator *generator, uint64_t *out, size_t count);
+    RNG_API unsigned rng_generator_raw_bits(const rng_generator *generator);
+
+    /* Skips `steps` outputs, in logarithmic time when supported (1) and by
+     * stepping otherwise (0) */
+    RNG_API rng_status rng_generator_jump(rng_generator *generator, uint64_t steps);
+    RNG_API int rng_generator_supports_jump(const rng_generator *generator);
+
+    /* Creates `count` generators for the next `count` blocks of `stride`
+     * outputs: out[i] starts i * stride outputs ahead of `generator`, which
+     * then skips past all of them. Streams do not overlap as long as none
+     * draws more than `stride` numbers. On failure nothing is created. */
+    RNG_API rng_status rng_generator_split(rng_generator *generator, uint64_t stride, size_t count,
+                                           rng_generator **out);
+
+    /* Complete state as 64-bit words. get_state stores the number of words in
+     * *words and fails with RNG_ERROR_INVALID_ARGUMENT, writing nothing, if
+     * it exceeds `capacity` (pass 0 to query the size). */
+    RNG_API rng_status rng_generator_get_state(const rng_generator *generator, uint64_t *state,
+                                               size_t capacity, size_t *words);
+    RNG_API rng_status rng_generator_set_state(rng_generator *generator, const uint64_t *state, size_t words);
+
+    /* ---- Streaming test accumulators ---- */
+
+    /* Kinds accepted by rng_test_create(), index 0 .. count-1 */
+    RNG_API size_t rng_test_kind_count(void);
+    RNG_API const char *rng_test_kind_name(size_t index);
+
+    RNG_API rng_status rng_test_create(const char *kind, rng_test **out);
+    /* Test of the same kind with an empty accumulator */
+    RNG_API rng_status rng_test_clone_empty(const rng_test *test, rng_test **out);
+    RNG_API void rng_test_destroy(rng_test *test);
+
+    RNG_API const char *rng_test_name(const rng_test *test);
+
+    RNG_API rng_status rng_test_reset(rng_test *test);
+
+    /* Feeds the next `count` numbers of the sequence */
+    RNG_API rng_status rng_test_update(rng_test *test, const double *numbers, size_t count);
+
+    /* Folds in `other`, a test of the same kind and parameters that saw the
+     * part of the sequence immediately following the one `test` saw */
+    RNG_API rng_status rng_test_merge(rng_test *test, const rng_test *other);
+
+    /* Computes the statistic so far; either output pointer may be null */
+    RNG_API rng_status rng_test_evaluate(rng_test *test, double significance_level, double *p_value,
+                                         int *passed);
+
+    /* Text of the last evaluation, valid until the next call on the handle */
+    RNG_API const char *rng_test_result(rng_test *test);
+
+    /* Accumulator as bytes for checkpointing, sized like rng_generator_get_state() */
+    RNG_API rng_status rng_test_save_state(const rng_test *test, void *buffer, size_t capacity, size_t *size);
+    RNG_API rng_status rng_test_load_state(rng_test *test, const void *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RNG_C_H */
@@ -0,0 +1,153 @@
+#ifndef DISTRIBUTIONS_HPP
+#define DISTRIBUTIONS_HPP
+
+#include "../rng.hpp"
+#include <memory>
+#include <string>
+
+namespace rng
+{
+
+    // Non-uniform variates drawn from any RandomGenerator. sample_batch()
+    // takes its uniforms from the generator's fill() path in blocks and runs
+    // a branch-free first pass over the block that the compiler can vectorize,
+    // with rare rejections fixed up afterwards. Tables are built once per
+    // instance (Ziggurat tables once per process). An instance keeps scratch
+    // buffers and must not be shared between threads.
+    class Distribution
+    {
+    public:
+        virtual ~Distribution() = default;
+
+        virtual double sample(RandomGenerator &generator) = 0;
+        virtual void sample_batch(RandomGenerator &generator, double *out, size_t count);
+
+        // Cumulative distribution function, used to map samples back to
+        // uniforms so the transform itself can be tested
+        virtual double cdf(double x) const = 0;
+        virtual bool is_discrete() const { return false; }
+
+        virtual std::string get_name() const = 0;
+        virtual std::unique_ptr<Distribution> clone() const = 0;
+
+    protected:
+        std::vector<double> uniforms_; // scratch for batch sampling
+    };
+
+    // Normal(mean, stddev) by the Ziggurat method with 128 layers
+    class NormalDistribution : public Distribution
+    {
+    public:
+        NormalDistribution(double mean = 0.0, double stddev = 1.0);
+        double sample(RandomGenerator &generator) override;
+        void sample_batch(RandomGenerator &generator, double *out, size_t count) override;
+        double cdf(double x) const override;
+        std::string get_name() const override;
+        std::unique_ptr<Distribution> clone() const override;
+
+    private:
+        const double mean_;
+        const double stddev_;
+    };
+
+    // Exponential(rate) by the Ziggurat method with 256 layers
+    class ExponentialDistribution : public Distribution
+    {
+    public:
+        explicit ExponentialDistribution(double rate = 1.0);
+        double sample(RandomGenerator &generator) override;
+        void sample_batch(RandomGenerator &generator, double *out, size_t count) override;
+        double cdf(double x) const override;
+        std::string get_name() const override;
+        std::unique_ptr<Distribution> clone() const override;
+
+    private:
+        const double rate_;
+    };
+
+    // Gamma(shape, scale) by Marsaglia and Tsang's squeeze method on top of
+    // Ziggurat normals; shapes below 1 use the boost X * U^(1/shape)
+    class GammaDistribution : public Distribution
+    {
+    public:
+        GammaDistribution(double shape = 1.0, double scale = 1.0);
+        double sample(RandomGenerator &generator) override;
+        void sample_batch(RandomGenerator &generator, double *out, size_t count) override;
+        double cdf(double x) const override;
+        std::string get_name() const override;
+        std::unique_ptr<Distribution> clone() const override;
+
+    private:
+        // Shape the squeeze runs on: shape + 1 for shapes below 1
+        double squeeze_shape() const;
+        // Gamma(squeeze_shape(), 1) draw, looping until a candidate is accepted
+        double marsaglia_tsang(RandomGenerator &generator);
+
+        const double shape_;
+        const double scale_;
+        NormalDistribution normal_;
+        std::vector<double> normals_; // scratch for batch sampling
+    };
+
+    // Integer distribution sampled through Walker's alias table over the
+    // central range [first, first + size) that holds all but a negligible
+    // mass; the two tails are kept as extra outcomes and, when drawn, are
+    // sampled by inversion, so the result is exact.
+    class AliasTableDistribution : public Distribution
+    {
+    public:
+        double sample(RandomGenerator &generator) override;
+        void sample_batch(RandomGenerator &generator, double *out, size_t count) override;
+        double cdf(double x) const override;
+        bool is_discrete() const override { return true; }
+
+    protected:
+        // Builds the table for support [0, support_max] around `mean` +- 10 sd
+        void build(double mean, double stddev, uint64_t support_max);
+        virtual double log_pmf(uint64_t k) const = 0;
+
+    private:
+        uint64_t first_ = 0;
+        uint64_t support_max_ = 0;
+        std::vector<double> accept_;     // probability of keeping column j
+        std::vector<uint32_t> alias_;    // outcome taken otherwise
+        std::vector<double> cumulative_; // cdf at first_ + j
+        double lower_tail_ = 0.0;        // mass below first_
+        double upper_tail_ = 0.0;        // mass above the table
+
+        double resolve(size_t outcome, RandomGenerator &generator) const;
+        double sample_tail(bool upper, double u) const;
+    };
+
+    class PoissonDistribution : public AliasTableDistribution
+    {
+    public:
+        explicit PoissonDistribution(double mean = 1.0);
+        std::string get_name() const override;
+        std::unique_ptr<Distribution> clone() const override;
+
+    protected:
+        double log_pmf(uint64_t k) const override;
+
+    private:
+        const double mean_;
+    };
+
+    class BinomialDistribution : public AliasTableDistribution
+    {
+    public:
+        BinomialDistribution(uint64_t trials = 1, double probability = 0.5);
+        std::string get_name() const override;
+        std::unique_ptr<Distribution> clone() const override;
+
+    protected:
+        double log_pmf(uint64_t k) const override;
+
+    private:
+        const uint64_t trials_;
+        const double probability_;
+    };
+
+} // namespace rng
+
+#endif // DISTRIBUTIONS_HPP
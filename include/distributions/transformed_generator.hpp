@@ -0,0 +1,47 @@
+#ifndef TRANSFORMED_GENERATOR_HPP
+#define TRANSFORMED_GENERATOR_HPP
+
+#include "../rng.hpp"
+#include "distributions.hpp"
+
+namespace rng
+{
+
+    // Generator whose outputs are variates of `distribution` drawn from
+    // `base`, mapped back to [0, 1) through the distribution's cdf. If the
+    // sampler is right the result is uniform, so every test in the suite
+    // also checks the transform. Discrete variates use the randomized
+    // transform F(k - 1) + V (F(k) - F(k - 1)) with an extra uniform V.
+    // State and seeding are those of the base generator. Rejections and V
+    // make each variate take a variable number of base outputs, and fill()
+    // draws them a block at a time, so there is no jump shortcut: the
+    // default jump_ahead() steps through generate().
+    class TransformedGenerator : public RandomGenerator
+    {
+    public:
+        TransformedGenerator(std::unique_ptr<RandomGenerator> base, std::unique_ptr<Distribution> distribution);
+        TransformedGenerator(const TransformedGenerator &other);
+
+        double generate() override;
+        std::vector<double> generate_sequence(size_t count) override;
+        void fill(double *out, size_t count) override;
+        std::string get_name() const override;
+        void set_seed(uint64_t seed) override;
+        uint64_t generate_raw() override;
+        unsigned raw_bits() const override;
+        std::unique_ptr<RandomGenerator> clone() const override;
+        std::vector<uint64_t> get_state() const override;
+        void set_state(const std::vector<uint64_t> &state) override;
+
+    private:
+        std::unique_ptr<RandomGenerator> base_;
+        std::unique_ptr<Distribution> distribution_;
+        std::vector<double> variates_;
+        std::vector<double> offsets_;
+
+        double to_uniform(double variate, double offset) const;
+    };
+
+} // namespace rng
+
+#endif // TRANSFORMED_GENERATOR_HPP
@@ -0,0 +1,118 @@
+#ifndef BATTERY_HPP
+#define BATTERY_HPP
+
+#include "../rng.hpp"
+#include <functional>
+#include <map>
+#include <string>
+
+namespace rng
+{
+
+    enum class BatteryTier
+    {
+        Quick,      // one setting per test, 2^16 numbers each
+        Standard,   // more settings, 2^20 numbers each
+        Exhaustive  // the most settings and higher dimensions, 2^24 numbers each
+    };
+
+    // One test of a battery with the sample it runs on
+    struct BatteryEntry
+    {
+        std::string label; // names the parameter setting, unique in the battery
+        std::function<std::unique_ptr<RandomnessTest>()> make;
+        size_t sample_size = 0;
+        // Rough prior of how often the test catches a defective generator
+        // relative to the others; the scheduler favours power per second
+        double power = 1.0;
+    };
+
+    struct Battery
+    {
+        std::string name;
+        std::vector<BatteryEntry> entries;
+    };
+
+    Battery make_battery(BatteryTier tier);
+
+    // Nanoseconds per number of each test, keyed by get_test_name(), and of
+    // the generator producing the data
+    struct CostModel
+    {
+        std::map<std::string, double> test_ns;
+        double generator_ns = 0.0;
+        double default_test_ns = 100.0; // for tests without data
+
+        double estimate_seconds(const BatteryEntry &entry, const std::string &test_name) const;
+    };
+
+    // Costs from results written by `rng_bench --format csv`: each test's
+    // run_test at its largest size and the generator's fill() at its largest
+    // size. Throws std::runtime_error if the file cannot be read.
+    CostModel load_cost_model(const std::string &benchmark_csv, const std::string &generator_name);
+
+    // Costs measured on the spot: each test of the battery runs once on
+    // calibration_size numbers and the generator fills as many
+    CostModel calibrate_cost_model(const Battery &battery, const RandomGenerator &generator,
+                                   size_t calibration_size = 1 << 15);
+
+    class ResultCache;
+
+    struct BatteryOptions
+    {
+        double significance_level = 0.01;
+        double time_budget_seconds = 0.0; // 0: run everything
+        size_t num_threads = 0;
+        ResultCache *cache = nullptr; // results looked up before and stored after each run
+    };
+
+    enum class BatteryStatus
+    {
+        Passed,
+        Failed,
+        Skipped // left out to meet the time budget
+    };
+
+    struct BatteryResult
+    {
+        std::string label;
+        std::string test_name;
+        size_t sample_size = 0;
+        BatteryStatus status = BatteryStatus::Skipped;
+        double p_value = 0.0;
+        double estimated_seconds = 0.0;
+        double actual_seconds = 0.0;
+        size_t core = 0;     // worker the entry was scheduled on
+        bool cached = false; // taken from the result cache
+    };
+
+    struct BatteryReport
+    {
+        std::string battery_name;
+        std::vector<BatteryResult> results; // in battery order
+        size_t cores = 0;
+        double planned_makespan = 0.0; // estimated seconds of the busiest worker
+        double elapsed_seconds = 0.0;
+    };
+
+    // Runs a battery on a generator. Entry i tests the numbers that follow
+    // those of entries 0..i-1 in the generator's stream, however the entries
+    // are scheduled, so the p-values do not depend on the thread count.
+    //
+    // Entries are taken in decreasing power per estimated second as long as
+    // the planned makespan stays within the time budget; the rest are
+    // skipped. The chosen entries are packed onto the workers longest first,
+    // each going to the least loaded worker (Graham's LPT rule, within 4/3 of
+    // the best makespan), and every worker runs its entries in decreasing
+    // power per second, so the most informative results arrive first. An
+    // entry that has not started when the budget has run out is skipped.
+    // With a cache, entries found there are reported without being run and
+    // new results are added to it.
+    BatteryReport run_battery(const RandomGenerator &generator, const Battery &battery,
+                              const CostModel &costs, const BatteryOptions &options);
+
+    std::string format_battery(const BatteryReport &report);
+
+} // namespace rng
+
+#endif // BATTERY_HPP
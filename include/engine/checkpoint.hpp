@@ -0,0 +1,66 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include "../rng.hpp"
+#include <string>
+
+namespace rng
+{
+
+    // Everything needed to continue a streaming run where it stopped
+    struct Checkpoint
+    {
+        std::string generator_name;
+        // generator_fingerprint() of the generator before its first number,
+        // which pins down its parameters and seed
+        std::string generator_start;
+        std::vector<uint64_t> generator_state;
+        uint64_t total_numbers = 0;
+        uint64_t numbers_done = 0;
+        uint64_t num_threads = 0; // resolved count, never 0 in a written file
+        std::vector<std::string> test_configs; // RandomnessTest::get_config()
+        std::vector<std::string> test_states;  // StreamingTest::save_state() blobs
+    };
+
+    // Replaces `path` with the checkpoint: the data goes to a temporary file
+    // in the same directory, is flushed to disk and then renamed over `path`,
+    // and the directory is flushed too, so a crash leaves either the old or
+    // the new checkpoint, never a torn one.
+    void write_checkpoint(const std::string &path, const Checkpoint &checkpoint);
+
+    // Returns false if there is no file at `path`. Throws std::runtime_error
+    // if the file is not a checkpoint, fails its checksum or has trailing bytes.
+    bool read_checkpoint(const std::string &path, Checkpoint &checkpoint);
+
+    struct CheckpointOptions
+    {
+        std::string path;
+        uint64_t total_numbers = 0;
+        uint64_t interval = 1ULL << 26; // numbers between checkpoints
+        size_t num_threads = 0;
+        bool remove_when_done = true;
+    };
+
+    struct CheckpointedRunResult
+    {
+        std::vector<bool> verdicts;
+        bool resumed = false;
+        uint64_t resumed_at = 0; // numbers already tested when resuming
+        uint64_t checkpoints_written = 0;
+    };
+
+    // Feeds `total_numbers` outputs of the generator to the tests, writing a
+    // checkpoint of the generator state and the test accumulators every
+    // `interval` numbers. If `path` holds a checkpoint of the same run (the
+    // generator with the same parameters and seed, tests with the same
+    // get_config(), the same length and thread count), the run continues
+    // from it and produces exactly the verdicts of an uninterrupted run. A
+    // checkpoint of a different run is rejected with std::invalid_argument.
+    CheckpointedRunResult run_checkpointed(RandomGenerator &generator,
+                                           const std::vector<StreamingTest *> &tests,
+                                           const CheckpointOptions &options,
+                                           double significance_level);
+
+} // namespace rng
+
+#endif // CHECKPOINT_HPP
@@ -0,0 +1,71 @@
+#ifndef DISTRIBUTED_HPP
+#define DISTRIBUTED_HPP
+
+#include "../rng.hpp"
+
+namespace rng
+{
+
+    // How the coordinator talks to its worker processes; the frames are the same
+    enum class DistributedTransport
+    {
+        UnixSocket, // a socket pair per worker
+        LoopbackTcp // a TCP connection to 127.0.0.1, as workers on other hosts would use
+    };
+
+    struct DistributedOptions
+    {
+        uint64_t total_numbers = 0;
+        uint64_t shard_size = 1ULL << 22; // numbers per unit of work
+        size_t workers = 2;               // worker processes; 0 runs every shard in this process
+        size_t max_restarts = 8;          // replacement workers forked after crashes or hangs
+        size_t threads_per_worker = 1;    // feed_fused() threads per shard, 0 for all cores
+        DistributedTransport transport = DistributedTransport::UnixSocket;
+        // A worker that has not answered a shard this long after it was sent
+        // is taken as hung, killed and replaced; 0 waits forever
+        double shard_timeout_seconds = 600.0;
+    };
+
+    struct DistributedResult
+    {
+        std::vector<bool> verdicts;
+        uint64_t shards = 0;
+        uint64_t worker_failures = 0;   // workers that died, hung up or timed out
+        uint64_t timed_out_workers = 0; // of those, killed after shard_timeout_seconds
+        uint64_t reassigned_shards = 0; // shards sent again after a failure
+        double elapsed_seconds = 0.0;
+    };
+
+    // Feeds `total_numbers` outputs of the generator, from its current state,
+    // to the tests, with the work split over worker processes.
+    //
+    // The coordinator cuts the sequence into shards of `shard_size` numbers
+    // and sends each idle worker, over a Unix-domain socket or loopback TCP,
+    // the generator state at the start of the next shard together with a
+    // generator_fingerprint() of it and the get_config() of every test. The
+    // worker refuses a shard its own generator or tests do not match, runs
+    // fresh copies of the tests over it and answers with their save_state()
+    // blobs, which the coordinator loads and merges in sequence order as
+    // soon as every earlier shard is in. A worker that dies, closes its
+    // socket mid-shard or does not answer within `shard_timeout_seconds` is
+    // killed and reaped, its shard goes back to the front of the queue and
+    // a replacement is forked, up to `max_restarts` times.
+    //
+    // Every streaming test merges exactly, so the verdicts and p-values are
+    // identical to an unsharded run over the same numbers, whatever the
+    // shard size, the number of workers, which shard went where or which
+    // workers failed. Only floating-point sums (the serial correlation's)
+    // are grouped by shard and by thread, as they are by the threads of
+    // run_fused(), and agree to rounding. Worker processes are forked from
+    // this one and inherit the generator parameters and tests. On return
+    // the generator has advanced by `total_numbers` outputs. Throws
+    // std::runtime_error if a test fails inside a worker, a worker does not
+    // match the run or every worker is lost.
+    DistributedResult run_distributed(RandomGenerator &generator,
+                                      const std::vector<StreamingTest *> &tests,
+                                      const DistributedOptions &options,
+                                      double significance_level);
+
+} // namespace rng
+
+#endif // DISTRIBUTED_HPP
@@ -0,0 +1,36 @@
+#ifndef FUSED_RUNNER_HPP
+#define FUSED_RUNNER_HPP
+
+#include "../rng.hpp"
+#include "../utils/data_source.hpp"
+
+namespace rng
+{
+
+    // Runs several streaming tests over a sequence in a single pass.
+    //
+    // The data is cut into one contiguous part per thread. Each part is fed
+    // to its own copies of the tests in cache-sized chunks, so every chunk is
+    // read from memory once for all tests. The copies are then merged back
+    // in sequence order. Returns the verdict of each test.
+    std::vector<bool> run_fused(const std::vector<StreamingTest *> &tests,
+                                const std::vector<double> &numbers,
+                                double significance_level,
+                                size_t num_threads = 0);
+
+    // Feeds the next `count` numbers to tests that already hold the earlier
+    // part of the sequence, without resetting or evaluating them
+    void feed_fused(const std::vector<StreamingTest *> &tests,
+                    const double *numbers, size_t count,
+                    size_t num_threads = 0);
+
+    // Same for a source that can only be read once: blocks of one part per
+    // thread are read, tested in parallel and merged before the next read
+    std::vector<bool> run_fused(const std::vector<StreamingTest *> &tests,
+                                DataSource &source,
+                                double significance_level,
+                                size_t num_threads = 0);
+
+} // namespace rng
+
+#endif // FUSED_RUNNER_HPP
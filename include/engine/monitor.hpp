@@ -0,0 +1,128 @@
+#ifndef MONITOR_HPP
+#define MONITOR_HPP
+
+#include "../rng.hpp"
+#include "../utils/data_source.hpp"
+#include <functional>
+#include <string>
+
+namespace rng
+{
+
+    enum class MonitorStatistic
+    {
+        ChiSquare,        // uniformity over equal bins
+        Runs,             // runs up and down
+        SerialCorrelation // lag-1 correlation
+    };
+
+    constexpr size_t MONITOR_STATISTICS = 3;
+
+    enum class AlertKind
+    {
+        Raised,  // the window p-value stayed at or below alert_level
+        Cleared, // and then stayed above it again
+        Drift    // p-values of disjoint windows are not uniform
+    };
+
+    struct MonitorAlert
+    {
+        uint64_t sample = 0; // numbers accepted when the alert was emitted
+        MonitorStatistic statistic = MonitorStatistic::ChiSquare;
+        AlertKind kind = AlertKind::Raised;
+        double p_value = 0.0;
+    };
+
+    using AlertHandler = std::function<void(const MonitorAlert &)>;
+
+    struct MonitorOptions
+    {
+        size_t window = 1 << 16;    // numbers per window, at most 2^24
+        size_t step = 1 << 12;      // numbers between evaluations; window for tumbling windows
+        size_t chi_square_bins = 10;
+        double alert_level = 1e-4;
+        size_t persistence = 2;     // evaluations in a row that raise or clear an alert
+        size_t drift_windows = 32;  // disjoint windows per drift check, 0 for none
+        double drift_level = 1e-3;  // Kolmogorov-Smirnov level of the drift check
+    };
+
+    // Sliding-window chi-square, runs and serial-correlation statistics over
+    // the last `window` numbers of an unbounded stream.
+    //
+    // Every number updates the statistics in O(1): the window is a ring, and
+    // the number that falls out is taken back out of the bin counts, the
+    // direction-change count and the pair sums. Pair sums are kept on values
+    // rounded to 2^-20 in integers, so adding and removing cancel exactly and
+    // nothing drifts however long the stream runs. P-values are computed only
+    // every `step` numbers once the window is full. Numbers outside [0, 1]
+    // are counted and dropped.
+    class WindowMonitor
+    {
+    public:
+        // Throws std::invalid_argument for unusable options
+        explicit WindowMonitor(const MonitorOptions &options, AlertHandler on_alert = AlertHandler());
+
+        void push(double number);
+        void push(const double *numbers, size_t count);
+
+        double get_p_value(MonitorStatistic statistic) const;
+        bool in_alarm(MonitorStatistic statistic) const;
+        uint64_t samples() const { return seen_; }
+        uint64_t rejected() const { return rejected_; }
+        uint64_t evaluations() const { return evaluations_; }
+
+    private:
+        struct Tracker
+        {
+            double p_value = 1.0;
+            size_t streak = 0; // evaluations in a row that disagree with `alarmed`
+            bool alarmed = false;
+            std::vector<double> window_p_values; // of disjoint windows, for the drift check
+        };
+
+        const MonitorOptions options_;
+        AlertHandler on_alert_;
+
+        // Rings indexed by sample number modulo the window
+        std::vector<int64_t> centred_; // (x - 0.5) * 2^20
+        std::vector<uint32_t> bins_;
+        std::vector<uint8_t> changes_; // whether sample i turned direction from i-1
+        size_t position_;
+
+        std::vector<int64_t> bin_counts_;
+        int64_t sum_squared_counts_;
+        int64_t window_changes_;
+        double last_value_;
+        bool last_increasing_;
+        int64_t sum_x_, sum_y_, sum_xx_, sum_yy_, sum_xy_; // over pairs (x_(i-1), x_i)
+
+        uint64_t seen_;
+        uint64_t rejected_;
+        uint64_t evaluations_;
+        size_t until_evaluation_;
+        Tracker trackers_[MONITOR_STATISTICS];
+
+        void evaluate();
+        void track(MonitorStatistic statistic, double p_value, bool window_boundary);
+    };
+
+    struct MonitorSummary
+    {
+        uint64_t samples = 0;
+        uint64_t rejected = 0;
+        uint64_t evaluations = 0;
+        uint64_t alerts = 0;
+        double update_seconds = 0.0; // time spent in the monitor, without reading
+    };
+
+    // Feeds everything `source` yields to a monitor, `chunk` numbers at a
+    // time, until the source is exhausted
+    MonitorSummary run_monitor(DataSource &source, const MonitorOptions &options,
+                               const AlertHandler &on_alert, size_t chunk = 1024);
+
+    std::string statistic_to_string(MonitorStatistic statistic);
+    std::string format_alert(const MonitorAlert &alert);
+
+} // namespace rng
+
+#endif // MONITOR_HPP
@@ -0,0 +1,79 @@
+#ifndef PERIOD_ANALYSIS_HPP
+#define PERIOD_ANALYSIS_HPP
+
+#include "../rng.hpp"
+#include <string>
+#include <utility>
+
+namespace rng
+{
+
+    class LCG;
+    class MCG;
+
+    // Outcome of Brent's cycle detection from the generator's current state
+    struct CycleDetection
+    {
+        bool found = false;       // false when max_steps ran out first
+        uint64_t tail_length = 0; // outputs before the sequence enters its cycle
+        uint64_t period = 0;
+        uint64_t steps = 0; // generator steps spent
+    };
+
+    // Walks the state sequence with Brent's algorithm, keeping only two state
+    // copies. The generator itself is left untouched. States are compared
+    // through get_state(), after a cheap check of the raw outputs.
+    CycleDetection detect_cycle(const RandomGenerator &generator, uint64_t max_steps);
+
+    // One cycle of the functional graph state -> next state
+    struct OrbitCycle
+    {
+        uint64_t smallest_state = 0; // canonical representative
+        uint64_t length = 0;
+        uint64_t basin_size = 0; // states ending up on the cycle, the cycle included
+        uint64_t longest_tail = 0;
+    };
+
+    struct OrbitMap
+    {
+        uint64_t state_count = 0;
+        std::vector<OrbitCycle> cycles; // sorted by decreasing basin size
+    };
+
+    // Largest state space the exhaustive mapping accepts (about 12 bytes per state)
+    constexpr uint64_t MAX_ORBIT_STATES = 1ULL << 28;
+
+    // Maps every single-word state in [0, state_count) to its successor in
+    // parallel and decomposes the graph into cycles and their basins. Throws
+    // std::invalid_argument if the generator's state is not a single word or
+    // a successor falls outside [0, state_count).
+    OrbitMap map_orbits(const RandomGenerator &generator, uint64_t state_count, size_t num_threads = 0);
+
+    // Period derived from the parameters rather than by stepping
+    struct AnalyticPeriod
+    {
+        uint64_t period = 0;      // period of the orbit through the given state
+        uint64_t max_period = 0;  // best period any state can reach with this modulus
+        bool full_period = false; // period equals max_period
+        std::string explanation;
+    };
+
+    // Prime factorization as (prime, exponent) pairs in increasing order
+    std::vector<std::pair<uint64_t, unsigned>> factorize(uint64_t n);
+
+    // x -> (a x + c) mod m. Reports the Hull-Dobell conditions and the exact
+    // period of the orbit through `state`, from the factorization of m.
+    AnalyticPeriod analyze_lcg(uint64_t a, uint64_t c, uint64_t m, uint64_t state);
+    AnalyticPeriod analyze_lcg(const LCG &generator);
+
+    // x -> a x mod m, period = multiplicative order of a modulo m / gcd(x, m)
+    AnalyticPeriod analyze_mcg(uint64_t a, uint64_t m, uint64_t state);
+    AnalyticPeriod analyze_mcg(const MCG &generator);
+
+    std::string format_cycle_detection(const CycleDetection &result);
+    std::string format_orbit_map(const OrbitMap &map, size_t max_cycles = 10);
+    std::string format_analytic_period(const AnalyticPeriod &result);
+
+} // namespace rng
+
+#endif // PERIOD_ANALYSIS_HPP
@@ -0,0 +1,41 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include "../rng.hpp"
+
+namespace rng
+{
+
+    struct PipelineOptions
+    {
+        size_t buffer_size = 1 << 16; // numbers per buffer
+        size_t buffer_count = 8;      // buffers in the ring
+        size_t test_threads = 0;      // 0: one per core left after the generator
+    };
+
+    struct PipelineStats
+    {
+        double elapsed_seconds = 0.0;
+        double generate_seconds = 0.0; // producer time spent filling buffers
+        double stalled_seconds = 0.0;  // producer time spent waiting for a free buffer
+        uint64_t buffers_filled = 0;
+        size_t test_threads = 0;
+    };
+
+    // Generates `count` numbers and tests them at the same time. The calling
+    // thread fills a ring of fixed-size buffers while the tests, split into
+    // one stage per test thread, consume every buffer in order. A buffer is
+    // refilled only after all stages are done with it, so memory stays at
+    // buffer_count * buffer_size numbers and a slow stage holds the generator
+    // back instead of letting data pile up. Each test sees the whole sequence
+    // in order, so the verdicts equal those of a sequential run.
+    std::vector<bool> run_pipelined(RandomGenerator &generator,
+                                    const std::vector<StreamingTest *> &tests,
+                                    uint64_t count,
+                                    double significance_level,
+                                    const PipelineOptions &options = PipelineOptions(),
+                                    PipelineStats *stats = nullptr);
+
+} // namespace rng
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,84 @@
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include "../rng.hpp"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace rng
+{
+
+    struct CachedResult
+    {
+        double p_value = 0.0;
+        bool passed = false;
+        double seconds = 0.0; // what the original run cost
+    };
+
+    // Persistent map from a test configuration to its outcome.
+    //
+    // Results are appended to one file as checksummed records and never
+    // rewritten. The index is read into memory when the cache is opened; a
+    // record that was cut short by a crash ends the file and is truncated
+    // away. Each record goes out in a single write() under an exclusive
+    // flock(), so threads and processes may share a file. A lookup that
+    // misses first reads whatever other writers appended since.
+    //
+    // Keys are the texts built by make_cache_key(); records are addressed by
+    // a 128-bit hash of the text and the stored text is compared on a hit.
+    class ResultCache
+    {
+    public:
+        // Opens or creates the file; throws std::runtime_error
+        explicit ResultCache(const std::string &path);
+        ~ResultCache();
+        ResultCache(const ResultCache &) = delete;
+        ResultCache &operator=(const ResultCache &) = delete;
+
+        bool lookup(const std::string &key, CachedResult &result);
+        void store(const std::string &key, const CachedResult &result);
+
+        size_t size() const;
+        const std::string &path() const { return path_; }
+
+    private:
+        struct Entry
+        {
+            std::string key;
+            CachedResult result;
+        };
+
+        struct DigestHash
+        {
+            size_t operator()(const std::pair<uint64_t, uint64_t> &digest) const
+            {
+                return static_cast<size_t>(digest.first);
+            }
+        };
+
+        std::string path_;
+        int fd_;
+        uint64_t read_offset_; // file bytes already in the index
+        mutable std::mutex mutex_;
+        std::unordered_map<std::pair<uint64_t, uint64_t>, Entry, DigestHash> index_;
+
+        // Reads records appended since read_offset_; caller holds mutex_
+        void catch_up();
+    };
+
+    // Identifies a generator by what it will produce: its name, its current
+    // state words and a hash of the next 64 raw outputs of a copy. Two
+    // generators with the same fingerprint give the same sequence for all
+    // practical purposes, whatever parameters they were built with.
+    std::string generator_fingerprint(const RandomGenerator &generator);
+
+    // Key of one test run: `offset` numbers into the stream of the
+    // fingerprinted generator, `length` numbers, the test configuration
+    // from RandomnessTest::get_config() and the significance level
+    std::string make_cache_key(const std::string &generator_fingerprint, uint64_t offset, uint64_t length,
+                               const std::string &test_config, double significance_level);
+
+} // namespace rng
+
+#endif // RESULT_CACHE_HPP
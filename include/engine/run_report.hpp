@@ -0,0 +1,32 @@
+#ifndef RUN_REPORT_HPP
+#define RUN_REPORT_HPP
+
+#include "../rng.hpp"
+#include <ostream>
+#include <string>
+
+namespace rng
+{
+
+    // What a test run was asked to do, for the machine-readable report that
+    // accompanies the get_test_result() texts
+    struct RunReport
+    {
+        std::string generator_name;
+        uint64_t seed = 0;
+        uint64_t sequence_length = 0;
+        double significance_level = 0.05;
+        double wall_seconds = 0.0;
+        std::vector<const RandomnessTest *> tests; // after they have run
+        std::vector<bool> verdicts;                // what each test returned
+    };
+
+    // Writes the run as one JSON object: the parameters, the vector kernel
+    // level in use, each test's name, p-value, verdict and result text, and
+    // the totals of every instrumentation probe (an empty list when
+    // instrumentation is compiled out)
+    void write_run_report(std::ostream &out, const RunReport &report);
+
+} // namespace rng
+
+#endif // RUN_REPORT_HPP
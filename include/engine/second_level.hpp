@@ -0,0 +1,71 @@
+#ifndef SECOND_LEVEL_HPP
+#define SECOND_LEVEL_HPP
+
+#include "../rng.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace rng
+{
+
+    // How the independent replications of a second-level run are drawn
+    enum class ReplicationMode
+    {
+        DistinctSeeds, // replication r reseeds the generator with base_seed + r
+        Substreams     // replication r starts sample_size * r steps into the stream
+    };
+
+    enum class SecondLevelVerdict
+    {
+        Pass,
+        Suspicious,
+        Fail
+    };
+
+    struct SecondLevelOptions
+    {
+        size_t replications = 32;
+        size_t sample_size = 100000;
+        ReplicationMode mode = ReplicationMode::Substreams;
+        uint64_t base_seed = 1;
+        double significance_level = 0.05; // first-level level, for the failure count only
+        double suspicious_level = 0.01;   // second-level p-value below this is suspicious
+        double failure_level = 1e-4;      // and below this a failure
+        size_t num_threads = 0;
+    };
+
+    struct SecondLevelResult
+    {
+        std::string test_name;
+        std::vector<double> p_values; // one per replication, NaN if the test could not run
+        size_t first_level_failures = 0;
+        double ks_statistic = 0.0;
+        double ks_p_value = 0.0;
+        double chi_square_p_value = 0.0;
+        double combined_p_value = 0.0;
+        SecondLevelVerdict verdict = SecondLevelVerdict::Fail;
+    };
+
+    using TestSuiteFactory = std::function<std::vector<std::unique_ptr<RandomnessTest>>()>;
+
+    // Runs every test of the suite on R independent replications of the
+    // generator's output, spreading replications over threads (each with its
+    // own generator clone and test instances). The tests of a shard are
+    // built with default_thread_count() capped to their share of the thread
+    // budget, so threaded tests do not oversubscribe the machine. The R
+    // p-values of each test are then checked for uniformity with a
+    // Kolmogorov-Smirnov and a chi-square test; the smaller of the two
+    // (Bonferroni-corrected) p-values gives the verdict.
+    std::vector<SecondLevelResult> run_second_level(const RandomGenerator &prototype,
+                                                    const TestSuiteFactory &make_tests,
+                                                    const SecondLevelOptions &options);
+
+    std::string verdict_to_string(SecondLevelVerdict verdict);
+
+    // Human-readable report of a second-level run
+    std::string format_second_level(const std::vector<SecondLevelResult> &results);
+
+} // namespace rng
+
+#endif // SECOND_LEVEL_HPP
@@ -0,0 +1,58 @@
+#ifndef SEED_SWEEP_HPP
+#define SEED_SWEEP_HPP
+
+#include "../rng.hpp"
+#include "second_level.hpp"
+#include <ostream>
+#include <string>
+
+namespace rng
+{
+
+    struct SeedSweepOptions
+    {
+        uint64_t first_seed = 1;
+        uint64_t seed_count = 1000;
+        size_t sample_size = 10000;
+        double significance_level = 0.01;
+        uint64_t seeds_per_job = 64;    // seeds tested by one pool task
+        uint64_t seeds_per_range = 1000; // granularity of the failure-rate summary
+        size_t num_threads = 0;
+    };
+
+    // Failure counts of one generator over one range of seeds
+    struct SeedRangeSummary
+    {
+        std::string generator_name;
+        uint64_t first_seed = 0;
+        uint64_t seeds = 0;
+        uint64_t failed_seeds = 0;  // at least one test failed
+        uint64_t invalid_seeds = 0; // rejected by set_seed
+    };
+
+    struct SeedSweepReport
+    {
+        std::vector<SeedRangeSummary> ranges;
+        size_t tests_per_seed = 0;
+        uint64_t seeds_tested = 0;
+        double elapsed_seconds = 0.0;
+        double seeds_per_second = 0.0;
+        double numbers_per_second = 0.0;
+    };
+
+    // Tests every (generator, seed) pair of the sweep on a work-stealing pool.
+    // Each worker keeps its own generator clones, test instances and sample
+    // buffer across jobs. One CSV line per seed
+    //   generator,seed,status,failed_tests,min_p_value
+    // is written to `out` as each job completes (`out` may be null).
+    SeedSweepReport run_seed_sweep(const std::vector<const RandomGenerator *> &generators,
+                                   const TestSuiteFactory &make_tests,
+                                   const SeedSweepOptions &options,
+                                   std::ostream *out);
+
+    // Human-readable summary with the expected failure rate for comparison
+    std::string format_seed_sweep(const SeedSweepReport &report, double significance_level);
+
+} // namespace rng
+
+#endif // SEED_SWEEP_HPP
@@ -0,0 +1,82 @@
+#ifndef SEQUENTIAL_HPP
+#define SEQUENTIAL_HPP
+
+#include "../rng.hpp"
+#include <string>
+
+namespace rng
+{
+
+    // How the significance level of a test is spread over the looks
+    enum class SpendingFunction
+    {
+        // alpha * ln(1 + (e - 1) t): nearly even, so grossly bad generators
+        // are rejected at the first looks
+        Pocock,
+        // 2 - 2 Phi(z_{alpha/2} / sqrt(t)): almost nothing early, nearly the
+        // full level at the last look
+        OBrienFleming
+    };
+
+    enum class SequentialVerdict
+    {
+        Pass,
+        Fail,
+        Inconclusive // the budget ran out before the test was decided
+    };
+
+    struct SequentialOptions
+    {
+        uint64_t max_numbers = 1 << 24;    // planned length and sample budget; the last look is here
+        uint64_t first_look = 1 << 12;     // numbers seen at the first look
+        double growth = 4.0;               // each look sees this many times the numbers of the previous one
+        double significance_level = 0.01;  // per test, over all looks together
+        SpendingFunction spending = SpendingFunction::Pocock;
+        double time_budget_seconds = 0.0;  // 0: no limit
+        bool stop_at_first_failure = true; // one failed test rejects the generator
+        size_t num_threads = 0;
+    };
+
+    struct SequentialTestResult
+    {
+        std::string test_name;
+        SequentialVerdict verdict = SequentialVerdict::Inconclusive;
+        uint64_t decided_at = 0;  // numbers seen at the deciding (or last) look
+        double p_value = 0.0;     // at that look, NaN if the test could not be evaluated
+        double threshold = 0.0;   // level spent at that look
+    };
+
+    struct SequentialReport
+    {
+        std::vector<SequentialTestResult> tests;
+        SequentialVerdict verdict = SequentialVerdict::Inconclusive; // Fail if any test failed
+        uint64_t numbers_used = 0;
+        size_t looks = 0;
+        bool time_budget_exhausted = false;
+        double elapsed_seconds = 0.0;
+    };
+
+    // Level spent up to information fraction t in [0, 1]
+    double alpha_spent(SpendingFunction spending, double alpha, double t);
+
+    // Tests a generator in growing batches and stops as soon as the outcome
+    // is decided. The tests accumulate the sequence as it is generated and
+    // are evaluated at looks after first_look, first_look * growth, ...
+    // numbers, the last look being at max_numbers. At a look with
+    // information fraction t = n / max_numbers a test fails when its p-value
+    // is at most alpha_spent(t) - alpha_spent(t_previous). The increments sum
+    // to significance_level, so the chance that a good generator fails a
+    // test at some look stays within it (the Bonferroni bound; the looks are
+    // positively correlated, so the true level is lower). A test passes only
+    // at the last look. Failed tests are no longer fed. When the time budget
+    // runs out, a final look is taken at the numbers seen so far and the
+    // tests still open are inconclusive.
+    SequentialReport run_sequential(RandomGenerator &generator,
+                                    const std::vector<StreamingTest *> &tests,
+                                    const SequentialOptions &options);
+
+    std::string format_sequential(const SequentialReport &report);
+
+} // namespace rng
+
+#endif // SEQUENTIAL_HPP
@@ -0,0 +1,218 @@
+#ifndef COMBINED_HPP
+#define COMBINED_HPP
+
+#include "../rng.hpp"
+#include "../utils/bits.hpp"
+#include "mcg.hpp"
+#include "mrg.hpp"
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace rng
+{
+
+    enum class CombineRule
+    {
+        // z = (x_1 - x_2 - ... - x_N) mod m_1, output z / (m_1 + 1), with
+        // z = 0 mapped to m_1 / (m_1 + 1) (L'Ecuyer's combined MRGs)
+        ModularDifference,
+        // output frac(x_1 / m_1 + ... + x_N / m_N) (Wichmann-Hill)
+        FractionalSum
+    };
+
+    // Combines N component generators, each with a modulus() accessor.
+    // Components are held by value and called through qualified names, so
+    // none of the per-output calls goes through the vtable. Jump-ahead is
+    // forwarded to every component when all of them support it; the state is
+    // the concatenation of the component states.
+    template <CombineRule Rule, typename... Components>
+    class CombinedGenerator : public RandomGenerator
+    {
+        static_assert(sizeof...(Components) >= 2, "Combine at least two generators");
+
+    public:
+        CombinedGenerator(std::string name, Components... components)
+            : name_(std::move(name)), components_(std::move(components)...) {}
+
+        double generate() override
+        {
+            if constexpr (Rule == CombineRule::ModularDifference)
+            {
+                uint64_t z = next_difference();
+                uint64_t m = std::get<0>(components_).modulus();
+                return static_cast<double>(z == 0 ? m : z) / (static_cast<double>(m) + 1.0);
+            }
+            else
+            {
+                return next_fractional_sum();
+            }
+        }
+
+        std::vector<double> generate_sequence(size_t count) override
+        {
+            std::vector<double> sequence(count);
+            fill(sequence.data(), count);
+            return sequence;
+        }
+
+        void fill(double *out, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = CombinedGenerator::generate();
+            }
+        }
+
+        std::string get_name() const override
+        {
+            return name_;
+        }
+
+        // Expands the seed into non-zero states below each modulus
+        void set_seed(uint64_t seed) override
+        {
+            uint64_t mixer = seed;
+            for_each_component([&mixer](auto &component)
+                               {
+                std::vector<uint64_t> state = component.get_state();
+                for (auto &word : state)
+                    word = 1 + splitmix64(mixer) % (component.modulus() - 1);
+                component.set_state(state); });
+        }
+
+        uint64_t generate_raw() override
+        {
+            if constexpr (Rule == CombineRule::ModularDifference)
+                return next_difference();
+            else
+                return static_cast<uint64_t>(next_fractional_sum() * 4294967296.0);
+        }
+
+        unsigned raw_bits() const override
+        {
+            if constexpr (Rule == CombineRule::ModularDifference)
+                return floor_log2(std::get<0>(components_).modulus());
+            else
+                return 32;
+        }
+
+        std::unique_ptr<RandomGenerator> clone() const override
+        {
+            return std::make_unique<CombinedGenerator>(*this);
+        }
+
+        std::vector<uint64_t> get_state() const override
+        {
+            std::vector<uint64_t> state;
+            for_each_component([&state](const auto &component)
+                               {
+                std::vector<uint64_t> part = component.get_state();
+                state.insert(state.end(), part.begin(), part.end()); });
+            return state;
+        }
+
+        void set_state(const std::vector<uint64_t> &state) override
+        {
+            if (state.size() != get_state().size())
+            {
+                throw std::invalid_argument("State size does not match the combined components");
+            }
+            size_t offset = 0;
+            for_each_component([&state, &offset](auto &component)
+                               {
+                size_t size = component.get_state().size();
+                component.set_state(std::vector<uint64_t>(state.begin() + offset, state.begin() + offset + size));
+                offset += size; });
+        }
+
+        void jump_ahead(uint64_t steps) override
+        {
+            if (!supports_jump_ahead())
+            {
+                RandomGenerator::jump_ahead(steps);
+                return;
+            }
+            for_each_component([steps](auto &component)
+                               { component.jump_ahead(steps); });
+        }
+
+        bool supports_jump_ahead() const override
+        {
+            bool all = true;
+            for_each_component([&all](const auto &component)
+                               { all = all && component.supports_jump_ahead(); });
+            return all;
+        }
+
+        template <size_t I>
+        const auto &component() const
+        {
+            return std::get<I>(components_);
+        }
+
+    private:
+        std::string name_;
+        std::tuple<Components...> components_;
+
+        template <typename Fn>
+        void for_each_component(Fn &&fn)
+        {
+            std::apply([&fn](auto &...component)
+                       { (fn(component), ...); },
+                       components_);
+        }
+
+        template <typename Fn>
+        void for_each_component(Fn &&fn) const
+        {
+            std::apply([&fn](const auto &...component)
+                       { (fn(component), ...); },
+                       components_);
+        }
+
+        template <typename Component>
+        static uint64_t step(Component &component)
+        {
+            return component.Component::generate_raw();
+        }
+
+        uint64_t next_difference()
+        {
+            uint64_t m = std::get<0>(components_).modulus();
+            uint64_t z = step(std::get<0>(components_)) % m;
+            subtract_rest(z, m, std::make_index_sequence<sizeof...(Components) - 1>{});
+            return z;
+        }
+
+        template <size_t... I>
+        void subtract_rest(uint64_t &z, uint64_t m, std::index_sequence<I...>)
+        {
+            ((z = (z + m - step(std::get<I + 1>(components_)) % m) % m), ...);
+        }
+
+        double next_fractional_sum()
+        {
+            double sum = 0.0;
+            std::apply([&sum](auto &...component)
+                       { ((sum += static_cast<double>(step(component)) / component.modulus()), ...); },
+                       components_);
+            return sum - static_cast<double>(static_cast<uint64_t>(sum));
+        }
+    };
+
+    // L'Ecuyer's MRG32k3a: two order-3 MRGs combined by modular difference,
+    // period about 2^191. Without a seed all six state words are 12345, the
+    // reference stream; a seed goes through set_seed().
+    using MRG32k3a = CombinedGenerator<CombineRule::ModularDifference, MRG, MRG>;
+    MRG32k3a make_mrg32k3a();
+    MRG32k3a make_mrg32k3a(uint64_t seed);
+
+    // Wichmann and Hill's AS 183: three MCGs combined by fractional sum,
+    // period about 6.95e12
+    using WichmannHill = CombinedGenerator<CombineRule::FractionalSum, MCG, MCG, MCG>;
+    WichmannHill make_wichmann_hill(uint64_t seed = 12345);
+
+} // namespace rng
+
+#endif // COMBINED_HPP
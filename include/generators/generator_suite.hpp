@@ -0,0 +1,26 @@
+#ifndef GENERATOR_SUITE_HPP
+#define GENERATOR_SUITE_HPP
+
+#include "../rng.hpp"
+#include <memory>
+#include <string>
+
+namespace rng
+{
+
+    // Factory function to create all available generators with their
+    // default parameters, in menu order
+    std::vector<std::unique_ptr<RandomGenerator>> create_generator_suite();
+
+    // Short fixed key of each suite generator ("icg", "mcg", "mrg32k3a", ...),
+    // in suite order. Unlike get_name() the keys do not change, so command
+    // lines and the C interface name generators by them.
+    const std::vector<std::string> &generator_suite_keys();
+
+    // Suite generator with that key and its default parameters; throws
+    // std::invalid_argument for an unknown key
+    std::unique_ptr<RandomGenerator> create_generator(const std::string &key);
+
+} // namespace rng
+
+#endif // GENERATOR_SUITE_HPP
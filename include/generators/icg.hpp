@@ -2,6 +2,7 @@
 #define ICG_HPP
 
 #include "../rng.hpp"
+#include "../utils/modular.hpp"
 
 namespace rng
 {
@@ -13,8 +14,14 @@ namespace rng
 
         double generate() override;
         std::vector<double> generate_sequence(size_t count) override;
+        void fill(double *out, size_t count) override;
         std::string get_name() const override;
         void set_seed(uint64_t seed) override;
+        uint64_t generate_raw() override;
+        unsigned raw_bits() const override;
+        std::unique_ptr<RandomGenerator> clone() const override;
+        std::vector<uint64_t> get_state() const override;
+        void set_state(const std::vector<uint64_t> &state) override;
 
     private:
         uint64_t current_;
@@ -25,6 +32,51 @@ namespace rng
         uint64_t multiplicative_inverse(uint64_t x) const;
     };
 
+    // N independent ICG streams advanced together, outputs interleaved
+    // round-robin: output j*N + i is the j-th output of stream i, the same
+    // as an ICG(seed_i, a, b, m) would give.
+    //
+    // A lone ICG waits on a Euclid loop of data-dependent divisions per
+    // number. Here one step of all streams inverts the N states at once
+    // (Montgomery's simultaneous inversion: prefix products, a single
+    // inverse, then 3(N-1) multiplications in all), the single inverse uses
+    // the binary extended Euclidean algorithm, and products are reduced by
+    // Barrett multiplication, so no division is left on the hot path. The
+    // modulus must be odd and below 2^32 and should be prime.
+    class MultiStreamICG : public RandomGenerator
+    {
+    public:
+        MultiStreamICG(uint64_t seed = 1, size_t streams = 64, uint64_t a = 1288490188, uint64_t b = 1,
+                       uint64_t m = 2147483647);
+
+        double generate() override;
+        std::vector<double> generate_sequence(size_t count) override;
+        void fill(double *out, size_t count) override;
+        std::string get_name() const override;
+        // Stream i starts from a SplitMix64-derived value of the seed
+        void set_seed(uint64_t seed) override;
+        uint64_t generate_raw() override;
+        unsigned raw_bits() const override;
+        std::unique_ptr<RandomGenerator> clone() const override;
+        // Position in the current round followed by the N stream states
+        std::vector<uint64_t> get_state() const override;
+        void set_state(const std::vector<uint64_t> &state) override;
+
+        size_t streams() const { return states_.size(); }
+
+    private:
+        std::vector<uint64_t> states_; // latest output of each stream
+        std::vector<uint64_t> prefix_; // scratch for the prefix products
+        size_t position_;              // next stream to hand out; N when a step is due
+        const uint64_t a_;
+        const uint64_t b_;
+        const uint64_t m_;
+        BarrettReducer reducer_;
+
+        // Advances every stream by one step
+        void step();
+    };
+
 } // namespace rng
 
 #endif // ICG_HPP
\ No newline at end of file
@@ -16,8 +16,19 @@ namespace rng
 
         double generate() override;
         std::vector<double> generate_sequence(size_t count) override;
+        void fill(double *out, size_t count) override;
         std::string get_name() const override;
         void set_seed(uint64_t seed) override;
+        uint64_t generate_raw() override;
+        unsigned raw_bits() const override;
+        std::unique_ptr<RandomGenerator> clone() const override;
+        std::vector<uint64_t> get_state() const override;
+        void set_state(const std::vector<uint64_t> &state) override;
+        void jump_ahead(uint64_t steps) override;
+        bool supports_jump_ahead() const override;
+
+        uint64_t multiplier() const { return a_; }
+        uint64_t modulus() const { return m_; }
 
     private:
         uint64_t current_;
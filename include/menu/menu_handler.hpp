@@ -2,6 +2,8 @@
 #define MENU_HANDLER_HPP
 
 #include "../rng.hpp"
+#include "../engine/run_report.hpp"
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -17,19 +19,32 @@ namespace rng
     private:
         std::vector<std::unique_ptr<RandomGenerator>> generators_;
         std::vector<std::unique_ptr<RandomnessTest>> tests_;
+        std::vector<std::unique_ptr<BitStreamTest>> bit_tests_;
 
         void initialize_generators();
         void display_main_menu() const;
-        void handle_generator_selection();
+        void handle_generator_selection(RandomGenerator *generator);
         void handle_generator_parameters(RandomGenerator *generator);
         void handle_sequence_generation(RandomGenerator *generator);
-        void handle_test_selection(const std::vector<double> &numbers);
-        void display_test_results(const std::vector<double> &numbers, double significance_level);
+        void handle_test_selection(const std::vector<double> &numbers, RunReport &report,
+                                   std::chrono::steady_clock::time_point start);
+        void display_test_results(const std::vector<double> &numbers, RunReport &report,
+                                  std::chrono::steady_clock::time_point start);
+        void handle_bit_test_selection(RandomGenerator *generator, size_t sequence_length);
+        void handle_second_level(RandomGenerator *generator);
+        void handle_seed_sweep(RandomGenerator *generator);
+        void handle_period_analysis(RandomGenerator *generator);
+        void handle_checkpointed_run(RandomGenerator *generator);
+        void handle_pipelined_run(RandomGenerator *generator);
+        void handle_sequential_run(RandomGenerator *generator);
+        void handle_battery_run(RandomGenerator *generator);
+        void handle_distributed_run(RandomGenerator *generator);
 
         // Helper functions
         uint64_t get_valid_seed() const;
         size_t get_valid_sequence_length() const;
         double get_valid_significance_level() const;
+        size_t get_valid_replication_count() const;
         void clear_screen() const;
         void pause() const;
     };
@@ -8,6 +8,16 @@
 
 namespace rng {
 
+class BinaryWriter;
+class BinaryReader;
+
+// Bit stream packed least-significant bit first into 64-bit words
+struct BitSequence {
+    std::vector<uint64_t> words;
+    size_t bit_count = 0;
+    unsigned value_bits = 0; // bits contributed by each generator output
+};
+
 class RandomGenerator {
 public:
     virtual ~RandomGenerator() = default;
@@ -15,6 +25,36 @@ public:
     virtual std::vector<double> generate_sequence(size_t count) = 0;
     virtual std::string get_name() const = 0;
     virtual void set_seed(uint64_t seed) = 0;
+
+    // Writes the next `count` outputs of generate() to `out`. Generators
+    // override it with a loop the compiler can inline.
+    virtual void fill(double* out, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = generate();
+        }
+    }
+
+    // Next output as the raw integer of the recurrence, before normalization
+    virtual uint64_t generate_raw() = 0;
+    // Number of low-order bits of generate_raw() that carry usable randomness
+    virtual unsigned raw_bits() const = 0;
+
+    // Independent copy with the same parameters and current state
+    virtual std::unique_ptr<RandomGenerator> clone() const = 0;
+
+    // Complete internal state as words; set_state() accepts what get_state()
+    // returned and throws std::invalid_argument for states out of range
+    virtual std::vector<uint64_t> get_state() const = 0;
+    virtual void set_state(const std::vector<uint64_t>& state) = 0;
+
+    // Advances the state by `steps` outputs. Generators that can do this in
+    // logarithmic time override it and report so through supports_jump_ahead().
+    virtual void jump_ahead(uint64_t steps) {
+        for (uint64_t i = 0; i < steps; ++i) {
+            generate_raw();
+        }
+    }
+    virtual bool supports_jump_ahead() const { return false; }
 };
 
 class RandomnessTest {
@@ -22,7 +62,49 @@ public:
     virtual ~RandomnessTest() = default;
     virtual bool run_test(const std::vector<double>& numbers, double significance_level) = 0;
     virtual std::string get_test_name() const = 0;
+    // Name and every parameter that can change the outcome on given numbers,
+    // leaving out thread counts; keys cached results
+    virtual std::string get_config() const = 0;
+    virtual std::string get_test_result() const = 0;
+    // P-value of the last run (NaN if the test could not be run)
+    virtual double get_p_value() const = 0;
+};
+
+// Test whose statistic is accumulated chunk by chunk in constant memory.
+// States of tests that saw consecutive parts of a sequence can be merged,
+// so one pass over the data can be shared by several tests and threads.
+class StreamingTest : public RandomnessTest {
+public:
+    // Clears the accumulated state
+    virtual void reset() = 0;
+    // Feeds the next `count` numbers of the sequence
+    virtual void update(const double* numbers, size_t count) = 0;
+    // Folds in the state of a test of the same type and parameters that saw
+    // the part of the sequence immediately following this one
+    virtual void merge(const StreamingTest& other) = 0;
+    // Computes the statistic from the accumulated state; may be called repeatedly
+    virtual bool evaluate(double significance_level) = 0;
+    // Test with the same parameters and an empty state
+    virtual std::unique_ptr<StreamingTest> clone_empty() const = 0;
+    // Writes and restores the accumulated state (not the last verdict) so a
+    // run can be checkpointed; load_state() expects the same parameters
+    virtual void save_state(BinaryWriter& out) const = 0;
+    virtual void load_state(BinaryReader& in) = 0;
+
+    bool run_test(const std::vector<double>& numbers, double significance_level) override {
+        reset();
+        update(numbers.data(), numbers.size());
+        return evaluate(significance_level);
+    }
+};
+
+class BitStreamTest {
+public:
+    virtual ~BitStreamTest() = default;
+    virtual bool run_test(const BitSequence& bits, double significance_level) = 0;
+    virtual std::string get_test_name() const = 0;
     virtual std::string get_test_result() const = 0;
+    virtual double get_p_value() const = 0;
 };
 
 // Significance levels
@@ -0,0 +1,38 @@
+#ifndef BINARY_MATRIX_RANK_TEST_HPP
+#define BINARY_MATRIX_RANK_TEST_HPP
+
+#include "../rng.hpp"
+#include <string>
+
+namespace rng
+{
+
+    // Binary matrix rank test (NIST SP 800-22 section 2.5) on raw generator bits.
+    //
+    // Consecutive L*L bits of the stream fill an L x L matrix over GF(2) whose
+    // rank is found by Gaussian elimination on rows packed into 64-bit words.
+    // The ranks L, L-1, L-2 and below are compared with their exact
+    // probabilities by a chi-square test with 3 degrees of freedom.
+    class BinaryMatrixRankTest : public BitStreamTest
+    {
+    public:
+        static constexpr size_t MIN_SIZE = 32;
+        static constexpr size_t MAX_SIZE = 1024;
+
+        BinaryMatrixRankTest(size_t size = 32, size_t num_threads = 0);
+        bool run_test(const BitSequence &bits, double significance_level) override;
+        std::string get_test_name() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const size_t size_;
+        const size_t num_threads_;
+        double chi_square_value_;
+        double p_value_;
+        std::string result_message_;
+    };
+
+} // namespace rng
+
+#endif // BINARY_MATRIX_RANK_TEST_HPP
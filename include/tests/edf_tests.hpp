@@ -0,0 +1,93 @@
+#ifndef EDF_TESTS_HPP
+#define EDF_TESTS_HPP
+
+#include "../rng.hpp"
+#include "../utils/data_source.hpp"
+#include <string>
+
+namespace rng
+{
+
+    enum class EdfMode
+    {
+        Exact,   // sort the whole sample (in parallel)
+        Bucketed // one streaming pass into a fine histogram, bounded error
+    };
+
+    // Common driver for tests on the empirical distribution function against
+    // the uniform distribution. Both modes read through a DataSource, so
+    // in-memory, generated, memory-mapped and streamed sequences all work.
+    class EmpiricalDistributionTest : public RandomnessTest
+    {
+    public:
+        EmpiricalDistributionTest(EdfMode mode, size_t bucket_count, size_t num_threads);
+
+        bool run_test(const std::vector<double> &numbers, double significance_level) override;
+        bool run_test(DataSource &source, double significance_level);
+        // Largest distance of the reported statistic from the one exact mode
+        // would give on the same data; 0 in exact mode
+        double get_error_bound() const;
+        std::string get_config() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    protected:
+        // Statistic and p-value from the sorted sample
+        virtual void evaluate_sorted(const std::vector<double> &sorted) = 0;
+        // Statistic and p-value from bucket counts over [0, 1) holding n values
+        virtual void evaluate_buckets(const std::vector<uint64_t> &counts, size_t n) = 0;
+        // Statistic-specific lines of the result message
+        virtual std::string describe() const = 0;
+
+        const EdfMode mode_;
+        const size_t bucket_count_;
+        const size_t num_threads_;
+        double statistic_;
+        double error_bound_;
+        double p_value_;
+
+    private:
+        std::string result_message_;
+    };
+
+    // Kolmogorov-Smirnov test: D = sup |F_n(x) - x|. In bucketed mode D is
+    // bracketed between its values at the bucket edges and the worst case
+    // inside a bucket; the midpoint is used and half the bracket reported.
+    class KolmogorovSmirnovTest : public EmpiricalDistributionTest
+    {
+    public:
+        KolmogorovSmirnovTest(EdfMode mode = EdfMode::Exact, size_t bucket_count = 1 << 20, size_t num_threads = 0);
+        using EmpiricalDistributionTest::run_test;
+        std::string get_test_name() const override;
+
+    protected:
+        void evaluate_sorted(const std::vector<double> &sorted) override;
+        void evaluate_buckets(const std::vector<uint64_t> &counts, size_t n) override;
+        std::string describe() const override;
+
+    private:
+        void compute_p_value(size_t n);
+    };
+
+    // Anderson-Darling test. In bucketed mode every value is placed at the
+    // centre of its bucket and the rank sums are evaluated per bucket. The
+    // reported error bound brackets each value's term between the bucket
+    // edges, using the concavity of a ln u + b ln(1 - u), and is computed
+    // from the counts. For n near-uniform values in m buckets it grows like
+    // sqrt(n) / m + n ln(m) / m^2, so m should grow faster than sqrt(n).
+    class AndersonDarlingTest : public EmpiricalDistributionTest
+    {
+    public:
+        AndersonDarlingTest(EdfMode mode = EdfMode::Exact, size_t bucket_count = 1 << 20, size_t num_threads = 0);
+        using EmpiricalDistributionTest::run_test;
+        std::string get_test_name() const override;
+
+    protected:
+        void evaluate_sorted(const std::vector<double> &sorted) override;
+        void evaluate_buckets(const std::vector<uint64_t> &counts, size_t n) override;
+        std::string describe() const override;
+    };
+
+} // namespace rng
+
+#endif // EDF_TESTS_HPP
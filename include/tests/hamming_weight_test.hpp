@@ -0,0 +1,80 @@
+#ifndef HAMMING_WEIGHT_TEST_HPP
+#define HAMMING_WEIGHT_TEST_HPP
+
+#include "../rng.hpp"
+#include <string>
+
+namespace rng
+{
+
+    // Counts of overlapping k-tuples of Hamming-weight classes of raw
+    // outputs. Each output of `value_bits` bits falls in one of three classes
+    // by its popcount (below, around or above w/2) and the classes of k
+    // consecutive outputs index a counter, two bits per class. Parts of a
+    // stream counted separately merge into the counts of the whole stream.
+    class HammingWeightCounts
+    {
+    public:
+        HammingWeightCounts(unsigned value_bits, size_t tuple_length);
+
+        void update(const uint64_t *outputs, size_t count);
+        // Folds in the counts of the part of the stream right after this one
+        void merge(const HammingWeightCounts &other);
+
+        uint64_t outputs() const { return count_; }
+        uint64_t tuples() const { return count_ < tuple_length_ ? 0 : count_ - tuple_length_ + 1; }
+
+        // Largest |z| over the 2 * 3^(k-1) tuple statistics, each
+        // standardized to N(0, 1) under independence
+        double max_z() const;
+        size_t statistics() const;
+
+    private:
+        unsigned value_bits_;
+        size_t tuple_length_;
+        std::vector<uint8_t> class_of_weight_;
+        double class_probability_[3];
+        std::vector<uint64_t> counts_; // indexed by the last k classes
+        uint64_t code_;                // classes of the last k outputs
+        uint64_t head_;                // classes of the first k - 1 outputs
+        uint64_t count_;
+
+        void push(unsigned weight_class);
+    };
+
+    // Hamming-weight dependency test on raw generator outputs, in the style
+    // of Blackman and Vigna. Linear generators leak structure through the
+    // popcounts of consecutive outputs that tests on their values miss.
+    //
+    // The counts of weight-class tuples go through a tensor transform with
+    // orthonormal functions of one class, giving one sum per product of
+    // functions whose oldest factor is non-constant. Under independence each
+    // sum over N overlapping tuples has mean 0 and variance N exactly, and
+    // the largest |z| gives the p-value after a Sidak correction.
+    //
+    // The stream is examined at sizes doubling from first_size outputs, each
+    // step counting only the new outputs, split over threads and merged. The
+    // test stops at the first size whose Bonferroni-corrected p-value fails.
+    class HammingWeightDependencyTest : public BitStreamTest
+    {
+    public:
+        static constexpr size_t MAX_TUPLE_LENGTH = 8;
+        static constexpr unsigned MIN_VALUE_BITS = 4;
+
+        HammingWeightDependencyTest(size_t tuple_length = 4, size_t first_size = 1 << 16, size_t num_threads = 0);
+        bool run_test(const BitSequence &bits, double significance_level) override;
+        std::string get_test_name() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const size_t tuple_length_;
+        const size_t first_size_;
+        const size_t num_threads_;
+        double p_value_;
+        std::string result_message_;
+    };
+
+} // namespace rng
+
+#endif // HAMMING_WEIGHT_TEST_HPP
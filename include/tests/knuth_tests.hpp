@@ -0,0 +1,236 @@
+#ifndef KNUTH_TESTS_HPP
+#define KNUTH_TESTS_HPP
+
+#include "../rng.hpp"
+#include <string>
+
+namespace rng
+{
+
+    // Classic empirical tests from Knuth, TAOCP Vol. 2, section 3.3.2, written
+    // as constant-memory streaming kernels.
+    //
+    // Every test merges exactly: the outcome does not depend on how the
+    // sequence was cut into parts. The gap and run-length tests keep the gap
+    // or run open at either end of a part. A part of the poker or maximum-of-t
+    // test does not know where the hands fall in it, so it counts the groups
+    // starting at every offset and keeps its first and last t - 1 numbers;
+    // merge() counts the groups across the seam and lines the offsets up. A
+    // coupon-collector part keeps, for every digit, the segments it would see
+    // if the segment open before it ended at that digit's first occurrence.
+
+    // Gap test: lengths of the gaps between numbers falling in [alpha, beta)
+    class GapTest : public StreamingTest
+    {
+    public:
+        GapTest(double alpha = 0.0, double beta = 0.5, size_t max_gap = 10);
+        void reset() override;
+        void update(const double *numbers, size_t count) override;
+        void merge(const StreamingTest &other) override;
+        bool evaluate(double significance_level) override;
+        std::unique_ptr<StreamingTest> clone_empty() const override;
+        void save_state(BinaryWriter &out) const override;
+        void load_state(BinaryReader &in) override;
+        std::string get_test_name() const override;
+        std::string get_config() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const double alpha_;
+        const double beta_;
+        const size_t max_gap_;
+        std::vector<uint64_t> gap_counts_; // gaps of length 0..max_gap-1 and >= max_gap
+        bool hit_seen_;
+        uint64_t leading_;  // numbers before the first hit
+        uint64_t trailing_; // numbers since the last hit
+        uint64_t count_;
+        double chi_square_value_;
+        double p_value_;
+        std::string result_message_;
+
+        void record_gap(uint64_t length);
+    };
+
+    // Poker test: number of distinct digits in non-overlapping hands of k digits
+    class PokerTest : public StreamingTest
+    {
+    public:
+        PokerTest(size_t digits = 10, size_t hand_size = 5);
+        void reset() override;
+        void update(const double *numbers, size_t count) override;
+        void merge(const StreamingTest &other) override;
+        bool evaluate(double significance_level) override;
+        std::unique_ptr<StreamingTest> clone_empty() const override;
+        void save_state(BinaryWriter &out) const override;
+        void load_state(BinaryReader &in) override;
+        std::string get_test_name() const override;
+        std::string get_config() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const size_t digits_;
+        const size_t hand_size_;
+        std::vector<double> probabilities_; // P(r distinct), r = 1..hand_size
+        std::vector<uint8_t> distinct_table_; // popcount of each hand mask, for few digits
+        std::vector<uint64_t> counts_;        // row i: hands starting at offsets = i mod hand_size
+        std::vector<uint8_t> head_;           // first hand_size - 1 digits of the part
+        // The part is cut into blocks of hand_size digits, so a hand ending in
+        // the current block is a suffix of the previous block and a prefix of this one
+        std::vector<uint8_t> block_;
+        std::vector<uint8_t> previous_;
+        std::vector<uint64_t> suffix_masks_; // digits in previous_[i..]
+        uint64_t prefix_mask_;               // digits in the current block so far
+        uint64_t count_;
+        double chi_square_value_;
+        double p_value_;
+        std::string result_message_;
+
+        std::vector<uint8_t> last_digits() const;
+        void restore_blocks(const std::vector<uint8_t> &last);
+    };
+
+    // Coupon-collector test: lengths of segments needed to see all d digits
+    class CouponCollectorTest : public StreamingTest
+    {
+    public:
+        CouponCollectorTest(size_t digits = 5, size_t max_length = 30);
+        void reset() override;
+        void update(const double *numbers, size_t count) override;
+        void merge(const StreamingTest &other) override;
+        bool evaluate(double significance_level) override;
+        std::unique_ptr<StreamingTest> clone_empty() const override;
+        void save_state(BinaryWriter &out) const override;
+        void load_state(BinaryReader &in) override;
+        std::string get_test_name() const override;
+        std::string get_config() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        // Segments of a part entered right after some digit's first occurrence
+        struct Restart
+        {
+            std::vector<int64_t> diff; // counts minus those of the main segmentation
+            uint64_t mask;             // open segment
+            uint64_t length;
+            bool live; // not yet merged into the main segmentation
+        };
+
+        const size_t digits_;
+        const size_t max_length_;
+        std::vector<double> probabilities_; // lengths digits..max_length-1 and >= max_length
+        // Main segmentation: entered after the last first occurrence, when
+        // the part has seen every digit; the segment before is not counted
+        std::vector<uint64_t> counts_;
+        uint64_t seen_mask_;
+        uint64_t length_;
+        uint64_t count_;
+        uint64_t part_mask_; // digits seen anywhere in the part
+        std::vector<uint64_t> first_seen_;
+        std::vector<Restart> restarts_; // by digit
+        size_t live_restarts_;
+        double chi_square_value_;
+        double p_value_;
+        std::string result_message_;
+
+        uint64_t all_digits() const;
+        size_t length_class(uint64_t length) const;
+        void step(size_t digit);
+        void carry(uint64_t &mask, uint64_t &length, std::vector<int64_t> &counts) const;
+    };
+
+    // Maximum-of-t test: max(U_1..U_t)^t of non-overlapping groups is uniform
+    class MaximumOfTTest : public StreamingTest
+    {
+    public:
+        MaximumOfTTest(size_t group_size = 5, size_t num_bins = 10);
+        void reset() override;
+        void update(const double *numbers, size_t count) override;
+        void merge(const StreamingTest &other) override;
+        bool evaluate(double significance_level) override;
+        std::unique_ptr<StreamingTest> clone_empty() const override;
+        void save_state(BinaryWriter &out) const override;
+        void load_state(BinaryReader &in) override;
+        std::string get_test_name() const override;
+        std::string get_config() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const size_t group_size_;
+        const size_t num_bins_;
+        std::vector<double> thresholds_;  // max^t is in bin b when max >= thresholds_[b - 1]; ends with +inf
+        std::vector<uint32_t> bin_table_; // lowest bin of the maxima in each equal slot of [0, 1)
+        std::vector<uint64_t> counts_;    // row i: groups starting at offsets = i mod group_size
+        std::vector<double> head_;        // first group_size - 1 numbers of the part
+        // Blocks of group_size numbers, as in the poker test
+        std::vector<double> block_;
+        std::vector<double> previous_;
+        std::vector<double> suffix_max_; // maximum of previous_[i..]
+        double prefix_max_;              // maximum of the current block so far
+        uint64_t count_;
+        double chi_square_value_;
+        double p_value_;
+        std::string result_message_;
+
+        size_t bin(double maximum) const;
+        std::vector<double> last_values() const;
+        void restore_blocks(const std::vector<double> &last);
+    };
+
+    enum class RunDirection
+    {
+        Up,  // runs of increasing numbers
+        Down // runs of decreasing numbers
+    };
+
+    // Runs-up or runs-down test on the distribution of run lengths (Knuth,
+    // algorithm 3.3.2 G). Counts of runs of length 1..5 and 6 or more are
+    // combined through Knuth's inverse covariance matrix into a statistic
+    // that is chi-square with 6 degrees of freedom for large n; adjacent run
+    // lengths are dependent, so a plain Pearson statistic would not do.
+    //
+    // update() compares 64 neighbouring pairs at a time into a bit mask (four
+    // per AVX2 comparison where available) and walks the run boundaries, the
+    // clear bits, with count-trailing-zeros instead of a branch per number.
+    // The runs open at either end of a part are kept aside so parts merge
+    // exactly, and run_test() splits the sequence over threads that way.
+    class RunsUpDownTest : public StreamingTest
+    {
+    public:
+        RunsUpDownTest(RunDirection direction = RunDirection::Up, size_t num_threads = 0);
+        bool run_test(const std::vector<double> &numbers, double significance_level) override;
+        void reset() override;
+        void update(const double *numbers, size_t count) override;
+        void merge(const StreamingTest &other) override;
+        bool evaluate(double significance_level) override;
+        std::unique_ptr<StreamingTest> clone_empty() const override;
+        void save_state(BinaryWriter &out) const override;
+        void load_state(BinaryReader &in) override;
+        std::string get_test_name() const override;
+        std::string get_config() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const RunDirection direction_;
+        const size_t num_threads_;
+        std::vector<uint64_t> run_counts_; // lengths 1..5 and >= 6, leaving out the first and last run
+        bool first_closed_;                // whether the first run has ended
+        uint64_t first_run_;               // its length once it has
+        uint64_t open_run_;                // length of the run still open at the end
+        double first_;
+        double last_;
+        uint64_t count_;
+        double statistic_;
+        double p_value_;
+        std::string result_message_;
+
+        void close_run(uint64_t length);
+    };
+
+} // namespace rng
+
+#endif // KNUTH_TESTS_HPP
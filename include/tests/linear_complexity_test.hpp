@@ -0,0 +1,40 @@
+#ifndef LINEAR_COMPLEXITY_TEST_HPP
+#define LINEAR_COMPLEXITY_TEST_HPP
+
+#include "../rng.hpp"
+#include <string>
+
+namespace rng
+{
+
+    // Linear complexity test (NIST SP 800-22 section 2.10) on raw generator bits.
+    //
+    // The stream is cut into blocks of M bits and the length of the shortest
+    // LFSR producing each block is found with Berlekamp-Massey working on
+    // 64-bit words: discrepancies are the parity of popcount(C & window) and
+    // connection polynomial updates are shifted word XORs. The distribution of
+    // the normalized complexities is compared with the reference
+    // probabilities by a chi-square test with 6 degrees of freedom.
+    class LinearComplexityTest : public BitStreamTest
+    {
+    public:
+        static constexpr size_t MIN_BLOCK_SIZE = 500;
+        static constexpr size_t MAX_BLOCK_SIZE = 1 << 16;
+
+        LinearComplexityTest(size_t block_size = 500, size_t num_threads = 0);
+        bool run_test(const BitSequence &bits, double significance_level) override;
+        std::string get_test_name() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const size_t block_size_;
+        const size_t num_threads_;
+        double chi_square_value_;
+        double p_value_;
+        std::string result_message_;
+    };
+
+} // namespace rng
+
+#endif // LINEAR_COMPLEXITY_TEST_HPP
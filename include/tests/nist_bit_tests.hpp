@@ -0,0 +1,96 @@
+#ifndef NIST_BIT_TESTS_HPP
+#define NIST_BIT_TESTS_HPP
+
+#include "../rng.hpp"
+#include <string>
+
+namespace rng
+{
+
+    // Frequency (monobit) test (NIST SP 800-22 section 2.1) on raw generator
+    // bits: the excess of ones over zeros, S_n / sqrt(n), is compared with a
+    // standard normal. Ones are counted a word at a time with popcount.
+    class MonobitTest : public BitStreamTest
+    {
+    public:
+        static constexpr size_t MIN_BITS = 100;
+
+        bool run_test(const BitSequence &bits, double significance_level) override;
+        std::string get_test_name() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        double p_value_ = 0.0;
+        std::string result_message_;
+    };
+
+    // Frequency test within a block (NIST SP 800-22 section 2.2): the
+    // proportion of ones in each block of M bits, popcounted 64 bits at a
+    // time, is checked against 1/2 by a chi-square test with one degree of
+    // freedom per block.
+    class BlockFrequencyTest : public BitStreamTest
+    {
+    public:
+        static constexpr size_t MIN_BLOCK_SIZE = 20;
+
+        BlockFrequencyTest(size_t block_size = 128);
+        bool run_test(const BitSequence &bits, double significance_level) override;
+        std::string get_test_name() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const size_t block_size_;
+        double chi_square_value_;
+        double p_value_;
+        std::string result_message_;
+    };
+
+    // Runs test (NIST SP 800-22 section 2.3) on bits rather than on the
+    // ordering of numbers: the number of uninterrupted runs of equal bits is
+    // one plus the number of positions where a bit differs from the next,
+    // counted as popcount(w XOR (w >> 1)) with the neighbouring word shifted
+    // in. A sequence failing the frequency prerequisite gets p = 0.
+    class BitRunsTest : public BitStreamTest
+    {
+    public:
+        static constexpr size_t MIN_BITS = 100;
+
+        bool run_test(const BitSequence &bits, double significance_level) override;
+        std::string get_test_name() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        double p_value_ = 0.0;
+        std::string result_message_;
+    };
+
+    // Longest run of ones in a block (NIST SP 800-22 section 2.4). The block
+    // size follows the stream length as in the standard (8, 128 or 10^4
+    // bits). Each block is scanned 64 bits at a time: runs crossing word
+    // edges are joined with bit scans for the ones at either end, and the
+    // longest run inside a word is the number of x &= x >> 1 steps until
+    // x is zero. The counts of longest runs in the standard's classes are
+    // compared with their probabilities by a chi-square test.
+    class LongestRunTest : public BitStreamTest
+    {
+    public:
+        static constexpr size_t MIN_BITS = 128;
+
+        bool run_test(const BitSequence &bits, double significance_level) override;
+        std::string get_test_name() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        size_t block_size_ = 0; // of the last run
+        double chi_square_value_ = 0.0;
+        double p_value_ = 0.0;
+        std::string result_message_;
+    };
+
+} // namespace rng
+
+#endif // NIST_BIT_TESTS_HPP
@@ -0,0 +1,45 @@
+#ifndef OVERLAPPING_SERIAL_TEST_HPP
+#define OVERLAPPING_SERIAL_TEST_HPP
+
+#include "../rng.hpp"
+#include <string>
+
+namespace rng
+{
+
+    // Serial test on overlapping d-tuples over t^d cells.
+    //
+    // Each number is mapped to a digit in [0, t) and every (circular) window of
+    // d consecutive digits selects a cell. Cell counts are kept in a dense
+    // array when t^d is small enough and in an open-addressing hash table
+    // otherwise. The test reports Good's overlapping statistic
+    // psi^2_d - psi^2_(d-1) (chi-square with t^d - t^(d-1) degrees of freedom)
+    // and the number of cell collisions, and uses the collision count for the
+    // verdict when there is less than one expected entry per cell.
+    class OverlappingSerialTest : public RandomnessTest
+    {
+    public:
+        static constexpr size_t MAX_DIMENSION = 8;
+
+        OverlappingSerialTest(size_t dimension = 3, size_t divisions = 16, size_t num_threads = 0);
+        bool run_test(const std::vector<double> &numbers, double significance_level) override;
+        std::string get_test_name() const override;
+        std::string get_config() const override;
+        std::string get_test_result() const override;
+        double get_p_value() const override;
+
+    private:
+        const size_t dimension_;
+        const size_t divisions_;
+        const size_t num_threads_;
+        uint64_t cells_;
+        double psi_square_;
+        uint64_t collisions_;
+        double expected_collisions_;
+        double p_value_;
+        std::string result_message_;
+    };
+
+} // namespace rng
+
+#endif // OVERLAPPING_SERIAL_TEST_HPP
@@ -8,42 +8,87 @@
 namespace rng
 {
 
-    class ChiSquareTest : public RandomnessTest
+    class ChiSquareTest : public StreamingTest
     {
     public:
         ChiSquareTest(size_t num_bins = 10);
-        bool run_test(const std::vector<double> &numbers, double significance_level) override;
+        void reset() override;
+        void update(const double *numbers, size_t count) override;
+        void merge(const StreamingTest &other) override;
+        bool evaluate(double significance_level) override;
+        std::unique_ptr<StreamingTest> clone_empty() const override;
+        void save_state(BinaryWriter &out) const override;
+        void load_state(BinaryReader &in) override;
         std::string get_test_name() const override;
+        std::string get_config() const override;
         std::string get_test_result() const override;
+        double get_p_value() const override;
 
     private:
         const size_t num_bins_;
+        std::vector<uint64_t> observed_;
+        size_t count_;
         double chi_square_value_;
         double p_value_;
         std::string result_message_;
     };
 
-    class RunsTest : public RandomnessTest
+    class RunsTest : public StreamingTest
     {
     public:
-        bool run_test(const std::vector<double> &numbers, double significance_level) override;
+        RunsTest();
+        void reset() override;
+        void update(const double *numbers, size_t count) override;
+        void merge(const StreamingTest &other) override;
+        bool evaluate(double significance_level) override;
+        std::unique_ptr<StreamingTest> clone_empty() const override;
+        void save_state(BinaryWriter &out) const override;
+        void load_state(BinaryReader &in) override;
         std::string get_test_name() const override;
+        std::string get_config() const override;
         std::string get_test_result() const override;
+        double get_p_value() const override;
 
     private:
+        // Direction changes between consecutive pairs, plus the edges needed
+        // to join this part of the sequence with its neighbours
+        size_t count_;
+        size_t changes_;
+        double first_;
+        double last_;
+        bool first_increasing_;
+        bool last_increasing_;
         double z_statistic_;
         double p_value_;
         std::string result_message_;
     };
 
-    class SerialCorrelationTest : public RandomnessTest
+    class SerialCorrelationTest : public StreamingTest
     {
     public:
-        bool run_test(const std::vector<double> &numbers, double significance_level) override;
+        SerialCorrelationTest();
+        void reset() override;
+        void update(const double *numbers, size_t count) override;
+        void merge(const StreamingTest &other) override;
+        bool evaluate(double significance_level) override;
+        std::unique_ptr<StreamingTest> clone_empty() const override;
+        void save_state(BinaryWriter &out) const override;
+        void load_state(BinaryReader &in) override;
         std::string get_test_name() const override;
+        std::string get_config() const override;
         std::string get_test_result() const override;
+        double get_p_value() const override;
 
     private:
+        // Sums over pairs (x_i, x_(i+1)), centred on 0.5 to limit cancellation
+        size_t count_;
+        double first_;
+        double last_;
+        double sum_x_;
+        double sum_y_;
+        double sum_xx_;
+        double sum_yy_;
+        double sum_xy_;
         double correlation_coefficient_;
         double z_statistic_;
         double p_value_;
@@ -53,6 +98,9 @@ namespace rng
     // Factory function to create all available tests
     std::vector<std::unique_ptr<RandomnessTest>> create_test_suite();
 
+    // Factory function to create all tests that work on raw generator bits
+    std::vector<std::unique_ptr<BitStreamTest>> create_bit_test_suite();
+
 } // namespace rng
 
 #endif // RANDOMNESS_TESTS_HPP
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+#include <cstdint>
+
+namespace rng
+{
+
+    // Standard normal cumulative distribution function
+    double normal_cdf(double z);
+
+    // Its inverse for p in (0, 1); throws std::invalid_argument otherwise
+    double normal_quantile(double p);
+
+    // Regularized incomplete gamma functions P(a, x) and Q(a, x) = 1 - P(a, x)
+    double regularized_gamma_p(double a, double x);
+    double regularized_gamma_q(double a, double x);
+
+    // Upper-tail probability of a chi-square statistic with df degrees of freedom
+    double chi_square_p_value(double statistic, double df);
+
+    // Two-sided p-value of an observed count under a Poisson(mean) distribution
+    double poisson_p_value(uint64_t observed, double mean);
+
+} // namespace rng
+
+#endif // STATISTICS_HPP
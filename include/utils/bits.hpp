@@ -0,0 +1,49 @@
+#ifndef BITS_HPP
+#define BITS_HPP
+
+#include "../rng.hpp"
+
+namespace rng
+{
+
+    // Index of the highest set bit (floor(log2(x))), x must be non-zero
+    inline unsigned floor_log2(uint64_t x)
+    {
+        return 63u - static_cast<unsigned>(__builtin_clzll(x));
+    }
+
+    // Reads `count` (<= 64) bits starting at bit `offset` of a packed stream
+    inline uint64_t read_bits(const uint64_t *words, size_t offset, unsigned count)
+    {
+        size_t index = offset >> 6;
+        unsigned shift = static_cast<unsigned>(offset & 63);
+        uint64_t value = words[index] >> shift;
+        if (shift != 0 && shift + count > 64)
+            value |= words[index + 1] << (64 - shift);
+        return count == 64 ? value : value & ((1ULL << count) - 1);
+    }
+
+    // Set bits in words[0..count)
+    uint64_t popcount_words(const uint64_t *words, size_t count);
+
+    // Positions k < bit_count - 1 of a packed stream where bit k differs from
+    // bit k + 1; bits at or past bit_count are ignored
+    uint64_t count_bit_transitions(const uint64_t *words, size_t bit_count);
+
+    // SplitMix64 step: advances `state` and returns a well-mixed word, used
+    // to expand one seed into several independent-looking values
+    inline uint64_t splitmix64(uint64_t &state)
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Packs the low raw_bits() bits of consecutive generate_raw() outputs
+    // into a stream of at least `bit_count` bits
+    BitSequence generate_bit_sequence(RandomGenerator &generator, size_t bit_count);
+
+} // namespace rng
+
+#endif // BITS_HPP
@@ -0,0 +1,76 @@
+#ifndef CPU_DISPATCH_HPP
+#define CPU_DISPATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Runtime selection of the vectorized kernels. The library is built for the
+// generic baseline of the target; each kernel below is compiled a second time
+// for every wider instruction set and the widest one the CPU and operating
+// system support is picked on first use:
+//
+//     kernels().popcount_words(words, count);
+//
+// Every variant of a kernel returns bit-for-bit the same result, including
+// the floating-point sums, so a verdict never depends on the host it ran on.
+
+namespace rng
+{
+
+    enum class CpuLevel
+    {
+        Baseline, // the build target only (SSE2 on x86-64)
+        Sse42,    // SSE4.2 with the POPCNT instruction
+        Avx2,
+        Avx512    // AVX-512 F, BW and VL
+    };
+
+    struct KernelTable
+    {
+        CpuLevel level;
+
+        // Set bits in words[0..count)
+        uint64_t (*popcount_words)(const uint64_t *words, size_t count);
+        // out[i] = popcount(values[i] & mask)
+        void (*popcounts)(const uint64_t *values, size_t count, uint64_t mask, uint8_t *out);
+        // Sum over i < count of popcount(w[i] ^ (bits of w shifted down by one)),
+        // reading words[0..count]
+        uint64_t (*transition_words)(const uint64_t *words, size_t count);
+        // dst[i] ^= src[i]
+        void (*xor_words)(uint64_t *dst, const uint64_t *src, size_t count);
+        // Bit i set when x[i + 1] > x[i] (up) or x[i + 1] < x[i] (down); length <= 64
+        uint64_t (*continuation_mask)(const double *x, size_t length, bool up);
+        // out[i] = min(floor(numbers[i] * bins), bins - 1) for numbers in [0, 1],
+        // 0 < bins < 2^31
+        void (*bin_numbers)(const double *numbers, size_t count, uint32_t bins, uint32_t *out);
+        // Adds sx, sy, sxx, syy and sxy over the pairs (x, y) = (numbers[i] - 0.5,
+        // numbers[i + 1] - 0.5), i < count - 1, to sums[0..5), summed in four
+        // interleaved lanes
+        void (*pair_sums)(const double *numbers, size_t count, double *sums);
+    };
+
+    // Kernels of the selected level. The first call picks the detected level,
+    // lowered to the one named by the RNG_CPU_LEVEL environment variable if it
+    // is set to a valid, lower level.
+    const KernelTable &kernels();
+
+    // Widest level this CPU and operating system can run
+    CpuLevel detected_cpu_level();
+
+    CpuLevel selected_cpu_level();
+
+    // Switches every later kernels() call to `level`. Throws
+    // std::invalid_argument if the CPU cannot run it. Call it at startup,
+    // before other threads use the kernels.
+    void select_cpu_level(CpuLevel level);
+
+    // "baseline", "sse4.2", "avx2" or "avx512"
+    std::string cpu_level_name(CpuLevel level);
+
+    // Inverse of cpu_level_name(); throws std::invalid_argument for other names
+    CpuLevel parse_cpu_level(const std::string &name);
+
+} // namespace rng
+
+#endif // CPU_DISPATCH_HPP
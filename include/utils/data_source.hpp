@@ -0,0 +1,85 @@
+#ifndef DATA_SOURCE_HPP
+#define DATA_SOURCE_HPP
+
+#include "../rng.hpp"
+#include <istream>
+#include <string>
+
+namespace rng
+{
+
+    // Sequential reader of numbers in [0, 1) that lets tests consume a
+    // sequence in chunks without holding all of it in memory
+    class DataSource
+    {
+    public:
+        virtual ~DataSource() = default;
+
+        // Copies up to `capacity` numbers into `buffer`; returns 0 once exhausted
+        virtual size_t read(double *buffer, size_t capacity) = 0;
+
+        // Total number of values if known in advance, 0 otherwise
+        virtual size_t size_hint() const { return 0; }
+    };
+
+    // Reads from an in-memory sequence owned by the caller
+    class VectorSource : public DataSource
+    {
+    public:
+        explicit VectorSource(const std::vector<double> &numbers);
+        size_t read(double *buffer, size_t capacity) override;
+        size_t size_hint() const override;
+
+    private:
+        const std::vector<double> &numbers_;
+        size_t position_;
+    };
+
+    // Draws `count` numbers from a generator on demand
+    class GeneratorSource : public DataSource
+    {
+    public:
+        GeneratorSource(RandomGenerator &generator, size_t count);
+        size_t read(double *buffer, size_t capacity) override;
+        size_t size_hint() const override;
+
+    private:
+        RandomGenerator &generator_;
+        size_t remaining_;
+        const size_t count_;
+    };
+
+    // Reads native-endian binary doubles from a memory-mapped file
+    class MappedFileSource : public DataSource
+    {
+    public:
+        explicit MappedFileSource(const std::string &path);
+        ~MappedFileSource() override;
+        MappedFileSource(const MappedFileSource &) = delete;
+        MappedFileSource &operator=(const MappedFileSource &) = delete;
+
+        size_t read(double *buffer, size_t capacity) override;
+        size_t size_hint() const override;
+
+    private:
+        const double *data_;
+        size_t count_;
+        size_t position_;
+        size_t mapped_bytes_;
+    };
+
+    // Reads whitespace-separated text or native binary doubles from a stream
+    class StreamSource : public DataSource
+    {
+    public:
+        StreamSource(std::istream &input, bool binary = false);
+        size_t read(double *buffer, size_t capacity) override;
+
+    private:
+        std::istream &input_;
+        const bool binary_;
+    };
+
+} // namespace rng
+
+#endif // DATA_SOURCE_HPP
@@ -0,0 +1,116 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scoped timers and counters for the hot paths. They are compiled in only
+// when RNG_INSTRUMENTATION is defined (CMake option RNG_ENABLE_INSTRUMENTATION);
+// otherwise the macros below expand to nothing that is evaluated.
+//
+//     static const ProbeId probe = RNG_PROBE("generator.fill");
+//     RNG_TIMED_SCOPE(probe, count);
+//
+// Each thread records into its own block of counters, which only that thread
+// writes, so recording takes no lock and shares no cache line. Blocks are
+// summed when a snapshot is taken and folded into a global total when their
+// thread exits.
+
+namespace rng
+{
+
+    // Index of a named probe; a name maps to the same index in every thread
+    using ProbeId = uint32_t;
+
+    // Probes that can be registered in one process
+    constexpr size_t MAX_PROBES = 256;
+
+    struct ProbeTotals
+    {
+        std::string name;
+        uint64_t calls = 0;
+        uint64_t nanoseconds = 0; // 0 for pure counters
+        uint64_t items = 0;       // numbers or bytes handled
+        uint64_t threads = 0;     // threads that recorded at least one call
+    };
+
+    constexpr bool instrumentation_enabled()
+    {
+#ifdef RNG_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Returns the probe of that name, registering it on first use; throws
+    // std::runtime_error once MAX_PROBES names are taken
+    ProbeId register_probe(const std::string &name);
+
+    // Adds one call to the calling thread's counters of `probe`
+    void record_probe(ProbeId probe, uint64_t nanoseconds, uint64_t items);
+
+    // Totals of every registered probe over all threads, live and exited,
+    // in registration order
+    std::vector<ProbeTotals> instrumentation_snapshot();
+
+    // Zeroes all counters; names stay registered. Call it while no other
+    // thread is recording.
+    void reset_instrumentation();
+
+    // Probes named prefix + test name, one per test, for loops that time
+    // each test separately. Empty when instrumentation is compiled out.
+    template <typename Test>
+    std::vector<ProbeId> probes_for(const std::vector<Test *> &tests, const std::string &prefix)
+    {
+        std::vector<ProbeId> probes;
+#ifdef RNG_INSTRUMENTATION
+        for (const Test *test : tests)
+            probes.push_back(register_probe(prefix + test->get_test_name()));
+#else
+        static_cast<void>(tests);
+        static_cast<void>(prefix);
+#endif
+        return probes;
+    }
+
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(ProbeId probe, uint64_t items)
+            : probe_(probe), items_(items), start_(std::chrono::steady_clock::now()) {}
+
+        ~ScopedTimer()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            record_probe(probe_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), items_);
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        ProbeId probe_;
+        uint64_t items_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+} // namespace rng
+
+#define RNG_INSTRUMENTATION_JOIN_(a, b) a##b
+#define RNG_INSTRUMENTATION_JOIN(a, b) RNG_INSTRUMENTATION_JOIN_(a, b)
+
+#ifdef RNG_INSTRUMENTATION
+#define RNG_PROBE(name) ::rng::register_probe(name)
+#define RNG_TIMED_SCOPE(probe, items) \
+    ::rng::ScopedTimer RNG_INSTRUMENTATION_JOIN(rng_scoped_timer_, __LINE__)((probe), (items))
+#define RNG_COUNT(probe, items) ::rng::record_probe((probe), 0, (items))
+#else
+#define RNG_PROBE(name) ::rng::ProbeId(0)
+#define RNG_TIMED_SCOPE(probe, items) static_cast<void>(sizeof(probe) + sizeof(items))
+#define RNG_COUNT(probe, items) static_cast<void>(sizeof(probe) + sizeof(items))
+#endif
+
+#endif // INSTRUMENTATION_HPP
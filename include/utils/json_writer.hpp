@@ -0,0 +1,161 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rng
+{
+
+    // Streaming JSON emitter: commas and nesting are tracked, keys and
+    // values are escaped, non-finite numbers are written as null
+    class JsonWriter
+    {
+    public:
+        explicit JsonWriter(std::ostream &out) : out_(out), after_key_(false) {}
+
+        JsonWriter &begin_object()
+        {
+            prefix();
+            out_ << '{';
+            first_.push_back(true);
+            return *this;
+        }
+
+        JsonWriter &end_object()
+        {
+            first_.pop_back();
+            out_ << '}';
+            return *this;
+        }
+
+        JsonWriter &begin_array()
+        {
+            prefix();
+            out_ << '[';
+            first_.push_back(true);
+            return *this;
+        }
+
+        JsonWriter &end_array()
+        {
+            first_.pop_back();
+            out_ << ']';
+            return *this;
+        }
+
+        JsonWriter &key(const std::string &name)
+        {
+            prefix();
+            write_string(name);
+            out_ << ':';
+            after_key_ = true;
+            return *this;
+        }
+
+        JsonWriter &value(const std::string &text)
+        {
+            prefix();
+            write_string(text);
+            return *this;
+        }
+
+        JsonWriter &value(const char *text)
+        {
+            return value(std::string(text));
+        }
+
+        JsonWriter &value(double number)
+        {
+            prefix();
+            if (std::isfinite(number))
+                out_ << std::setprecision(17) << number;
+            else
+                out_ << "null";
+            return *this;
+        }
+
+        JsonWriter &value(uint64_t number)
+        {
+            prefix();
+            out_ << number;
+            return *this;
+        }
+
+        JsonWriter &value(bool flag)
+        {
+            prefix();
+            out_ << (flag ? "true" : "false");
+            return *this;
+        }
+
+        template <typename T>
+        JsonWriter &field(const std::string &name, const T &v)
+        {
+            return key(name).value(v);
+        }
+
+    private:
+        std::ostream &out_;
+        std::vector<bool> first_; // per open container: nothing written yet
+        bool after_key_;
+
+        void prefix()
+        {
+            if (after_key_)
+            {
+                after_key_ = false;
+                return;
+            }
+            if (!first_.empty())
+            {
+                if (!first_.back())
+                    out_ << ',';
+                first_.back() = false;
+            }
+        }
+
+        void write_string(const std::string &text)
+        {
+            out_ << '"';
+            for (char c : text)
+            {
+                switch (c)
+                {
+                case '"':
+                    out_ << "\\\"";
+                    break;
+                case '\\':
+                    out_ << "\\\\";
+                    break;
+                case '\n':
+                    out_ << "\\n";
+                    break;
+                case '\t':
+                    out_ << "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        std::ostringstream escaped;
+                        escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                        out_ << escaped.str();
+                    }
+                    else
+                    {
+                        out_ << c;
+                    }
+                }
+            }
+            out_ << '"';
+        }
+    };
+
+} // namespace rng
+
+#endif // JSON_WRITER_HPP
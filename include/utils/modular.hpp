@@ -0,0 +1,105 @@
+#ifndef MODULAR_HPP
+#define MODULAR_HPP
+
+#include <cstdint>
+
+namespace rng
+{
+
+    // (a * b) mod m without overflow for any 64-bit modulus
+    inline uint64_t mul_mod(uint64_t a, uint64_t b, uint64_t m)
+    {
+        return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % m);
+    }
+
+    inline uint64_t add_mod(uint64_t a, uint64_t b, uint64_t m)
+    {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(a) + b) % m);
+    }
+
+    // base^exponent mod m by repeated squaring
+    inline uint64_t pow_mod(uint64_t base, uint64_t exponent, uint64_t m)
+    {
+        uint64_t result = 1 % m;
+        base %= m;
+        while (exponent > 0)
+        {
+            if (exponent & 1)
+                result = mul_mod(result, base, m);
+            base = mul_mod(base, base, m);
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    // Reduction modulo m < 2^32 of 64-bit values with a multiply instead of a
+    // division (Barrett): the estimated quotient is off by at most one
+    struct BarrettReducer
+    {
+        uint64_t m;
+        uint64_t mu; // floor((2^64 - 1) / m)
+
+        explicit BarrettReducer(uint64_t modulus) : m(modulus), mu(~0ULL / modulus) {}
+
+        uint64_t reduce(uint64_t x) const
+        {
+            uint64_t q = static_cast<uint64_t>((static_cast<unsigned __int128>(x) * mu) >> 64);
+            uint64_t r = x - q * m;
+            return r >= m ? r - m : r;
+        }
+
+        uint64_t mul(uint64_t a, uint64_t b) const { return reduce(a * b); }
+    };
+
+    // Inverse of x modulo an odd m < 2^32 by the binary extended Euclidean
+    // algorithm, without divisions: each step subtracts the smaller odd
+    // value from the larger and strips the trailing zeros with one bit scan,
+    // dividing the matching coefficient by 2^k in one Montgomery-style
+    // reduction. Returns 0 when x has no inverse.
+    inline uint64_t inverse_mod_odd(uint64_t x, uint64_t m)
+    {
+        // -1/m mod 2^64 by Newton's iteration; m is its own inverse mod 8
+        uint64_t m_inverse = m;
+        for (int i = 0; i < 5; ++i)
+            m_inverse *= 2 - m * m_inverse;
+        const uint64_t negated = 0 - m_inverse;
+        // value / 2^k mod m for value < m and k < 32: adds the multiple of m
+        // that clears the low k bits, so the sum stays below m * 2^k
+        auto halve = [m, negated](uint64_t value, unsigned k)
+        {
+            uint64_t t = (value * negated) & ((1ULL << k) - 1);
+            return (value + m * t) >> k;
+        };
+
+        uint64_t u = x % m, v = m;
+        if (u == 0)
+            return 0;
+        uint64_t x1 = 1, x2 = 0; // u = x1 * x and v = x2 * x (mod m) throughout
+        unsigned k = static_cast<unsigned>(__builtin_ctzll(u));
+        u >>= k;
+        x1 = halve(x1, k);
+        while (u != v)
+        {
+            if (u > v)
+            {
+                u -= v;
+                x1 = x1 >= x2 ? x1 - x2 : x1 + m - x2;
+                k = static_cast<unsigned>(__builtin_ctzll(u));
+                u >>= k;
+                x1 = halve(x1, k);
+            }
+            else
+            {
+                v -= u;
+                x2 = x2 >= x1 ? x2 - x1 : x2 + m - x1;
+                k = static_cast<unsigned>(__builtin_ctzll(v));
+                v >>= k;
+                x2 = halve(x2, k);
+            }
+        }
+        return u == 1 ? x1 : 0;
+    }
+
+} // namespace rng
+
+#endif // MODULAR_HPP
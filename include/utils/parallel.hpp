@@ -0,0 +1,135 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace rng
+{
+
+    namespace detail
+    {
+        // Cap on default_thread_count() for the calling thread, 0 for none
+        inline size_t &thread_limit()
+        {
+            thread_local size_t limit = 0;
+            return limit;
+        }
+    } // namespace detail
+
+    // Number of worker threads to use when the caller does not specify one
+    inline size_t default_thread_count()
+    {
+        unsigned int count = std::thread::hardware_concurrency();
+        size_t threads = count == 0 ? 1 : count;
+        size_t limit = detail::thread_limit();
+        return limit != 0 ? std::min(threads, limit) : threads;
+    }
+
+    // Lowers default_thread_count() on the calling thread while it lives.
+    // Engines that already run one shard per thread set it before building
+    // the tests of a shard, so tests that pick their own thread count do not
+    // multiply the threads of the engine.
+    class ScopedThreadLimit
+    {
+    public:
+        explicit ScopedThreadLimit(size_t limit) : previous_(detail::thread_limit())
+        {
+            detail::thread_limit() = std::max<size_t>(1, limit);
+        }
+        ~ScopedThreadLimit() { detail::thread_limit() = previous_; }
+        ScopedThreadLimit(const ScopedThreadLimit &) = delete;
+        ScopedThreadLimit &operator=(const ScopedThreadLimit &) = delete;
+
+    private:
+        size_t previous_;
+    };
+
+    // Splits [0, count) into `shards` contiguous ranges and runs
+    // fn(shard_index, begin, end) for each range on its own thread.
+    // The first exception thrown by any shard is rethrown to the caller.
+    template <typename Fn>
+    void parallel_for_shards(size_t count, size_t shards, Fn &&fn)
+    {
+        if (shards == 0)
+            shards = 1;
+        if (shards > count)
+            shards = count == 0 ? 1 : count;
+
+        if (shards == 1)
+        {
+            fn(size_t(0), size_t(0), count);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(shards);
+        threads.reserve(shards);
+
+        size_t base = count / shards;
+        size_t extra = count % shards;
+        size_t begin = 0;
+
+        for (size_t s = 0; s < shards; ++s)
+        {
+            size_t end = begin + base + (s < extra ? 1 : 0);
+            threads.emplace_back([&fn, &errors, s, begin, end]()
+                                 {
+                try
+                {
+                    fn(s, begin, end);
+                }
+                catch (...)
+                {
+                    errors[s] = std::current_exception();
+                } });
+            begin = end;
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        for (const auto &error : errors)
+        {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+    // Sorts `data` by sorting shards on separate threads and merging the
+    // sorted runs pairwise, each round of merges also running in parallel
+    template <typename T>
+    void parallel_sort(std::vector<T> &data, size_t num_threads)
+    {
+        size_t shards = std::max<size_t>(1, std::min(num_threads, data.size() / 4096));
+        std::vector<size_t> bounds(shards + 1, 0);
+
+        parallel_for_shards(data.size(), shards, [&](size_t shard, size_t begin, size_t end)
+                            {
+            bounds[shard + 1] = end;
+            std::sort(data.begin() + begin, data.begin() + end); });
+
+        for (size_t width = 1; width < shards; width *= 2)
+        {
+            size_t merges = (shards + 2 * width - 1) / (2 * width);
+            parallel_for_shards(merges, merges, [&](size_t, size_t begin, size_t end)
+                                {
+                for (size_t m = begin; m < end; ++m)
+                {
+                    size_t left = 2 * width * m;
+                    size_t middle = std::min(left + width, shards);
+                    size_t right = std::min(left + 2 * width, shards);
+                    if (middle < right)
+                        std::inplace_merge(data.begin() + bounds[left], data.begin() + bounds[middle],
+                                           data.begin() + bounds[right]);
+                } });
+        }
+    }
+
+} // namespace rng
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,129 @@
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rng
+{
+
+    // Appends fixed-width little-endian fields to a byte buffer
+    class BinaryWriter
+    {
+    public:
+        void write_u64(uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+                buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+
+        void write_f64(double value)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            write_u64(bits);
+        }
+
+        void write_bool(bool value)
+        {
+            buffer_.push_back(value ? 1 : 0);
+        }
+
+        void write_string(const std::string &value)
+        {
+            write_u64(value.size());
+            buffer_ += value;
+        }
+
+        void write_u64_vector(const std::vector<uint64_t> &values)
+        {
+            write_u64(values.size());
+            for (uint64_t value : values)
+                write_u64(value);
+        }
+
+        const std::string &data() const { return buffer_; }
+
+    private:
+        std::string buffer_;
+    };
+
+    // Reads back what BinaryWriter wrote; throws std::runtime_error when the
+    // data ends early
+    class BinaryReader
+    {
+    public:
+        explicit BinaryReader(const std::string &data) : data_(data), offset_(0) {}
+
+        uint64_t read_u64()
+        {
+            require(8);
+            uint64_t value = 0;
+            for (int i = 0; i < 8; ++i)
+                value |= static_cast<uint64_t>(static_cast<unsigned char>(data_[offset_ + i])) << (8 * i);
+            offset_ += 8;
+            return value;
+        }
+
+        double read_f64()
+        {
+            uint64_t bits = read_u64();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        bool read_bool()
+        {
+            require(1);
+            return data_[offset_++] != 0;
+        }
+
+        std::string read_string()
+        {
+            uint64_t size = read_u64();
+            require(size);
+            std::string value = data_.substr(offset_, static_cast<size_t>(size));
+            offset_ += static_cast<size_t>(size);
+            return value;
+        }
+
+        std::vector<uint64_t> read_u64_vector()
+        {
+            uint64_t size = read_u64();
+            if (size > (data_.size() - offset_) / 8)
+                throw std::runtime_error("Serialized data is truncated");
+            std::vector<uint64_t> values(static_cast<size_t>(size));
+            for (auto &value : values)
+                value = read_u64();
+            return values;
+        }
+
+        // Reads a vector that must have exactly `size` entries
+        std::vector<uint64_t> read_u64_vector(size_t size)
+        {
+            std::vector<uint64_t> values = read_u64_vector();
+            if (values.size() != size)
+                throw std::runtime_error("Serialized state has the wrong size");
+            return values;
+        }
+
+        bool at_end() const { return offset_ == data_.size(); }
+
+    private:
+        const std::string &data_;
+        size_t offset_;
+
+        void require(uint64_t bytes) const
+        {
+            if (bytes > data_.size() - offset_)
+                throw std::runtime_error("Serialized data is truncated");
+        }
+    };
+
+} // namespace rng
+
+#endif // SERIALIZATION_HPP
@@ -0,0 +1,65 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rng
+{
+
+    // Fixed-size thread pool with one task deque per worker. A worker takes
+    // its own newest task first and, when its deque is empty, steals the
+    // oldest task of another worker, so uneven jobs still keep every core busy.
+    // Tasks receive the index of the worker running them, which callers use
+    // to keep reusable per-worker state.
+    class WorkStealingPool
+    {
+    public:
+        using Task = std::function<void(size_t)>;
+
+        explicit WorkStealingPool(size_t num_threads = 0);
+        ~WorkStealingPool();
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        size_t size() const;
+
+        // Queues a task (on the calling worker's deque when called from a task)
+        void submit(Task task);
+
+        // Blocks until all submitted tasks have finished and rethrows the
+        // first exception raised by any of them
+        void wait();
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex state_mutex_;
+        std::condition_variable work_available_;
+        std::condition_variable all_done_;
+        std::atomic<size_t> queued_;
+        size_t pending_;
+        size_t next_queue_;
+        bool stopping_;
+        std::exception_ptr error_;
+
+        bool try_pop(size_t worker, Task &task);
+        void worker_loop(size_t index);
+    };
+
+} // namespace rng
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,139 @@
+#include "../../include/bench/benchmark.hpp"
+#include "../../include/utils/cpu_dispatch.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+
+    void print_usage()
+    {
+        std::cout << "Usage: rng_bench [options]\n"
+                  << "  --quick               two sizes, fewer repetitions\n"
+                  << "  --filter TEXT         only generators/tests whose name contains TEXT\n"
+                  << "  --sizes N,N,...       numbers per call for generator paths\n"
+                  << "  --test-size N         numbers per test run\n"
+                  << "  --reps N              timed repetitions per case\n"
+                  << "  --format FORMAT       table (default), csv or json\n"
+                  << "  --output FILE         write results to FILE instead of stdout\n"
+                  << "  --baseline FILE       compare with a CSV written by --format csv;\n"
+                  << "                        the comparison goes to stderr\n"
+                  << "  --threshold X         slowdown counted as regression (default 0.10)\n"
+                  << "  --cpu LEVEL           vector kernels to use: baseline, sse4.2, avx2 or avx512\n"
+                  << "                        (default: the widest this CPU supports)\n"
+                  << "Exit status 2 means the comparison found regressions.\n";
+    }
+
+    std::vector<size_t> parse_sizes(const std::string &text)
+    {
+        std::vector<size_t> sizes;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            size_t size = std::stoull(item);
+            if (size == 0)
+                throw std::invalid_argument("Sizes must be positive");
+            sizes.push_back(size);
+        }
+        return sizes;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        rng::BenchmarkOptions options;
+        std::string format = "table";
+        std::string output_path;
+        std::string baseline_path;
+        double threshold = 0.10;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument("Missing value after " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--help" || arg == "-h")
+            {
+                print_usage();
+                return 0;
+            }
+            else if (arg == "--quick")
+            {
+                options.sizes = {1 << 11, 1 << 20};
+                options.repetitions = 5;
+                options.warmup = 1;
+                options.min_seconds = 0.005;
+            }
+            else if (arg == "--filter")
+                options.filter = next();
+            else if (arg == "--sizes")
+                options.sizes = parse_sizes(next());
+            else if (arg == "--test-size")
+                options.test_size = std::stoull(next());
+            else if (arg == "--reps")
+                options.repetitions = std::stoull(next());
+            else if (arg == "--format")
+                format = next();
+            else if (arg == "--output")
+                output_path = next();
+            else if (arg == "--baseline")
+                baseline_path = next();
+            else if (arg == "--threshold")
+                threshold = std::stod(next());
+            else if (arg == "--cpu")
+                rng::select_cpu_level(rng::parse_cpu_level(next()));
+            else
+                throw std::invalid_argument("Unknown option " + arg);
+        }
+        if (format != "table" && format != "csv" && format != "json")
+        {
+            throw std::invalid_argument("Format must be table, csv or json");
+        }
+
+        std::vector<rng::BenchmarkResult> results = rng::run_benchmarks(options, &std::cerr);
+
+        std::ofstream file;
+        if (!output_path.empty())
+        {
+            file.open(output_path);
+            if (!file)
+                throw std::runtime_error("Cannot open " + output_path);
+        }
+        std::ostream &out = output_path.empty() ? std::cout : file;
+        if (format == "csv")
+            rng::write_benchmarks_csv(out, results);
+        else if (format == "json")
+            rng::write_benchmarks_json(out, results);
+        else
+            rng::write_benchmarks_table(out, results);
+
+        if (!baseline_path.empty())
+        {
+            // On stderr, so it never mixes with CSV or JSON on stdout
+            std::cerr << "\nComparison with " << baseline_path << ":\n";
+            size_t regressions = rng::compare_benchmarks(std::cerr, rng::read_benchmarks_csv(baseline_path),
+                                                         results, threshold);
+            if (regressions > 0)
+                return 2;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
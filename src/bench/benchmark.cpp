@@ -0,0 +1,383 @@
+#include "../../include/bench/benchmark.hpp"
+#include "../../include/generators/generator_suite.hpp"
+#include "../../include/generators/mcg.hpp"
+#include "../../include/tests/randomness_tests.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/json_writer.hpp"
+#include "../../include/utils/cpu_dispatch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Keeps results of benchmarked calls observable
+        volatile double benchmark_sink = 0.0;
+
+        double percentile(const std::vector<double> &sorted, double fraction)
+        {
+            double position = fraction * (sorted.size() - 1);
+            size_t below = static_cast<size_t>(position);
+            size_t above = std::min(below + 1, sorted.size() - 1);
+            return sorted[below] + (position - below) * (sorted[above] - sorted[below]);
+        }
+
+        bool matches(const BenchmarkOptions &options, const std::string &name)
+        {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        }
+
+        std::string read_first_line(const std::string &path)
+        {
+            std::ifstream file(path);
+            std::string line;
+            std::getline(file, line);
+            return line;
+        }
+
+        // Value of the first "key : value" line of /proc/cpuinfo with this key
+        std::string cpuinfo_field(const std::string &key)
+        {
+            std::ifstream file("/proc/cpuinfo");
+            std::string line;
+            while (std::getline(file, line))
+            {
+                if (line.compare(0, key.size(), key) == 0)
+                {
+                    size_t colon = line.find(':');
+                    if (colon != std::string::npos)
+                        return line.substr(line.find_first_not_of(' ', colon + 1));
+                }
+            }
+            return "";
+        }
+
+        std::string csv_field(const std::string &text)
+        {
+            if (text.find_first_of(",\"\n") == std::string::npos)
+                return text;
+            std::string quoted = "\"";
+            for (char c : text)
+            {
+                if (c == '"')
+                    quoted += '"';
+                quoted += c;
+            }
+            return quoted + "\"";
+        }
+
+        std::vector<std::string> split_csv_line(const std::string &line)
+        {
+            std::vector<std::string> fields(1);
+            bool quoted = false;
+            for (size_t i = 0; i < line.size(); ++i)
+            {
+                char c = line[i];
+                if (quoted)
+                {
+                    if (c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+                        fields.back() += line[++i];
+                    else if (c == '"')
+                        quoted = false;
+                    else
+                        fields.back() += c;
+                }
+                else if (c == '"')
+                    quoted = true;
+                else if (c == ',')
+                    fields.emplace_back();
+                else
+                    fields.back() += c;
+            }
+            return fields;
+        }
+    } // namespace
+
+    std::string BenchmarkResult::key() const
+    {
+        return group + "/" + name + "/" + variant + "/" + std::to_string(size);
+    }
+
+    BenchmarkResult measure(const std::string &group, const std::string &name, const std::string &variant,
+                            size_t size, const BenchmarkOptions &options, const std::function<void()> &body)
+    {
+        using clock = std::chrono::steady_clock;
+        for (size_t i = 0; i < options.warmup; ++i)
+            body();
+
+        std::vector<double> samples;
+        for (size_t r = 0; r < std::max<size_t>(1, options.repetitions); ++r)
+        {
+            size_t calls = 0;
+            double elapsed = 0.0;
+            auto start = clock::now();
+            do
+            {
+                body();
+                ++calls;
+                elapsed = std::chrono::duration<double>(clock::now() - start).count();
+            } while (elapsed < options.min_seconds);
+            samples.push_back(elapsed * 1e9 / (static_cast<double>(calls) * size));
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchmarkResult result;
+        result.group = group;
+        result.name = name;
+        result.variant = variant;
+        result.size = size;
+        result.repetitions = samples.size();
+        result.median_ns = percentile(samples, 0.5);
+        result.p10_ns = percentile(samples, 0.1);
+        result.p90_ns = percentile(samples, 0.9);
+        result.min_ns = samples.front();
+        result.gb_per_s = sizeof(double) / result.median_ns;
+        return result;
+    }
+
+    std::vector<BenchmarkResult> run_benchmarks(const BenchmarkOptions &options, std::ostream *progress)
+    {
+        std::vector<BenchmarkResult> results;
+        auto record = [&results, progress](BenchmarkResult result)
+        {
+            if (progress != nullptr)
+                *progress << result.key() << ": " << result.median_ns << " ns/number\n";
+            results.push_back(std::move(result));
+        };
+
+        for (const auto &generator : create_generator_suite())
+        {
+            std::string name = generator->get_name();
+            if (!matches(options, name))
+                continue;
+            for (size_t size : options.sizes)
+            {
+                std::vector<double> buffer(size);
+                RandomGenerator *g = generator.get();
+
+                record(measure("generator", name, "generate", size, options, [g, &buffer]()
+                               {
+                    for (double &value : buffer)
+                        value = g->generate();
+                    benchmark_sink = benchmark_sink + buffer.back(); }));
+                record(measure("generator", name, "generate_sequence", size, options, [g, size]()
+                               {
+                    std::vector<double> sequence = g->generate_sequence(size);
+                    benchmark_sink = benchmark_sink + sequence.back(); }));
+                record(measure("generator", name, "fill", size, options, [g, &buffer]()
+                               {
+                    g->fill(buffer.data(), buffer.size());
+                    benchmark_sink = benchmark_sink + buffer.back(); }));
+            }
+        }
+
+        MCG source;
+        std::vector<double> numbers = source.generate_sequence(options.test_size);
+        for (const auto &test : create_test_suite())
+        {
+            std::string name = test->get_test_name();
+            if (!matches(options, name))
+                continue;
+            RandomnessTest *t = test.get();
+            record(measure("test", name, "run_test", numbers.size(), options, [t, &numbers]()
+                           { benchmark_sink = benchmark_sink + t->run_test(numbers, 0.01); }));
+        }
+
+        // Bit tests read the raw bits of the same number of outputs
+        source.set_seed(1);
+        BitSequence bits = generate_bit_sequence(source, options.test_size * source.raw_bits());
+        for (const auto &test : create_bit_test_suite())
+        {
+            std::string name = test->get_test_name();
+            if (!matches(options, name))
+                continue;
+            BitStreamTest *t = test.get();
+            record(measure("bit_test", name, "run_test", options.test_size, options, [t, &bits]()
+                           { benchmark_sink = benchmark_sink + t->run_test(bits, 0.01); }));
+        }
+        return results;
+    }
+
+    std::vector<std::pair<std::string, std::string>> describe_environment()
+    {
+        std::vector<std::pair<std::string, std::string>> notes;
+        std::string model = cpuinfo_field("model name");
+        notes.emplace_back("cpu_model", model.empty() ? "unknown" : model);
+        notes.emplace_back("logical_cpus", std::to_string(std::thread::hardware_concurrency()));
+        std::string mhz = cpuinfo_field("cpu MHz");
+        notes.emplace_back("cpu_mhz_at_start", mhz.empty() ? "unknown" : mhz);
+
+        std::string governor = read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+        notes.emplace_back("scaling_governor", governor.empty() ? "unknown" : governor);
+        std::string no_turbo = read_first_line("/sys/devices/system/cpu/intel_pstate/no_turbo");
+        if (!no_turbo.empty())
+            notes.emplace_back("turbo", no_turbo == "0" ? "enabled" : "disabled");
+        notes.emplace_back("cpu_level_detected", cpu_level_name(detected_cpu_level()));
+        notes.emplace_back("cpu_level_selected", cpu_level_name(selected_cpu_level()));
+#ifdef NDEBUG
+        notes.emplace_back("build", "optimized");
+#else
+        notes.emplace_back("build", "debug (NDEBUG not set)");
+#endif
+
+        if (!governor.empty() && governor != "performance")
+            notes.emplace_back("warning", "frequency scaling governor is '" + governor +
+                                              "'; use 'performance' for stable numbers");
+        if (no_turbo == "0")
+            notes.emplace_back("warning", "turbo boost is on; clock speed depends on load and temperature");
+        return notes;
+    }
+
+    void write_benchmarks_csv(std::ostream &out, const std::vector<BenchmarkResult> &results)
+    {
+        for (const auto &note : describe_environment())
+            out << "# " << note.first << ": " << note.second << "\n";
+        out << "group,name,variant,size,repetitions,median_ns,p10_ns,p90_ns,min_ns,gb_per_s\n";
+        out << std::setprecision(6);
+        for (const auto &r : results)
+        {
+            out << r.group << ',' << csv_field(r.name) << ',' << r.variant << ',' << r.size << ','
+                << r.repetitions << ',' << r.median_ns << ',' << r.p10_ns << ',' << r.p90_ns << ','
+                << r.min_ns << ',' << r.gb_per_s << "\n";
+        }
+    }
+
+    void write_benchmarks_json(std::ostream &out, const std::vector<BenchmarkResult> &results)
+    {
+        JsonWriter json(out);
+        json.begin_object();
+        json.key("environment").begin_object();
+        std::vector<std::string> warnings;
+        for (const auto &note : describe_environment())
+        {
+            if (note.first == "warning")
+                warnings.push_back(note.second);
+            else
+                json.field(note.first, note.second);
+        }
+        json.key("warnings").begin_array();
+        for (const auto &warning : warnings)
+            json.value(warning);
+        json.end_array();
+        json.end_object();
+
+        json.key("results").begin_array();
+        for (const auto &r : results)
+        {
+            json.begin_object()
+                .field("group", r.group)
+                .field("name", r.name)
+                .field("variant", r.variant)
+                .field("size", static_cast<uint64_t>(r.size))
+                .field("repetitions", static_cast<uint64_t>(r.repetitions))
+                .field("median_ns", r.median_ns)
+                .field("p10_ns", r.p10_ns)
+                .field("p90_ns", r.p90_ns)
+                .field("min_ns", r.min_ns)
+                .field("gb_per_s", r.gb_per_s)
+                .end_object();
+        }
+        json.end_array();
+        json.end_object();
+        out << "\n";
+    }
+
+    void write_benchmarks_table(std::ostream &out, const std::vector<BenchmarkResult> &results)
+    {
+        for (const auto &note : describe_environment())
+            out << note.first << ": " << note.second << "\n";
+        out << "\n";
+        out << std::left << std::setw(48) << "name" << std::setw(18) << "variant" << std::right
+            << std::setw(10) << "size" << std::setw(12) << "median ns" << std::setw(12) << "p10 ns"
+            << std::setw(12) << "p90 ns" << std::setw(10) << "GB/s" << "\n";
+        out << std::fixed << std::setprecision(3);
+        for (const auto &r : results)
+        {
+            out << std::left << std::setw(48) << r.name.substr(0, 47) << std::setw(18) << r.variant << std::right
+                << std::setw(10) << r.size << std::setw(12) << r.median_ns << std::setw(12) << r.p10_ns
+                << std::setw(12) << r.p90_ns << std::setw(10) << r.gb_per_s << "\n";
+        }
+    }
+
+    std::vector<BenchmarkResult> read_benchmarks_csv(const std::string &path)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            throw std::runtime_error("Cannot open baseline " + path);
+        }
+        std::vector<BenchmarkResult> results;
+        std::string line;
+        bool header_seen = false;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            if (!header_seen)
+            {
+                header_seen = true;
+                continue;
+            }
+            std::vector<std::string> fields = split_csv_line(line);
+            if (fields.size() != 10)
+            {
+                throw std::runtime_error("Malformed line in baseline " + path + ": " + line);
+            }
+            BenchmarkResult r;
+            r.group = fields[0];
+            r.name = fields[1];
+            r.variant = fields[2];
+            r.size = std::stoull(fields[3]);
+            r.repetitions = std::stoull(fields[4]);
+            r.median_ns = std::stod(fields[5]);
+            r.p10_ns = std::stod(fields[6]);
+            r.p90_ns = std::stod(fields[7]);
+            r.min_ns = std::stod(fields[8]);
+            r.gb_per_s = std::stod(fields[9]);
+            results.push_back(r);
+        }
+        return results;
+    }
+
+    size_t compare_benchmarks(std::ostream &out, const std::vector<BenchmarkResult> &baseline,
+                              const std::vector<BenchmarkResult> &current, double threshold)
+    {
+        std::map<std::string, const BenchmarkResult *> by_key;
+        for (const auto &r : baseline)
+            by_key[r.key()] = &r;
+
+        size_t regressions = 0;
+        out << std::fixed << std::setprecision(3);
+        for (const auto &r : current)
+        {
+            auto found = by_key.find(r.key());
+            if (found == by_key.end())
+                continue;
+            double ratio = r.median_ns / found->second->median_ns;
+            std::string status = "ok";
+            if (ratio > 1.0 + threshold)
+            {
+                status = "REGRESSION";
+                ++regressions;
+            }
+            else if (ratio < 1.0 / (1.0 + threshold))
+            {
+                status = "faster";
+            }
+            out << std::left << std::setw(12) << status << std::right << r.key() << ": "
+                << found->second->median_ns << " -> " << r.median_ns << " ns/number ("
+                << std::showpos << (ratio - 1.0) * 100.0 << std::noshowpos << "%)\n";
+        }
+        out << regressions << " regression(s) above " << threshold * 100.0 << "%\n";
+        return regressions;
+    }
+
+} // namespace rng
@@ -0,0 +1,397 @@
+#include "../../include/capi/rng_c.h"
+#include "../../include/generators/generator_suite.hpp"
+#include "../../include/tests/knuth_tests.hpp"
+#include "../../include/tests/randomness_tests.hpp"
+#include "../../include/utils/serialization.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+struct rng_generator
+{
+    std::unique_ptr<rng::RandomGenerator> impl;
+    std::string name;
+};
+
+struct rng_test
+{
+    std::unique_ptr<rng::StreamingTest> impl;
+    std::string name;
+    std::string result;
+};
+
+namespace
+{
+
+    thread_local std::string last_error;
+
+    // Runs body, turning exceptions into status codes; nothing may escape
+    // into C callers
+    template <typename Body>
+    rng_status guarded(Body &&body)
+    {
+        try
+        {
+            body();
+            return RNG_OK;
+        }
+        catch (const std::invalid_argument &e)
+        {
+            last_error = e.what();
+            return RNG_ERROR_INVALID_ARGUMENT;
+        }
+        catch (const std::bad_alloc &)
+        {
+            last_error = "Out of memory";
+            return RNG_ERROR_OUT_OF_MEMORY;
+        }
+        catch (const std::exception &e)
+        {
+            last_error = e.what();
+            return RNG_ERROR_RUNTIME;
+        }
+        catch (...)
+        {
+            last_error = "Unknown error";
+            return RNG_ERROR_RUNTIME;
+        }
+    }
+
+    void require(bool condition, const char *message)
+    {
+        if (!condition)
+            throw std::invalid_argument(message);
+    }
+
+    // Kinds are looked up by fixed keys rather than by get_name() or
+    // get_test_name(), which are display texts that may change. Generator
+    // keys are those of generator_suite_keys(); the tests are the streaming
+    // tests of create_test_suite() with the same parameters.
+    struct TestKind
+    {
+        const char *key;
+        std::unique_ptr<rng::StreamingTest> (*make)();
+    };
+
+    template <typename Test, typename... Args>
+    std::unique_ptr<rng::StreamingTest> make(Args... args)
+    {
+        return std::make_unique<Test>(args...);
+    }
+
+    const TestKind TEST_KINDS[] = {
+        {"chi-square", []
+         { return make<rng::ChiSquareTest>(); }},
+        {"runs", []
+         { return make<rng::RunsTest>(); }},
+        {"runs-up", []
+         { return make<rng::RunsUpDownTest>(rng::RunDirection::Up); }},
+        {"runs-down", []
+         { return make<rng::RunsUpDownTest>(rng::RunDirection::Down); }},
+        {"serial-correlation", []
+         { return make<rng::SerialCorrelationTest>(); }},
+        {"gap", []
+         { return make<rng::GapTest>(); }},
+        {"poker", []
+         { return make<rng::PokerTest>(); }},
+        {"coupon-collector", []
+         { return make<rng::CouponCollectorTest>(); }},
+        {"max-of-t", []
+         { return make<rng::MaximumOfTTest>(); }},
+    };
+
+    const TestKind &find_test_kind(const char *key)
+    {
+        for (const TestKind &kind : TEST_KINDS)
+        {
+            if (std::strcmp(kind.key, key) == 0)
+                return kind;
+        }
+        throw std::invalid_argument(std::string("Unknown streaming test kind ") + key);
+    }
+
+    rng_generator *wrap(std::unique_ptr<rng::RandomGenerator> impl)
+    {
+        auto *handle = new rng_generator;
+        handle->name = impl->get_name();
+        handle->impl = std::move(impl);
+        return handle;
+    }
+
+    rng_test *wrap(std::unique_ptr<rng::StreamingTest> impl)
+    {
+        auto *handle = new rng_test;
+        handle->name = impl->get_test_name();
+        handle->impl = std::move(impl);
+        return handle;
+    }
+
+} // namespace
+
+extern "C"
+{
+
+    uint32_t rng_abi_version(void)
+    {
+        return RNG_C_ABI_VERSION;
+    }
+
+    const char *rng_last_error(void)
+    {
+        return last_error.c_str();
+    }
+
+    size_t rng_generator_kind_count(void)
+    {
+        try
+        {
+            return rng::generator_suite_keys().size();
+        }
+        catch (...)
+        {
+            return 0;
+        }
+    }
+
+    const char *rng_generator_kind_name(size_t index)
+    {
+        size_t count = rng_generator_kind_count();
+        return index < count ? rng::generator_suite_keys()[index].c_str() : nullptr;
+    }
+
+    rng_status rng_generator_create(const char *kind, uint64_t seed, rng_generator **out)
+    {
+        return guarded([&]
+                       {
+            require(kind != nullptr && out != nullptr, "Null argument");
+            std::unique_ptr<rng::RandomGenerator> impl = rng::create_generator(kind);
+            impl->set_seed(seed);
+            *out = wrap(std::move(impl)); });
+    }
+
+    rng_status rng_generator_clone(const rng_generator *generator, rng_generator **out)
+    {
+        return guarded([&]
+                       {
+            require(generator != nullptr && out != nullptr, "Null argument");
+            *out = wrap(generator->impl->clone()); });
+    }
+
+    void rng_generator_destroy(rng_generator *generator)
+    {
+        delete generator;
+    }
+
+    const char *rng_generator_name(const rng_generator *generator)
+    {
+        return generator != nullptr ? generator->name.c_str() : nullptr;
+    }
+
+    rng_status rng_generator_seed(rng_generator *generator, uint64_t seed)
+    {
+        return guarded([&]
+                       {
+            require(generator != nullptr, "Null generator");
+            generator->impl->set_seed(seed); });
+    }
+
+    rng_status rng_generator_fill(rng_generator *generator, double *out, size_t count)
+    {
+        return guarded([&]
+                       {
+            require(generator != nullptr && (out != nullptr || count == 0), "Null argument");
+            generator->impl->fill(out, count); });
+    }
+
+    rng_status rng_generator_fill_raw(rng_generator *generator, uint64_t *out, size_t count)
+    {
+        return guarded([&]
+                       {
+            require(generator != nullptr && (out != nullptr || count == 0), "Null argument");
+            rng::RandomGenerator &impl = *generator->impl;
+            for (size_t i = 0; i < count; ++i)
+                out[i] = impl.generate_raw(); });
+    }
+
+    unsigned rng_generator_raw_bits(const rng_generator *generator)
+    {
+        return generator != nullptr ? generator->impl->raw_bits() : 0;
+    }
+
+    rng_status rng_generator_jump(rng_generator *generator, uint64_t steps)
+    {
+        return guarded([&]
+                       {
+            require(generator != nullptr, "Null generator");
+            generator->impl->jump_ahead(steps); });
+    }
+
+    int rng_generator_supports_jump(const rng_generator *generator)
+    {
+        return generator != nullptr && generator->impl->supports_jump_ahead() ? 1 : 0;
+    }
+
+    rng_status rng_generator_split(rng_generator *generator, uint64_t stride, size_t count, rng_generator **out)
+    {
+        return guarded([&]
+                       {
+            require(generator != nullptr && (out != nullptr || count == 0), "Null argument");
+            require(stride > 0, "Stride must be positive");
+
+            // Work on a copy so a failure leaves the parent untouched
+            std::unique_ptr<rng::RandomGenerator> cursor = generator->impl->clone();
+            std::vector<std::unique_ptr<rng::RandomGenerator>> children;
+            for (size_t i = 0; i < count; ++i)
+            {
+                children.push_back(cursor->clone());
+                cursor->jump_ahead(stride);
+            }
+            std::vector<rng_generator *> handles;
+            try
+            {
+                for (auto &child : children)
+                    handles.push_back(wrap(std::move(child)));
+            }
+            catch (...)
+            {
+                for (rng_generator *handle : handles)
+                    delete handle;
+                throw;
+            }
+            std::copy(handles.begin(), handles.end(), out);
+            generator->impl = std::move(cursor); });
+    }
+
+    rng_status rng_generator_get_state(const rng_generator *generator, uint64_t *state, size_t capacity,
+                                       size_t *words)
+    {
+        return guarded([&]
+                       {
+            require(generator != nullptr && words != nullptr, "Null argument");
+            std::vector<uint64_t> current = generator->impl->get_state();
+            *words = current.size();
+            if (capacity == 0 && state == nullptr)
+                return;
+            require(state != nullptr && capacity >= current.size(), "State buffer too small");
+            std::copy(current.begin(), current.end(), state); });
+    }
+
+    rng_status rng_generator_set_state(rng_generator *generator, const uint64_t *state, size_t words)
+    {
+        return guarded([&]
+                       {
+            require(generator != nullptr && (state != nullptr || words == 0), "Null argument");
+            generator->impl->set_state(std::vector<uint64_t>(state, state + words)); });
+    }
+
+    size_t rng_test_kind_count(void)
+    {
+        return std::size(TEST_KINDS);
+    }
+
+    const char *rng_test_kind_name(size_t index)
+    {
+        return index < std::size(TEST_KINDS) ? TEST_KINDS[index].key : nullptr;
+    }
+
+    rng_status rng_test_create(const char *kind, rng_test **out)
+    {
+        return guarded([&]
+                       {
+            require(kind != nullptr && out != nullptr, "Null argument");
+            *out = wrap(find_test_kind(kind).make()); });
+    }
+
+    rng_status rng_test_clone_empty(const rng_test *test, rng_test **out)
+    {
+        return guarded([&]
+                       {
+            require(test != nullptr && out != nullptr, "Null argument");
+            *out = wrap(test->impl->clone_empty()); });
+    }
+
+    void rng_test_destroy(rng_test *test)
+    {
+        delete test;
+    }
+
+    const char *rng_test_name(const rng_test *test)
+    {
+        return test != nullptr ? test->name.c_str() : nullptr;
+    }
+
+    rng_status rng_test_reset(rng_test *test)
+    {
+        return guarded([&]
+                       {
+            require(test != nullptr, "Null test");
+            test->impl->reset(); });
+    }
+
+    rng_status rng_test_update(rng_test *test, const double *numbers, size_t count)
+    {
+        return guarded([&]
+                       {
+            require(test != nullptr && (numbers != nullptr || count == 0), "Null argument");
+            test->impl->update(numbers, count); });
+    }
+
+    rng_status rng_test_merge(rng_test *test, const rng_test *other)
+    {
+        return guarded([&]
+                       {
+            require(test != nullptr && other != nullptr, "Null argument");
+            require(test->impl->get_config() == other->impl->get_config(),
+                    "Cannot merge tests of different kinds or parameters");
+            test->impl->merge(*other->impl); });
+    }
+
+    rng_status rng_test_evaluate(rng_test *test, double significance_level, double *p_value, int *passed)
+    {
+        return guarded([&]
+                       {
+            require(test != nullptr, "Null test");
+            require(significance_level > 0.0 && significance_level < 1.0,
+                    "Significance level must be in (0, 1)");
+            bool verdict = test->impl->evaluate(significance_level);
+            test->result = test->impl->get_test_result();
+            if (p_value != nullptr)
+                *p_value = test->impl->get_p_value();
+            if (passed != nullptr)
+                *passed = verdict ? 1 : 0; });
+    }
+
+    const char *rng_test_result(rng_test *test)
+    {
+        return test != nullptr ? test->result.c_str() : nullptr;
+    }
+
+    rng_status rng_test_save_state(const rng_test *test, void *buffer, size_t capacity, size_t *size)
+    {
+        return guarded([&]
+                       {
+            require(test != nullptr && size != nullptr, "Null argument");
+            rng::BinaryWriter writer;
+            test->impl->save_state(writer);
+            const std::string &data = writer.data();
+            *size = data.size();
+            if (capacity == 0 && buffer == nullptr)
+                return;
+            require(buffer != nullptr && capacity >= data.size(), "State buffer too small");
+            std::memcpy(buffer, data.data(), data.size()); });
+    }
+
+    rng_status rng_test_load_state(rng_test *test, const void *buffer, size_t size)
+    {
+        return guarded([&]
+                       {
+            require(test != nullptr && (buffer != nullptr || size == 0), "Null argument");
+            std::string data(static_cast<const char *>(buffer), size);
+            rng::BinaryReader reader(data);
+            test->impl->load_state(reader); });
+    }
+
+} // extern "C"
@@ -0,0 +1,614 @@
+#include "../../include/distributions/distributions.hpp"
+#include "../../include/tests/statistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Layer boundaries of a Ziggurat for a decreasing density f on
+        // [0, inf): x[0] = v / f(r) is the width of the base layer (which
+        // also covers the tail), x[1] = r, each layer has area v, x[n] = 0
+        struct ZigguratTable
+        {
+            size_t layers;
+            double r;
+            std::vector<double> x;
+            std::vector<double> f; // f(x[i])
+        };
+
+        template <typename Density, typename Inverse>
+        ZigguratTable make_ziggurat(size_t layers, double r, double v, Density f, Inverse inverse)
+        {
+            ZigguratTable table{layers, r, std::vector<double>(layers + 1), std::vector<double>(layers + 1)};
+            table.x[0] = v / f(r);
+            table.x[1] = r;
+            for (size_t i = 2; i < layers; ++i)
+            {
+                table.x[i] = inverse(v / table.x[i - 1] + f(table.x[i - 1]));
+            }
+            table.x[layers] = 0.0;
+            for (size_t i = 0; i <= layers; ++i)
+            {
+                table.f[i] = f(table.x[i]);
+            }
+            return table;
+        }
+
+        // Marsaglia and Tsang's constants for 128 normal and 256 exponential layers
+        const ZigguratTable &normal_table()
+        {
+            static const ZigguratTable table = make_ziggurat(
+                128, 3.442619855899, 9.91256303526217e-3,
+                [](double x)
+                { return std::exp(-0.5 * x * x); },
+                [](double y)
+                { return std::sqrt(-2.0 * std::log(y)); });
+            return table;
+        }
+
+        const ZigguratTable &exponential_table()
+        {
+            static const ZigguratTable table = make_ziggurat(
+                256, 7.69711747013104972, 3.949659822581572e-3,
+                [](double x)
+                { return std::exp(-x); },
+                [](double y)
+                { return -std::log(y); });
+            return table;
+        }
+
+        // Index u * n in [0, n). Generators that divide a raw value wider than
+        // 53 bits can round up to exactly 1.0, which must not pick index n.
+        inline size_t bucket(double u, size_t n)
+        {
+            return std::min(static_cast<size_t>(u * n), n - 1);
+        }
+
+        // Uniform in (0, 1], safe to take the logarithm of
+        double open_uniform(RandomGenerator &generator)
+        {
+            return 1.0 - generator.generate();
+        }
+
+        // Completes a normal draw that missed the fast rectangle test:
+        // tail for the base layer, wedge test otherwise
+        bool normal_slow_path(const ZigguratTable &t, size_t layer, double x, RandomGenerator &generator, double &result)
+        {
+            if (layer == 0)
+            {
+                double a;
+                double b;
+                do
+                {
+                    a = -std::log(open_uniform(generator)) / t.r;
+                    b = -std::log(open_uniform(generator));
+                } while (2.0 * b < a * a);
+                result = t.r + a;
+                return true;
+            }
+            double y = t.f[layer] + generator.generate() * (t.f[layer + 1] - t.f[layer]);
+            result = x;
+            return y < std::exp(-0.5 * x * x);
+        }
+
+        double standard_normal(RandomGenerator &generator)
+        {
+            const ZigguratTable &t = normal_table();
+            while (true)
+            {
+                // One uniform picks the layer and the sign
+                size_t bits = bucket(generator.generate(), 2 * t.layers);
+                size_t layer = bits >> 1;
+                double sign = (bits & 1) ? -1.0 : 1.0;
+                double x = generator.generate() * t.x[layer];
+                if (x < t.x[layer + 1])
+                    return sign * x;
+                double result;
+                if (normal_slow_path(t, layer, x, generator, result))
+                    return sign * result;
+            }
+        }
+
+        bool exponential_slow_path(const ZigguratTable &t, size_t layer, double x, RandomGenerator &generator, double &result)
+        {
+            if (layer == 0)
+            {
+                result = t.r - std::log(open_uniform(generator));
+                return true;
+            }
+            double y = t.f[layer] + generator.generate() * (t.f[layer + 1] - t.f[layer]);
+            result = x;
+            return y < std::exp(-x);
+        }
+
+        double standard_exponential(RandomGenerator &generator)
+        {
+            const ZigguratTable &t = exponential_table();
+            while (true)
+            {
+                size_t layer = bucket(generator.generate(), t.layers);
+                double x = generator.generate() * t.x[layer];
+                if (x < t.x[layer + 1])
+                    return x;
+                double result;
+                if (exponential_slow_path(t, layer, x, generator, result))
+                    return result;
+            }
+        }
+
+        constexpr double REJECTED = std::numeric_limits<double>::quiet_NaN();
+    } // namespace
+
+    void Distribution::sample_batch(RandomGenerator &generator, double *out, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = sample(generator);
+        }
+    }
+
+    // Normal Distribution Implementation
+    NormalDistribution::NormalDistribution(double mean, double stddev)
+        : mean_(mean), stddev_(stddev)
+    {
+        if (!(stddev_ > 0.0))
+        {
+            throw std::invalid_argument("Standard deviation must be positive");
+        }
+        normal_table();
+    }
+
+    double NormalDistribution::sample(RandomGenerator &generator)
+    {
+        return mean_ + stddev_ * standard_normal(generator);
+    }
+
+    void NormalDistribution::sample_batch(RandomGenerator &generator, double *out, size_t count)
+    {
+        const ZigguratTable &t = normal_table();
+        uniforms_.resize(2 * count);
+        generator.fill(uniforms_.data(), 2 * count);
+
+        // Fast rectangle test for the whole block, no branches
+        const double *u = uniforms_.data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t bits = bucket(u[2 * i], 2 * t.layers);
+            size_t layer = bits >> 1;
+            double x = u[2 * i + 1] * t.x[layer];
+            double z = (bits & 1) ? -x : x;
+            out[i] = x < t.x[layer + 1] ? mean_ + stddev_ * z : REJECTED;
+        }
+
+        // About 1% of draws fall outside the rectangles
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!std::isnan(out[i]))
+                continue;
+            size_t bits = bucket(u[2 * i], 2 * t.layers);
+            size_t layer = bits >> 1;
+            double sign = (bits & 1) ? -1.0 : 1.0;
+            double result;
+            double z = normal_slow_path(t, layer, u[2 * i + 1] * t.x[layer], generator, result)
+                           ? sign * result
+                           : standard_normal(generator);
+            out[i] = mean_ + stddev_ * z;
+        }
+    }
+
+    double NormalDistribution::cdf(double x) const
+    {
+        return normal_cdf((x - mean_) / stddev_);
+    }
+
+    std::string NormalDistribution::get_name() const
+    {
+        std::stringstream ss;
+        ss << "Normal(" << mean_ << ", " << stddev_ << ")";
+        return ss.str();
+    }
+
+    std::unique_ptr<Distribution> NormalDistribution::clone() const
+    {
+        return std::make_unique<NormalDistribution>(mean_, stddev_);
+    }
+
+    // Exponential Distribution Implementation
+    ExponentialDistribution::ExponentialDistribution(double rate)
+        : rate_(rate)
+    {
+        if (!(rate_ > 0.0))
+        {
+            throw std::invalid_argument("Rate must be positive");
+        }
+        exponential_table();
+    }
+
+    double ExponentialDistribution::sample(RandomGenerator &generator)
+    {
+        return standard_exponential(generator) / rate_;
+    }
+
+    void ExponentialDistribution::sample_batch(RandomGenerator &generator, double *out, size_t count)
+    {
+        const ZigguratTable &t = exponential_table();
+        uniforms_.resize(2 * count);
+        generator.fill(uniforms_.data(), 2 * count);
+
+        const double *u = uniforms_.data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t layer = bucket(u[2 * i], t.layers);
+            double x = u[2 * i + 1] * t.x[layer];
+            out[i] = x < t.x[layer + 1] ? x / rate_ : REJECTED;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!std::isnan(out[i]))
+                continue;
+            size_t layer = bucket(u[2 * i], t.layers);
+            double result;
+            if (!exponential_slow_path(t, layer, u[2 * i + 1] * t.x[layer], generator, result))
+                result = standard_exponential(generator);
+            out[i] = result / rate_;
+        }
+    }
+
+    double ExponentialDistribution::cdf(double x) const
+    {
+        return x <= 0.0 ? 0.0 : -std::expm1(-rate_ * x);
+    }
+
+    std::string ExponentialDistribution::get_name() const
+    {
+        std::stringstream ss;
+        ss << "Exponential(" << rate_ << ")";
+        return ss.str();
+    }
+
+    std::unique_ptr<Distribution> ExponentialDistribution::clone() const
+    {
+        return std::make_unique<ExponentialDistribution>(rate_);
+    }
+
+    // Gamma Distribution Implementation
+    GammaDistribution::GammaDistribution(double shape, double scale)
+        : shape_(shape), scale_(scale)
+    {
+        if (!(shape_ > 0.0) || !(scale_ > 0.0))
+        {
+            throw std::invalid_argument("Shape and scale must be positive");
+        }
+    }
+
+    double GammaDistribution::sample(RandomGenerator &generator)
+    {
+        double value = marsaglia_tsang(generator);
+        if (shape_ < 1.0)
+            value *= std::pow(open_uniform(generator), 1.0 / shape_);
+        return value * scale_;
+    }
+
+    void GammaDistribution::sample_batch(RandomGenerator &generator, double *out, size_t count)
+    {
+        const double d = squeeze_shape() - 1.0 / 3.0;
+        const double c = 1.0 / std::sqrt(9.0 * d);
+        normals_.resize(count);
+        normal_.sample_batch(generator, normals_.data(), count);
+        uniforms_.resize(count);
+        generator.fill(uniforms_.data(), count);
+
+        // Squeeze test for the whole block, no branches
+        const double *x = normals_.data();
+        const double *u = uniforms_.data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            double v = 1.0 + c * x[i];
+            double v3 = v * v * v;
+            double x2 = x[i] * x[i];
+            bool accept = v > 0.0 && 1.0 - u[i] < 1.0 - 0.0331 * x2 * x2;
+            out[i] = accept ? d * v3 : REJECTED;
+        }
+
+        // The squeeze takes about 98% of the candidates; the rest get the
+        // exact log test on the same pair and a fresh draw if that fails too
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!std::isnan(out[i]))
+                continue;
+            double v = 1.0 + c * x[i];
+            double v3 = v * v * v;
+            double x2 = x[i] * x[i];
+            if (v > 0.0 && std::log(1.0 - u[i]) < 0.5 * x2 + d * (1.0 - v3 + std::log(v3)))
+                out[i] = d * v3;
+            else
+                out[i] = marsaglia_tsang(generator);
+        }
+
+        if (shape_ < 1.0)
+        {
+            generator.fill(uniforms_.data(), count);
+            for (size_t i = 0; i < count; ++i)
+                out[i] *= std::pow(1.0 - uniforms_[i], 1.0 / shape_);
+        }
+        for (size_t i = 0; i < count; ++i)
+            out[i] *= scale_;
+    }
+
+    double GammaDistribution::squeeze_shape() const
+    {
+        return shape_ < 1.0 ? shape_ + 1.0 : shape_;
+    }
+
+    double GammaDistribution::marsaglia_tsang(RandomGenerator &generator)
+    {
+        double d = squeeze_shape() - 1.0 / 3.0;
+        double c = 1.0 / std::sqrt(9.0 * d);
+        while (true)
+        {
+            double x = normal_.sample(generator);
+            double v = 1.0 + c * x;
+            if (v <= 0.0)
+                continue;
+            v = v * v * v;
+            double u = open_uniform(generator);
+            double x2 = x * x;
+            if (u < 1.0 - 0.0331 * x2 * x2 || std::log(u) < 0.5 * x2 + d * (1.0 - v + std::log(v)))
+                return d * v;
+        }
+    }
+
+    double GammaDistribution::cdf(double x) const
+    {
+        return x <= 0.0 ? 0.0 : regularized_gamma_p(shape_, x / scale_);
+    }
+
+    std::string GammaDistribution::get_name() const
+    {
+        std::stringstream ss;
+        ss << "Gamma(" << shape_ << ", " << scale_ << ")";
+        return ss.str();
+    }
+
+    std::unique_ptr<Distribution> GammaDistribution::clone() const
+    {
+        return std::make_unique<GammaDistribution>(shape_, scale_);
+    }
+
+    // Alias Table Implementation
+    void AliasTableDistribution::build(double mean, double stddev, uint64_t support_max)
+    {
+        constexpr uint64_t MAX_TABLE_SIZE = 1 << 24;
+        double spread = 10.0 * stddev + 10.0;
+        double low = std::max(0.0, std::floor(mean - spread));
+        double high = std::min(static_cast<double>(support_max), std::ceil(mean + spread));
+        if (high - low + 1.0 > MAX_TABLE_SIZE)
+        {
+            throw std::invalid_argument("Distribution is too wide for a sampling table");
+        }
+        first_ = static_cast<uint64_t>(low);
+        support_max_ = support_max;
+        size_t size = static_cast<size_t>(high - low) + 1;
+
+        // Tail masses by walking outwards until the terms vanish
+        std::vector<double> probabilities(size);
+        for (size_t j = 0; j < size; ++j)
+            probabilities[j] = std::exp(log_pmf(first_ + j));
+        lower_tail_ = 0.0;
+        for (uint64_t k = first_; k-- > 0;)
+        {
+            double term = std::exp(log_pmf(k));
+            lower_tail_ += term;
+            if (term < 1e-30 * lower_tail_ || term == 0.0)
+                break;
+        }
+        upper_tail_ = 0.0;
+        for (uint64_t k = first_ + size; k <= support_max_ && k != 0; ++k)
+        {
+            double term = std::exp(log_pmf(k));
+            upper_tail_ += term;
+            if (term < 1e-30 * upper_tail_ || term == 0.0)
+                break;
+        }
+
+        double total = lower_tail_ + upper_tail_;
+        for (double p : probabilities)
+            total += p;
+        for (double &p : probabilities)
+            p /= total;
+        lower_tail_ /= total;
+        upper_tail_ /= total;
+
+        cumulative_.resize(size);
+        double running = lower_tail_;
+        for (size_t j = 0; j < size; ++j)
+        {
+            running += probabilities[j];
+            cumulative_[j] = std::min(running, 1.0);
+        }
+
+        // Vose's construction; outcomes size and size + 1 are the two tails
+        probabilities.push_back(lower_tail_);
+        probabilities.push_back(upper_tail_);
+        size_t n = probabilities.size();
+        accept_.assign(n, 1.0);
+        alias_.resize(n);
+        std::vector<uint32_t> small;
+        std::vector<uint32_t> large;
+        std::vector<double> scaled(n);
+        for (size_t j = 0; j < n; ++j)
+        {
+            alias_[j] = static_cast<uint32_t>(j);
+            scaled[j] = probabilities[j] * n;
+            (scaled[j] < 1.0 ? small : large).push_back(static_cast<uint32_t>(j));
+        }
+        while (!small.empty() && !large.empty())
+        {
+            uint32_t s = small.back();
+            small.pop_back();
+            uint32_t l = large.back();
+            accept_[s] = scaled[s];
+            alias_[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0)
+            {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+    }
+
+    double AliasTableDistribution::sample_tail(bool upper, double u) const
+    {
+        double target = u * (upper ? upper_tail_ : lower_tail_);
+        double sum = 0.0;
+        if (upper)
+        {
+            uint64_t k = first_ + cumulative_.size();
+            for (; k < support_max_; ++k)
+            {
+                double term = std::exp(log_pmf(k));
+                sum += term;
+                if (sum >= target || term == 0.0)
+                    break;
+            }
+            return static_cast<double>(k);
+        }
+        uint64_t k = first_ - 1;
+        for (; k > 0; --k)
+        {
+            double term = std::exp(log_pmf(k));
+            sum += term;
+            if (sum >= target || term == 0.0)
+                break;
+        }
+        return static_cast<double>(k);
+    }
+
+    double AliasTableDistribution::resolve(size_t outcome, RandomGenerator &generator) const
+    {
+        size_t size = cumulative_.size();
+        if (outcome < size)
+            return static_cast<double>(first_ + outcome);
+        return sample_tail(outcome == size + 1, generator.generate());
+    }
+
+    double AliasTableDistribution::sample(RandomGenerator &generator)
+    {
+        double scaled = generator.generate() * accept_.size();
+        size_t column = std::min(static_cast<size_t>(scaled), accept_.size() - 1);
+        size_t outcome = scaled - column < accept_[column] ? column : alias_[column];
+        return resolve(outcome, generator);
+    }
+
+    void AliasTableDistribution::sample_batch(RandomGenerator &generator, double *out, size_t count)
+    {
+        const size_t n = accept_.size();
+        const size_t size = cumulative_.size();
+        uniforms_.resize(count);
+        generator.fill(uniforms_.data(), count);
+
+        // Column pick and alias choice for the whole block, no branches
+        for (size_t i = 0; i < count; ++i)
+        {
+            double scaled = uniforms_[i] * n;
+            size_t column = std::min(static_cast<size_t>(scaled), n - 1);
+            size_t outcome = scaled - column < accept_[column] ? column : alias_[column];
+            out[i] = outcome < size ? static_cast<double>(first_ + outcome) : -1.0 - (outcome - size);
+        }
+
+        // Tail outcomes (negative markers) are resolved afterwards
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (out[i] < 0.0)
+                out[i] = sample_tail(out[i] < -1.5, generator.generate());
+        }
+    }
+
+    double AliasTableDistribution::cdf(double x) const
+    {
+        if (x < static_cast<double>(first_))
+            return x < 0.0 ? 0.0 : lower_tail_;
+        double offset = std::floor(x) - static_cast<double>(first_);
+        if (offset >= static_cast<double>(cumulative_.size()))
+            return 1.0;
+        return cumulative_[static_cast<size_t>(offset)];
+    }
+
+    // Poisson Distribution Implementation
+    PoissonDistribution::PoissonDistribution(double mean)
+        : mean_(mean)
+    {
+        if (!(mean_ > 0.0))
+        {
+            throw std::invalid_argument("Poisson mean must be positive");
+        }
+        build(mean_, std::sqrt(mean_), std::numeric_limits<uint64_t>::max());
+    }
+
+    double PoissonDistribution::log_pmf(uint64_t k) const
+    {
+        double kd = static_cast<double>(k);
+        return kd * std::log(mean_) - mean_ - std::lgamma(kd + 1.0);
+    }
+
+    std::string PoissonDistribution::get_name() const
+    {
+        std::stringstream ss;
+        ss << "Poisson(" << mean_ << ")";
+        return ss.str();
+    }
+
+    std::unique_ptr<Distribution> PoissonDistribution::clone() const
+    {
+        return std::make_unique<PoissonDistribution>(*this);
+    }
+
+    // Binomial Distribution Implementation
+    BinomialDistribution::BinomialDistribution(uint64_t trials, double probability)
+        : trials_(trials), probability_(probability)
+    {
+        if (!(probability_ >= 0.0 && probability_ <= 1.0))
+        {
+            throw std::invalid_argument("Probability must be between 0 and 1");
+        }
+        double n = static_cast<double>(trials_);
+        build(n * probability_, std::sqrt(n * probability_ * (1.0 - probability_)), trials_);
+    }
+
+    double BinomialDistribution::log_pmf(uint64_t k) const
+    {
+        if (k > trials_)
+            return -std::numeric_limits<double>::infinity();
+        // Degenerate cases would otherwise produce 0 * log(0)
+        if (probability_ == 0.0 || probability_ == 1.0)
+        {
+            uint64_t certain = probability_ == 0.0 ? 0 : trials_;
+            return k == certain ? 0.0 : -std::numeric_limits<double>::infinity();
+        }
+        double n = static_cast<double>(trials_);
+        double kd = static_cast<double>(k);
+        return std::lgamma(n + 1.0) - std::lgamma(kd + 1.0) - std::lgamma(n - kd + 1.0) +
+               kd * std::log(probability_) + (n - kd) * std::log1p(-probability_);
+    }
+
+    std::string BinomialDistribution::get_name() const
+    {
+        std::stringstream ss;
+        ss << "Binomial(" << trials_ << ", " << probability_ << ")";
+        return ss.str();
+    }
+
+    std::unique_ptr<Distribution> BinomialDistribution::clone() const
+    {
+        return std::make_unique<BinomialDistribution>(*this);
+    }
+
+} // namespace rng
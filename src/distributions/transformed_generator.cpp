@@ -0,0 +1,106 @@
+#include "../../include/distributions/transformed_generator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Variates transformed per fill() block
+        constexpr size_t BLOCK_SIZE = 4096;
+    } // namespace
+
+    TransformedGenerator::TransformedGenerator(std::unique_ptr<RandomGenerator> base,
+                                               std::unique_ptr<Distribution> distribution)
+        : base_(std::move(base)), distribution_(std::move(distribution))
+    {
+        if (!base_ || !distribution_)
+        {
+            throw std::invalid_argument("Transformed generator needs a generator and a distribution");
+        }
+    }
+
+    TransformedGenerator::TransformedGenerator(const TransformedGenerator &other)
+        : base_(other.base_->clone()), distribution_(other.distribution_->clone())
+    {
+    }
+
+    double TransformedGenerator::to_uniform(double variate, double offset) const
+    {
+        double upper = distribution_->cdf(variate);
+        if (!distribution_->is_discrete())
+            return std::min(upper, std::nextafter(1.0, 0.0));
+        double lower = distribution_->cdf(variate - 1.0);
+        return std::min(lower + offset * (upper - lower), std::nextafter(1.0, 0.0));
+    }
+
+    double TransformedGenerator::generate()
+    {
+        double variate = distribution_->sample(*base_);
+        double offset = distribution_->is_discrete() ? base_->generate() : 0.0;
+        return to_uniform(variate, offset);
+    }
+
+    std::vector<double> TransformedGenerator::generate_sequence(size_t count)
+    {
+        std::vector<double> sequence(count);
+        fill(sequence.data(), count);
+        return sequence;
+    }
+
+    void TransformedGenerator::fill(double *out, size_t count)
+    {
+        bool discrete = distribution_->is_discrete();
+        for (size_t done = 0; done < count; done += BLOCK_SIZE)
+        {
+            size_t length = std::min(BLOCK_SIZE, count - done);
+            variates_.resize(length);
+            distribution_->sample_batch(*base_, variates_.data(), length);
+            offsets_.assign(length, 0.0);
+            if (discrete)
+                base_->fill(offsets_.data(), length);
+            for (size_t i = 0; i < length; ++i)
+            {
+                out[done + i] = to_uniform(variates_[i], offsets_[i]);
+            }
+        }
+    }
+
+    std::string TransformedGenerator::get_name() const
+    {
+        return distribution_->get_name() + " via " + base_->get_name();
+    }
+
+    void TransformedGenerator::set_seed(uint64_t seed)
+    {
+        base_->set_seed(seed);
+    }
+
+    uint64_t TransformedGenerator::generate_raw()
+    {
+        return static_cast<uint64_t>(generate() * 4294967296.0);
+    }
+
+    unsigned TransformedGenerator::raw_bits() const
+    {
+        return 32;
+    }
+
+    std::unique_ptr<RandomGenerator> TransformedGenerator::clone() const
+    {
+        return std::make_unique<TransformedGenerator>(*this);
+    }
+
+    std::vector<uint64_t> TransformedGenerator::get_state() const
+    {
+        return base_->get_state();
+    }
+
+    void TransformedGenerator::set_state(const std::vector<uint64_t> &state)
+    {
+        base_->set_state(state);
+    }
+
+} // namespace rng
@@ -0,0 +1,368 @@
+#include "../../include/engine/battery.hpp"
+#include "../../include/bench/benchmark.hpp"
+#include "../../include/engine/result_cache.hpp"
+#include "../../include/generators/mcg.hpp"
+#include "../../include/tests/randomness_tests.hpp"
+#include "../../include/tests/knuth_tests.hpp"
+#include "../../include/tests/overlapping_serial_test.hpp"
+#include "../../include/tests/edf_tests.hpp"
+#include "../../include/utils/parallel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+namespace rng
+{
+
+    namespace
+    {
+        using clock = std::chrono::steady_clock;
+
+        double seconds_since(clock::time_point start)
+        {
+            return std::chrono::duration<double>(clock::now() - start).count();
+        }
+
+        template <typename Test, typename... Args>
+        BatteryEntry entry(std::string label, size_t sample_size, double power, Args... args)
+        {
+            BatteryEntry e;
+            e.label = std::move(label);
+            e.make = [args...]()
+            { return std::unique_ptr<RandomnessTest>(std::make_unique<Test>(args...)); };
+            e.sample_size = sample_size;
+            e.power = power;
+            return e;
+        }
+
+        // Tests with their own threads get one: the battery spreads entries over the cores
+        void add_core_entries(Battery &battery, size_t n)
+        {
+            battery.entries.push_back(entry<RunsTest>("Runs", n, 2.0));
+            battery.entries.push_back(entry<RunsUpDownTest>("Runs up, lengths", n, 3.0, RunDirection::Up, size_t(1)));
+            battery.entries.push_back(entry<RunsUpDownTest>("Runs down, lengths", n, 3.0, RunDirection::Down, size_t(1)));
+            battery.entries.push_back(entry<SerialCorrelationTest>("Serial correlation", n, 1.0));
+            battery.entries.push_back(entry<GapTest>("Gap [0, 0.5)", n, 2.0, 0.0, 0.5, size_t(10)));
+            battery.entries.push_back(entry<PokerTest>("Poker, 10 digits, hands of 5", n, 2.0, size_t(10), size_t(5)));
+            battery.entries.push_back(entry<CouponCollectorTest>("Coupon collector, 5 digits", n, 2.0, size_t(5), size_t(30)));
+            battery.entries.push_back(entry<MaximumOfTTest>("Maximum of 5", n, 2.0, size_t(5), size_t(10)));
+            battery.entries.push_back(entry<KolmogorovSmirnovTest>("Kolmogorov-Smirnov", n, 1.0,
+                                                                   EdfMode::Exact, size_t(1) << 20, size_t(1)));
+        }
+
+        // Estimated seconds of the busiest worker when `chosen` is packed by
+        // the LPT rule; fills `worker` for each chosen entry if given
+        double lpt_makespan(std::vector<size_t> chosen, const std::vector<double> &estimates, size_t workers,
+                            std::vector<size_t> *worker)
+        {
+            std::sort(chosen.begin(), chosen.end(), [&estimates](size_t a, size_t b)
+                      { return estimates[a] > estimates[b]; });
+            std::vector<double> loads(workers, 0.0);
+            for (size_t i : chosen)
+            {
+                size_t least = std::min_element(loads.begin(), loads.end()) - loads.begin();
+                loads[least] += estimates[i];
+                if (worker != nullptr)
+                    (*worker)[i] = least;
+            }
+            return *std::max_element(loads.begin(), loads.end());
+        }
+
+        std::string status_to_string(BatteryStatus status)
+        {
+            switch (status)
+            {
+            case BatteryStatus::Passed:
+                return "PASS";
+            case BatteryStatus::Failed:
+                return "FAIL";
+            default:
+                return "skipped";
+            }
+        }
+    } // namespace
+
+    Battery make_battery(BatteryTier tier)
+    {
+        Battery battery;
+        switch (tier)
+        {
+        case BatteryTier::Quick:
+        {
+            const size_t n = 1 << 16;
+            battery.name = "Quick";
+            battery.entries.push_back(entry<ChiSquareTest>("Chi-square, 10 bins", n, 1.0, size_t(10)));
+            add_core_entries(battery, n);
+            battery.entries.push_back(entry<OverlappingSerialTest>("Overlapping pairs, 64 divisions", n, 3.0,
+                                                                   size_t(2), size_t(64), size_t(1)));
+            break;
+        }
+        case BatteryTier::Standard:
+        {
+            const size_t n = 1 << 20;
+            battery.name = "Standard";
+            battery.entries.push_back(entry<ChiSquareTest>("Chi-square, 100 bins", n, 1.0, size_t(100)));
+            add_core_entries(battery, n);
+            battery.entries.push_back(entry<GapTest>("Gap [0.9, 1)", n, 2.0, 0.9, 1.0, size_t(30)));
+            battery.entries.push_back(entry<PokerTest>("Poker, 4 digits, hands of 8", n, 2.0, size_t(4), size_t(8)));
+            battery.entries.push_back(entry<CouponCollectorTest>("Coupon collector, 10 digits", n, 2.0, size_t(10), size_t(60)));
+            battery.entries.push_back(entry<MaximumOfTTest>("Maximum of 10", n, 2.0, size_t(10), size_t(20)));
+            battery.entries.push_back(entry<OverlappingSerialTest>("Overlapping pairs, 256 divisions", n, 3.0,
+                                                                   size_t(2), size_t(256), size_t(1)));
+            battery.entries.push_back(entry<OverlappingSerialTest>("Overlapping triples, 32 divisions", n, 3.0,
+                                                                   size_t(3), size_t(32), size_t(1)));
+            battery.entries.push_back(entry<AndersonDarlingTest>("Anderson-Darling", n, 2.0,
+                                                                 EdfMode::Exact, size_t(1) << 20, size_t(1)));
+            break;
+        }
+        case BatteryTier::Exhaustive:
+        {
+            const size_t n = 1 << 24;
+            battery.name = "Exhaustive";
+            battery.entries.push_back(entry<ChiSquareTest>("Chi-square, 1000 bins", n, 1.0, size_t(1000)));
+            add_core_entries(battery, n);
+            battery.entries.push_back(entry<GapTest>("Gap [0.9, 1)", n, 2.0, 0.9, 1.0, size_t(30)));
+            battery.entries.push_back(entry<GapTest>("Gap [0, 0.05)", n, 2.0, 0.0, 0.05, size_t(100)));
+            battery.entries.push_back(entry<PokerTest>("Poker, 4 digits, hands of 8", n, 2.0, size_t(4), size_t(8)));
+            battery.entries.push_back(entry<PokerTest>("Poker, 8 digits, hands of 8", n, 2.0, size_t(8), size_t(8)));
+            battery.entries.push_back(entry<CouponCollectorTest>("Coupon collector, 10 digits", n, 2.0, size_t(10), size_t(60)));
+            battery.entries.push_back(entry<MaximumOfTTest>("Maximum of 10", n, 2.0, size_t(10), size_t(20)));
+            battery.entries.push_back(entry<MaximumOfTTest>("Maximum of 20", n, 2.0, size_t(20), size_t(50)));
+            battery.entries.push_back(entry<OverlappingSerialTest>("Overlapping pairs, 1024 divisions", n, 3.0,
+                                                                   size_t(2), size_t(1024), size_t(1)));
+            battery.entries.push_back(entry<OverlappingSerialTest>("Overlapping triples, 64 divisions", n, 3.0,
+                                                                   size_t(3), size_t(64), size_t(1)));
+            battery.entries.push_back(entry<OverlappingSerialTest>("Overlapping 4-tuples, 32 divisions", n, 3.0,
+                                                                   size_t(4), size_t(32), size_t(1)));
+            battery.entries.push_back(entry<OverlappingSerialTest>("Overlapping 5-tuples, 16 divisions", n, 3.0,
+                                                                   size_t(5), size_t(16), size_t(1)));
+            battery.entries.push_back(entry<AndersonDarlingTest>("Anderson-Darling", n, 2.0,
+                                                                 EdfMode::Exact, size_t(1) << 20, size_t(1)));
+            break;
+        }
+        }
+        return battery;
+    }
+
+    double CostModel::estimate_seconds(const BatteryEntry &entry, const std::string &test_name) const
+    {
+        auto found = test_ns.find(test_name);
+        double per_number = generator_ns + (found != test_ns.end() ? found->second : default_test_ns);
+        return per_number * entry.sample_size * 1e-9;
+    }
+
+    CostModel load_cost_model(const std::string &benchmark_csv, const std::string &generator_name)
+    {
+        CostModel costs;
+        std::map<std::string, size_t> largest;
+        size_t generator_size = 0;
+        for (const BenchmarkResult &result : read_benchmarks_csv(benchmark_csv))
+        {
+            if (result.group == "test" && result.variant == "run_test" && result.size >= largest[result.name])
+            {
+                largest[result.name] = result.size;
+                costs.test_ns[result.name] = result.median_ns;
+            }
+            else if (result.group == "generator" && result.name == generator_name && result.variant == "fill" &&
+                     result.size >= generator_size)
+            {
+                generator_size = result.size;
+                costs.generator_ns = result.median_ns;
+            }
+        }
+        return costs;
+    }
+
+    CostModel calibrate_cost_model(const Battery &battery, const RandomGenerator &generator, size_t calibration_size)
+    {
+        CostModel costs;
+        MCG source;
+        std::vector<double> numbers = source.generate_sequence(calibration_size);
+
+        // The first run of each test warms caches and allocations; the second is timed
+        for (const BatteryEntry &entry : battery.entries)
+        {
+            std::unique_ptr<RandomnessTest> test = entry.make();
+            std::string name = test->get_test_name();
+            if (costs.test_ns.count(name) > 0)
+                continue;
+            test->run_test(numbers, 0.01);
+            auto start = clock::now();
+            test->run_test(numbers, 0.01);
+            costs.test_ns[name] = seconds_since(start) * 1e9 / calibration_size;
+        }
+
+        std::unique_ptr<RandomGenerator> copy = generator.clone();
+        copy->fill(numbers.data(), numbers.size());
+        auto start = clock::now();
+        copy->fill(numbers.data(), numbers.size());
+        costs.generator_ns = seconds_since(start) * 1e9 / calibration_size;
+        return costs;
+    }
+
+    BatteryReport run_battery(const RandomGenerator &generator, const Battery &battery,
+                              const CostModel &costs, const BatteryOptions &options)
+    {
+        auto start = clock::now();
+        const size_t count = battery.entries.size();
+        const size_t workers = std::max<size_t>(1, std::min(count, options.num_threads == 0 ? default_thread_count()
+                                                                                            : options.num_threads));
+
+        BatteryReport report;
+        report.battery_name = battery.name;
+        report.cores = workers;
+        report.results.resize(count);
+        std::vector<double> estimates(count);
+        std::vector<double> priority(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const BatteryEntry &entry = battery.entries[i];
+            BatteryResult &result = report.results[i];
+            result.label = entry.label;
+            result.test_name = entry.make()->get_test_name();
+            result.sample_size = entry.sample_size;
+            result.estimated_seconds = estimates[i] = costs.estimate_seconds(entry, result.test_name);
+            priority[i] = entry.power / std::max(estimates[i], 1e-9);
+        }
+
+        std::vector<uint64_t> offsets(count, 0);
+        for (size_t i = 1; i < count; ++i)
+            offsets[i] = offsets[i - 1] + battery.entries[i - 1].sample_size;
+
+        // Entries answered by the cache are neither generated nor tested
+        std::vector<std::string> keys(count);
+        std::vector<bool> pending(count, true);
+        if (options.cache != nullptr)
+        {
+            std::string fingerprint = generator_fingerprint(generator);
+            for (size_t i = 0; i < count; ++i)
+            {
+                BatteryResult &result = report.results[i];
+                keys[i] = make_cache_key(fingerprint, offsets[i], result.sample_size,
+                                         battery.entries[i].make()->get_config(), options.significance_level);
+                CachedResult cached;
+                if (options.cache->lookup(keys[i], cached))
+                {
+                    result.status = cached.passed ? BatteryStatus::Passed : BatteryStatus::Failed;
+                    result.p_value = cached.p_value;
+                    result.cached = true;
+                    pending[i] = false;
+                }
+            }
+        }
+
+        // Without a fast jump, reaching the start of an entry means stepping
+        // over the numbers of all entries before it
+        auto planned_seconds = [&](const std::vector<size_t> &chosen, std::vector<size_t> *worker)
+        {
+            if (chosen.empty())
+                return 0.0;
+            double setup = 0.0;
+            if (!generator.supports_jump_ahead())
+                setup = costs.generator_ns * 1e-9 * offsets[*std::max_element(chosen.begin(), chosen.end())];
+            return setup + lpt_makespan(chosen, estimates, workers, worker);
+        };
+
+        // Most power per second first, keeping what still fits the budget
+        std::vector<size_t> by_priority(count);
+        std::iota(by_priority.begin(), by_priority.end(), 0);
+        std::stable_sort(by_priority.begin(), by_priority.end(), [&priority](size_t a, size_t b)
+                         { return priority[a] > priority[b]; });
+        std::vector<size_t> chosen;
+        for (size_t i : by_priority)
+        {
+            if (!pending[i])
+                continue;
+            chosen.push_back(i);
+            if (options.time_budget_seconds > 0.0 && planned_seconds(chosen, nullptr) > options.time_budget_seconds)
+                chosen.pop_back();
+        }
+
+        std::vector<size_t> worker(count);
+        report.planned_makespan = planned_seconds(chosen, &worker);
+        std::vector<std::vector<size_t>> queues(workers);
+        for (size_t i : by_priority)
+        {
+            if (std::find(chosen.begin(), chosen.end(), i) != chosen.end())
+                queues[worker[i]].push_back(i);
+        }
+
+        // Entry i starts where entries 0..i-1 end
+        std::vector<std::unique_ptr<RandomGenerator>> starts(count);
+        std::unique_ptr<RandomGenerator> cursor = generator.clone();
+        uint64_t position = 0;
+        std::vector<size_t> in_order = chosen;
+        std::sort(in_order.begin(), in_order.end());
+        for (size_t i : in_order)
+        {
+            cursor->jump_ahead(offsets[i] - position);
+            position = offsets[i];
+            starts[i] = cursor->clone();
+        }
+
+        parallel_for_shards(workers, workers, [&](size_t shard, size_t, size_t)
+                            {
+            for (size_t i : queues[shard])
+            {
+                BatteryResult &result = report.results[i];
+                result.core = shard;
+                if (options.time_budget_seconds > 0.0 && seconds_since(start) > options.time_budget_seconds)
+                    continue;
+
+                auto entry_start = clock::now();
+                std::vector<double> numbers = starts[i]->generate_sequence(battery.entries[i].sample_size);
+                std::unique_ptr<RandomnessTest> test = battery.entries[i].make();
+                bool passed = test->run_test(numbers, options.significance_level);
+                result.status = passed ? BatteryStatus::Passed : BatteryStatus::Failed;
+                result.p_value = test->get_p_value();
+                result.actual_seconds = seconds_since(entry_start);
+                if (options.cache != nullptr)
+                    options.cache->store(keys[i], CachedResult{result.p_value, passed, result.actual_seconds});
+            } });
+
+        report.elapsed_seconds = seconds_since(start);
+        return report;
+    }
+
+    std::string format_battery(const BatteryReport &report)
+    {
+        size_t passed = 0, failed = 0, skipped = 0, cached = 0;
+        std::stringstream ss;
+        ss << std::left << std::setw(38) << "Test" << std::right << std::setw(10) << "Numbers"
+           << std::setw(10) << "Verdict" << std::setw(12) << "P-value" << std::setw(10) << "Est. s"
+           << std::setw(10) << "Actual s" << std::setw(8) << "Core" << "\n";
+        for (const BatteryResult &result : report.results)
+        {
+            ss << std::left << std::setw(38) << result.label << std::right << std::setw(10) << result.sample_size
+               << std::setw(10) << status_to_string(result.status);
+            if (result.status == BatteryStatus::Skipped)
+            {
+                ss << std::setw(12) << "-" << std::fixed << std::setprecision(3) << std::setw(10)
+                   << result.estimated_seconds << std::setw(10) << "-" << std::setw(8) << "-" << "\n";
+                ++skipped;
+                continue;
+            }
+            ss << std::scientific << std::setprecision(3) << std::setw(12) << result.p_value << std::fixed
+               << std::setw(10) << result.estimated_seconds;
+            if (result.cached)
+            {
+                ss << std::setw(10) << "cached" << std::setw(8) << "-" << "\n";
+                ++cached;
+            }
+            else
+            {
+                ss << std::setw(10) << result.actual_seconds << std::setw(8) << result.core << "\n";
+            }
+            (result.status == BatteryStatus::Passed ? passed : failed)++;
+        }
+        ss << std::defaultfloat << "\n"
+           << report.battery_name << " battery: " << passed << " passed, " << failed << " failed, "
+           << skipped << " skipped, " << cached << " answered from the cache; " << report.cores
+           << " workers, planned makespan " << std::fixed << std::setprecision(2) << report.planned_makespan << " s, elapsed "
+           << report.elapsed_seconds << " s\n";
+        return ss.str();
+    }
+
+} // namespace rng
@@ -0,0 +1,293 @@
+#include "../../include/engine/checkpoint.hpp"
+#include "../../include/engine/fused_runner.hpp"
+#include "../../include/engine/result_cache.hpp"
+#include "../../include/utils/instrumentation.hpp"
+#include "../../include/utils/parallel.hpp"
+#include "../../include/utils/serialization.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace rng
+{
+
+    namespace
+    {
+        const std::string CHECKPOINT_MAGIC = "RNGCKPT2";
+        // Numbers generated per block between calls to the tests
+        constexpr size_t BLOCK_SIZE = 1 << 20;
+
+        // FNV-1a, enough to tell a damaged file from a good one
+        uint64_t checksum(const std::string &data)
+        {
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            for (char c : data)
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 0x100000001b3ULL;
+            }
+            return hash;
+        }
+
+        void write_durably(const std::string &path, const std::string &data)
+        {
+            static const ProbeId probe = RNG_PROBE("io.checkpoint_write");
+            RNG_TIMED_SCOPE(probe, data.size());
+#ifndef _WIN32
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Cannot create " + path);
+            }
+            size_t written = 0;
+            while (written < data.size())
+            {
+                ssize_t count = ::write(fd, data.data() + written, data.size() - written);
+                if (count < 0)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot write " + path);
+                }
+                written += static_cast<size_t>(count);
+            }
+            bool synced = ::fsync(fd) == 0;
+            if (::close(fd) != 0 || !synced)
+            {
+                throw std::runtime_error("Cannot flush " + path);
+            }
+#else
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            file.close();
+            if (!file)
+            {
+                throw std::runtime_error("Cannot write " + path);
+            }
+#endif
+        }
+
+        // Makes a rename in the directory of `path` durable
+        void sync_directory(const std::string &path)
+        {
+#ifndef _WIN32
+            size_t slash = path.find_last_of('/');
+            std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+            int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Cannot open " + directory);
+            }
+            bool synced = ::fsync(fd) == 0;
+            if (::close(fd) != 0 || !synced)
+            {
+                throw std::runtime_error("Cannot flush " + directory);
+            }
+#else
+            (void)path;
+#endif
+        }
+
+        void expect_end(const BinaryReader &reader, const std::string &what)
+        {
+            if (!reader.at_end())
+            {
+                throw std::runtime_error(what + " has trailing bytes");
+            }
+        }
+    } // namespace
+
+    void write_checkpoint(const std::string &path, const Checkpoint &checkpoint)
+    {
+        BinaryWriter payload;
+        payload.write_string(checkpoint.generator_name);
+        payload.write_string(checkpoint.generator_start);
+        payload.write_u64_vector(checkpoint.generator_state);
+        payload.write_u64(checkpoint.total_numbers);
+        payload.write_u64(checkpoint.numbers_done);
+        payload.write_u64(checkpoint.num_threads);
+        payload.write_u64(checkpoint.test_configs.size());
+        for (size_t i = 0; i < checkpoint.test_configs.size(); ++i)
+        {
+            payload.write_string(checkpoint.test_configs[i]);
+            payload.write_string(checkpoint.test_states[i]);
+        }
+
+        BinaryWriter file;
+        file.write_u64(checksum(payload.data()));
+        file.write_string(payload.data());
+
+        std::string temporary = path + ".tmp";
+        write_durably(temporary, CHECKPOINT_MAGIC + file.data());
+#ifdef _WIN32
+        std::remove(path.c_str());
+#endif
+        if (std::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            throw std::runtime_error("Cannot replace " + path);
+        }
+        sync_directory(path);
+    }
+
+    bool read_checkpoint(const std::string &path, Checkpoint &checkpoint)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        std::string contents;
+        {
+            static const ProbeId probe = RNG_PROBE("io.checkpoint_read");
+            RNG_TIMED_SCOPE(probe, 0);
+            contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        if (contents.compare(0, CHECKPOINT_MAGIC.size(), CHECKPOINT_MAGIC) != 0)
+        {
+            throw std::runtime_error(path + " is not a checkpoint file");
+        }
+        contents.erase(0, CHECKPOINT_MAGIC.size());
+
+        BinaryReader reader(contents);
+        uint64_t expected_checksum = reader.read_u64();
+        std::string payload_data = reader.read_string();
+        expect_end(reader, "Checkpoint " + path);
+        if (checksum(payload_data) != expected_checksum)
+        {
+            throw std::runtime_error("Checkpoint " + path + " is damaged");
+        }
+
+        BinaryReader payload(payload_data);
+        checkpoint.generator_name = payload.read_string();
+        checkpoint.generator_start = payload.read_string();
+        checkpoint.generator_state = payload.read_u64_vector();
+        checkpoint.total_numbers = payload.read_u64();
+        checkpoint.numbers_done = payload.read_u64();
+        checkpoint.num_threads = payload.read_u64();
+        uint64_t tests = payload.read_u64();
+        checkpoint.test_configs.clear();
+        checkpoint.test_states.clear();
+        for (uint64_t i = 0; i < tests; ++i)
+        {
+            checkpoint.test_configs.push_back(payload.read_string());
+            checkpoint.test_states.push_back(payload.read_string());
+        }
+        expect_end(payload, "Checkpoint " + path);
+        return true;
+    }
+
+    CheckpointedRunResult run_checkpointed(RandomGenerator &generator,
+                                           const std::vector<StreamingTest *> &tests,
+                                           const CheckpointOptions &options,
+                                           double significance_level)
+    {
+        if (options.interval == 0)
+        {
+            throw std::invalid_argument("Checkpoint interval must be positive");
+        }
+
+        CheckpointedRunResult result;
+        for (StreamingTest *test : tests)
+        {
+            test->reset();
+        }
+
+        // The thread count decides where floating-point sums are split, so a
+        // resumed run has to keep it to match an uninterrupted one
+        size_t threads = options.num_threads == 0 ? default_thread_count() : options.num_threads;
+        std::string generator_start = options.path.empty() ? std::string() : generator_fingerprint(generator);
+
+        uint64_t done = 0;
+        Checkpoint saved;
+        if (!options.path.empty() && read_checkpoint(options.path, saved))
+        {
+            bool same_run = saved.generator_name == generator.get_name() &&
+                            saved.generator_start == generator_start &&
+                            saved.total_numbers == options.total_numbers &&
+                            saved.test_configs.size() == tests.size() &&
+                            saved.numbers_done <= saved.total_numbers;
+            for (size_t i = 0; same_run && i < tests.size(); ++i)
+                same_run = saved.test_configs[i] == tests[i]->get_config();
+            if (!same_run)
+            {
+                throw std::invalid_argument("Checkpoint " + options.path + " belongs to a different run");
+            }
+            if (saved.num_threads != threads)
+            {
+                throw std::invalid_argument("Checkpoint " + options.path + " was written with " +
+                                            std::to_string(saved.num_threads) + " threads, not " +
+                                            std::to_string(threads));
+            }
+
+            generator.set_state(saved.generator_state);
+            for (size_t i = 0; i < tests.size(); ++i)
+            {
+                BinaryReader reader(saved.test_states[i]);
+                tests[i]->load_state(reader);
+                expect_end(reader, "State of " + saved.test_configs[i] + " in " + options.path);
+            }
+            done = saved.numbers_done;
+            result.resumed = true;
+            result.resumed_at = done;
+        }
+
+        // Blocks never straddle a checkpoint, so a resumed run cuts the
+        // sequence at the same places as an uninterrupted one
+        std::vector<double> block(static_cast<size_t>(std::min<uint64_t>(BLOCK_SIZE, options.total_numbers)));
+        uint64_t next_checkpoint = (done / options.interval + 1) * options.interval;
+        static const ProbeId fill_probe = RNG_PROBE("generator.fill");
+        while (done < options.total_numbers)
+        {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(
+                {block.size(), options.total_numbers - done, next_checkpoint - done}));
+            {
+                RNG_TIMED_SCOPE(fill_probe, count);
+                generator.fill(block.data(), count);
+            }
+            feed_fused(tests, block.data(), count, threads);
+            done += count;
+
+            if (done == next_checkpoint)
+            {
+                next_checkpoint += options.interval;
+                if (!options.path.empty() && done < options.total_numbers)
+                {
+                    Checkpoint checkpoint;
+                    checkpoint.generator_name = generator.get_name();
+                    checkpoint.generator_start = generator_start;
+                    checkpoint.generator_state = generator.get_state();
+                    checkpoint.total_numbers = options.total_numbers;
+                    checkpoint.numbers_done = done;
+                    checkpoint.num_threads = threads;
+                    for (StreamingTest *test : tests)
+                    {
+                        BinaryWriter writer;
+                        test->save_state(writer);
+                        checkpoint.test_configs.push_back(test->get_config());
+                        checkpoint.test_states.push_back(writer.data());
+                    }
+                    write_checkpoint(options.path, checkpoint);
+                    ++result.checkpoints_written;
+                }
+            }
+        }
+
+        std::vector<ProbeId> evaluate_probes = probes_for(tests, "test.evaluate: ");
+        for (size_t t = 0; t < tests.size(); ++t)
+        {
+            RNG_TIMED_SCOPE(evaluate_probes[t], 1);
+            result.verdicts.push_back(tests[t]->evaluate(significance_level));
+        }
+        if (!options.path.empty() && options.remove_when_done)
+        {
+            std::remove(options.path.c_str());
+        }
+        return result;
+    }
+
+} // namespace rng
@@ -0,0 +1,737 @@
+#include "../../include/engine/distributed.hpp"
+#include "../../include/engine/fused_runner.hpp"
+#include "../../include/engine/result_cache.hpp"
+#include "../../include/utils/instrumentation.hpp"
+#include "../../include/utils/parallel.hpp"
+#include "../../include/utils/serialization.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <csignal>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace rng
+{
+
+    namespace
+    {
+        // Numbers generated at a time inside a shard, per worker thread, so
+        // that feed_fused() has a part of at least its minimum size per thread
+        constexpr size_t BLOCK_SIZE = 1 << 18;
+
+        // Start of a shard: everything a worker needs to reproduce it, and
+        // what it checks its own generator and tests against first
+        struct ShardPlan
+        {
+            std::vector<uint64_t> state;
+            uint64_t count = 0;
+            std::string generator;            // generator_fingerprint() at the start
+            std::vector<std::string> configs; // get_config() of each test
+        };
+
+        void write_plan(BinaryWriter &out, const ShardPlan &plan)
+        {
+            out.write_u64(plan.count);
+            out.write_u64_vector(plan.state);
+            out.write_string(plan.generator);
+            out.write_u64(plan.configs.size());
+            for (const std::string &config : plan.configs)
+                out.write_string(config);
+        }
+
+        ShardPlan read_plan(BinaryReader &in)
+        {
+            ShardPlan plan;
+            plan.count = in.read_u64();
+            plan.state = in.read_u64_vector();
+            plan.generator = in.read_string();
+            uint64_t tests = in.read_u64();
+            for (uint64_t t = 0; t < tests; ++t)
+                plan.configs.push_back(in.read_string());
+            return plan;
+        }
+
+        // Moves the generator past `count` outputs exactly as fill() would
+        void advance(RandomGenerator &generator, uint64_t count, std::vector<double> &block)
+        {
+            if (generator.supports_jump_ahead())
+            {
+                generator.jump_ahead(count);
+                return;
+            }
+            block.resize(BLOCK_SIZE);
+            for (uint64_t done = 0; done < count;)
+            {
+                size_t length = static_cast<size_t>(std::min<uint64_t>(BLOCK_SIZE, count - done));
+                generator.fill(block.data(), length);
+                done += length;
+            }
+        }
+
+        // Accumulator blobs of fresh tests run over one shard
+        std::vector<std::string> run_shard(RandomGenerator &generator,
+                                           const std::vector<StreamingTest *> &tests,
+                                           const ShardPlan &plan, size_t threads,
+                                           std::vector<double> &block)
+        {
+            bool same_tests = plan.configs.size() == tests.size();
+            for (size_t t = 0; same_tests && t < tests.size(); ++t)
+                same_tests = plan.configs[t] == tests[t]->get_config();
+            if (!same_tests)
+            {
+                throw std::runtime_error("Worker holds other tests than the coordinator");
+            }
+            generator.set_state(plan.state);
+            if (generator_fingerprint(generator) != plan.generator)
+            {
+                throw std::runtime_error("Worker generator " + generator.get_name() +
+                                         " differs from the coordinator's");
+            }
+            for (StreamingTest *test : tests)
+                test->reset();
+
+            block.resize(BLOCK_SIZE * std::max<size_t>(1, threads));
+            static const ProbeId fill_probe = RNG_PROBE("generator.fill");
+            for (uint64_t done = 0; done < plan.count;)
+            {
+                size_t length = static_cast<size_t>(std::min<uint64_t>(block.size(), plan.count - done));
+                {
+                    RNG_TIMED_SCOPE(fill_probe, length);
+                    generator.fill(block.data(), length);
+                }
+                feed_fused(tests, block.data(), length, threads);
+                done += length;
+            }
+
+            std::vector<std::string> states;
+            for (StreamingTest *test : tests)
+            {
+                BinaryWriter writer;
+                test->save_state(writer);
+                states.push_back(writer.data());
+            }
+            return states;
+        }
+
+        // Folds the accumulators of the next shard in sequence order into the tests
+        void merge_shard(const std::vector<StreamingTest *> &tests, const std::vector<std::string> &states,
+                         bool first)
+        {
+            static const ProbeId probe = RNG_PROBE("test.merge");
+            RNG_TIMED_SCOPE(probe, 1);
+            for (size_t t = 0; t < tests.size(); ++t)
+            {
+                BinaryReader reader(states[t]);
+                if (first)
+                {
+                    tests[t]->load_state(reader);
+                    continue;
+                }
+                auto part = tests[t]->clone_empty();
+                part->load_state(reader);
+                tests[t]->merge(*part);
+            }
+        }
+
+#ifndef _WIN32
+        enum MessageKind : uint64_t
+        {
+            SHARD_REQUEST = 1,
+            SHARD_RESULT = 2,
+            SHARD_ERROR = 3,
+            WORKER_HELLO = 4 // first frame of a TCP worker, with the pool's token
+        };
+        // Frames larger than this are taken as a broken stream, not data
+        constexpr uint64_t MAX_FRAME_SIZE = 1ULL << 32;
+
+        bool write_all(int fd, const char *data, size_t size)
+        {
+            while (size > 0)
+            {
+                ssize_t count = ::send(fd, data, size, MSG_NOSIGNAL);
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+                data += count;
+                size -= static_cast<size_t>(count);
+            }
+            return true;
+        }
+
+        bool read_all(int fd, char *data, size_t size)
+        {
+            while (size > 0)
+            {
+                ssize_t count = ::recv(fd, data, size, 0);
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
+                    return false;
+                data += count;
+                size -= static_cast<size_t>(count);
+            }
+            return true;
+        }
+
+        // A frame is the payload length as a u64 followed by the payload
+        bool send_frame(int fd, const std::string &payload)
+        {
+            BinaryWriter header;
+            header.write_u64(payload.size());
+            return write_all(fd, header.data().data(), header.data().size()) &&
+                   write_all(fd, payload.data(), payload.size());
+        }
+
+        // False when the peer is gone or the stream is damaged
+        bool receive_frame(int fd, std::string &payload)
+        {
+            std::string header(8, '\0');
+            if (!read_all(fd, &header[0], header.size()))
+                return false;
+            uint64_t size = BinaryReader(header).read_u64();
+            if (size > MAX_FRAME_SIZE)
+                return false;
+            payload.assign(static_cast<size_t>(size), '\0');
+            return read_all(fd, &payload[0], payload.size());
+        }
+
+        // Worker side: answers shard requests until the coordinator hangs up
+        void serve_shards(int fd, const RandomGenerator &prototype,
+                          const std::vector<StreamingTest *> &tests, size_t threads)
+        {
+            auto generator = prototype.clone();
+            std::vector<std::unique_ptr<StreamingTest>> copies;
+            std::vector<StreamingTest *> targets;
+            for (StreamingTest *test : tests)
+            {
+                copies.push_back(test->clone_empty());
+                targets.push_back(copies.back().get());
+            }
+
+            std::vector<double> block;
+            std::string request;
+            while (receive_frame(fd, request))
+            {
+                BinaryWriter reply;
+                try
+                {
+                    BinaryReader in(request);
+                    if (in.read_u64() != SHARD_REQUEST)
+                        return;
+                    uint64_t index = in.read_u64();
+                    ShardPlan plan = read_plan(in);
+
+                    std::vector<std::string> states = run_shard(*generator, targets, plan, threads, block);
+                    reply.write_u64(SHARD_RESULT);
+                    reply.write_u64(index);
+                    for (const std::string &state : states)
+                        reply.write_string(state);
+                }
+                catch (const std::exception &e)
+                {
+                    reply = BinaryWriter();
+                    reply.write_u64(SHARD_ERROR);
+                    reply.write_string(e.what());
+                }
+                if (!send_frame(fd, reply.data()))
+                    return;
+            }
+        }
+
+        using Clock = std::chrono::steady_clock;
+
+        struct Worker
+        {
+            pid_t pid = -1;
+            int fd = -1;
+            bool busy = false;
+            uint64_t shard = 0;
+            Clock::time_point deadline; // for the answer to `shard`
+        };
+
+        // Forked worker processes, each on its own end of a socket pair or
+        // of a loopback TCP connection. Workers still running when the pool
+        // goes away are killed and reaped.
+        class WorkerPool
+        {
+        public:
+            WorkerPool(const RandomGenerator &generator, const std::vector<StreamingTest *> &tests,
+                       size_t threads, double timeout_seconds, DistributedTransport transport)
+                : generator_(generator), tests_(tests), threads_(threads), timeout_seconds_(timeout_seconds),
+                  transport_(transport)
+            {
+                if (transport_ == DistributedTransport::LoopbackTcp)
+                    listen_loopback();
+            }
+
+            ~WorkerPool()
+            {
+                for (Worker &worker : workers_)
+                    stop(worker, true);
+                if (listener_ >= 0)
+                    ::close(listener_);
+            }
+
+            WorkerPool(const WorkerPool &) = delete;
+            WorkerPool &operator=(const WorkerPool &) = delete;
+
+            std::vector<Worker> &workers() { return workers_; }
+
+            void add()
+            {
+                workers_.emplace_back();
+                spawn(workers_.back());
+            }
+
+            void spawn(Worker &worker)
+            {
+                const bool tcp = transport_ == DistributedTransport::LoopbackTcp;
+                int fds[2] = {-1, -1};
+                if (!tcp && ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+                    throw std::runtime_error("Cannot create a socket for a worker process");
+
+                pid_t pid = ::fork();
+                if (pid < 0)
+                {
+                    if (!tcp)
+                    {
+                        ::close(fds[0]);
+                        ::close(fds[1]);
+                    }
+                    throw std::runtime_error("Cannot start a worker process");
+                }
+                if (pid == 0)
+                {
+                    if (!tcp)
+                        ::close(fds[0]);
+                    if (listener_ >= 0)
+                        ::close(listener_);
+                    for (const Worker &other : workers_)
+                    {
+                        if (other.fd >= 0)
+                            ::close(other.fd);
+                    }
+                    int status = 0;
+                    try
+                    {
+                        int fd = tcp ? connect_loopback() : fds[1];
+                        if (fd >= 0)
+                            serve_shards(fd, generator_, tests_, threads_);
+                        else
+                            status = 1;
+                    }
+                    catch (...)
+                    {
+                        status = 1;
+                    }
+                    // Skip the parent's exit handlers and buffered output
+                    ::_exit(status);
+                }
+
+                worker.pid = pid;
+                worker.busy = false;
+                if (tcp)
+                {
+                    worker.fd = accept_worker(pid);
+                }
+                else
+                {
+                    ::close(fds[1]);
+                    worker.fd = fds[0];
+                }
+                // A worker that stops in the middle of a frame must not block
+                // the coordinator's read either
+                if (timeout_seconds_ > 0.0)
+                    set_receive_timeout(worker.fd, timeout_seconds_);
+            }
+
+            // Closing the socket ends an idle worker; `kill` also ends a busy one
+            void stop(Worker &worker, bool kill)
+            {
+                if (worker.pid < 0)
+                    return;
+                ::close(worker.fd);
+                if (kill)
+                    ::kill(worker.pid, SIGKILL);
+                int status;
+                while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+                {
+                }
+                worker.pid = -1;
+                worker.fd = -1;
+                worker.busy = false;
+            }
+
+        private:
+            // Time a forked TCP worker gets to connect and introduce itself
+            static constexpr double CONNECT_SECONDS = 30.0;
+
+            const RandomGenerator &generator_;
+            const std::vector<StreamingTest *> &tests_;
+            size_t threads_;
+            double timeout_seconds_;
+            DistributedTransport transport_;
+            std::vector<Worker> workers_;
+            int listener_ = -1;
+            uint16_t port_ = 0;
+            // Proves that a connection comes from a worker of this pool and
+            // not from another local process that found the port
+            uint64_t token_ = 0;
+
+            static void set_receive_timeout(int fd, double seconds)
+            {
+                timeval timeout;
+                seconds = std::min(seconds, 1e9);
+                timeout.tv_sec = static_cast<time_t>(seconds);
+                timeout.tv_usec = static_cast<suseconds_t>((seconds - timeout.tv_sec) * 1e6);
+                ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            }
+
+            static void set_no_delay(int fd)
+            {
+                int on = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            }
+
+            static sockaddr_in loopback_address(uint16_t port)
+            {
+                sockaddr_in address{};
+                address.sin_family = AF_INET;
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                address.sin_port = htons(port);
+                return address;
+            }
+
+            // Listens on an ephemeral port of 127.0.0.1 for the workers to call
+            void listen_loopback()
+            {
+                std::random_device entropy;
+                token_ = (static_cast<uint64_t>(entropy()) << 32) ^ entropy();
+
+                listener_ = ::socket(AF_INET, SOCK_STREAM, 0);
+                if (listener_ < 0)
+                    throw std::runtime_error("Cannot create a TCP socket for the workers");
+                sockaddr_in address = loopback_address(0);
+                socklen_t length = sizeof(address);
+                if (::bind(listener_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+                    ::listen(listener_, 16) != 0 ||
+                    ::getsockname(listener_, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+                {
+                    ::close(listener_);
+                    listener_ = -1;
+                    throw std::runtime_error("Cannot listen on a loopback TCP port for the workers");
+                }
+                port_ = ntohs(address.sin_port);
+            }
+
+            // Worker side: connects back and introduces itself; -1 on failure
+            int connect_loopback() const
+            {
+                int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+                if (fd < 0)
+                    return -1;
+                sockaddr_in address = loopback_address(port_);
+                if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+                {
+                    ::close(fd);
+                    return -1;
+                }
+                set_no_delay(fd);
+                BinaryWriter hello;
+                hello.write_u64(WORKER_HELLO);
+                hello.write_u64(token_);
+                if (!send_frame(fd, hello.data()))
+                {
+                    ::close(fd);
+                    return -1;
+                }
+                return fd;
+            }
+
+            // Coordinator side: the connection of the worker just forked.
+            // Connections without the pool's token are dropped.
+            int accept_worker(pid_t pid)
+            {
+                const Clock::time_point deadline =
+                    Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(CONNECT_SECONDS));
+                while (Clock::now() < deadline)
+                {
+                    double left = std::chrono::duration<double, std::milli>(deadline - Clock::now()).count();
+                    pollfd waiting = {listener_, POLLIN, 0};
+                    int ready = ::poll(&waiting, 1, static_cast<int>(std::max(std::ceil(left), 1.0)));
+                    if (ready < 0 && errno == EINTR)
+                        continue;
+                    if (ready <= 0)
+                        break;
+                    int fd = ::accept(listener_, nullptr, nullptr);
+                    if (fd < 0)
+                        continue;
+                    set_no_delay(fd);
+                    set_receive_timeout(fd, CONNECT_SECONDS);
+                    std::string hello;
+                    if (receive_frame(fd, hello) && hello.size() == 16)
+                    {
+                        BinaryReader in(hello);
+                        if (in.read_u64() == WORKER_HELLO && in.read_u64() == token_)
+                            return fd;
+                    }
+                    ::close(fd);
+                }
+                ::kill(pid, SIGKILL);
+                int status;
+                while (::waitpid(pid, &status, 0) < 0 && errno == EINTR)
+                {
+                }
+                throw std::runtime_error("Worker process did not connect over loopback TCP");
+            }
+        };
+#endif
+    } // namespace
+
+    DistributedResult run_distributed(RandomGenerator &generator,
+                                      const std::vector<StreamingTest *> &tests,
+                                      const DistributedOptions &options,
+                                      double significance_level)
+    {
+        if (options.shard_size == 0)
+        {
+            throw std::invalid_argument("Shard size must be positive");
+        }
+        if (!(options.shard_timeout_seconds >= 0.0))
+        {
+            throw std::invalid_argument("Shard timeout cannot be negative");
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        const size_t threads = options.threads_per_worker == 0 ? default_thread_count() : options.threads_per_worker;
+        DistributedResult result;
+        result.shards = (options.total_numbers + options.shard_size - 1) / options.shard_size;
+        for (StreamingTest *test : tests)
+        {
+            test->reset();
+        }
+
+        // Shards are planned in order from the coordinator's generator, which
+        // therefore ends up total_numbers outputs further on
+        uint64_t planned = 0;
+        std::vector<double> block;
+        std::vector<std::string> configs;
+        for (StreamingTest *test : tests)
+            configs.push_back(test->get_config());
+        auto plan_next = [&]()
+        {
+            ShardPlan plan;
+            plan.state = generator.get_state();
+            plan.generator = generator_fingerprint(generator);
+            plan.configs = configs;
+            plan.count = std::min(options.shard_size, options.total_numbers - planned * options.shard_size);
+            advance(generator, plan.count, block);
+            ++planned;
+            return plan;
+        };
+
+#ifdef _WIN32
+        const size_t workers = 0; // no fork(); the shards run here with the same result
+#else
+        const size_t workers = options.workers;
+#endif
+        if (workers == 0)
+        {
+            auto worker_generator = generator.clone();
+            std::vector<std::unique_ptr<StreamingTest>> copies;
+            std::vector<StreamingTest *> targets;
+            for (StreamingTest *test : tests)
+            {
+                copies.push_back(test->clone_empty());
+                targets.push_back(copies.back().get());
+            }
+            std::vector<double> shard_block;
+            for (uint64_t index = 0; index < result.shards; ++index)
+            {
+                ShardPlan plan = plan_next();
+                merge_shard(tests, run_shard(*worker_generator, targets, plan, threads, shard_block),
+                            index == 0);
+            }
+        }
+#ifndef _WIN32
+        else
+        {
+            WorkerPool pool(generator, tests, threads, options.shard_timeout_seconds, options.transport);
+            const bool timed = options.shard_timeout_seconds > 0.0;
+            const auto timeout = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(std::min(options.shard_timeout_seconds, 1e9)));
+            for (size_t w = 0; w < std::min<uint64_t>(workers, result.shards); ++w)
+                pool.add();
+
+            std::map<uint64_t, ShardPlan> outstanding;               // sent, no result yet
+            std::map<uint64_t, std::vector<std::string>> finished; // waiting for earlier shards
+            std::deque<uint64_t> returned;                          // taken back from failed workers
+            uint64_t merged = 0;
+            size_t restarts = 0;
+
+            auto lose = [&](Worker &worker)
+            {
+                ++result.worker_failures;
+                if (worker.busy)
+                    returned.push_front(worker.shard);
+                pool.stop(worker, true);
+                if (restarts < options.max_restarts)
+                {
+                    ++restarts;
+                    pool.spawn(worker);
+                }
+            };
+
+            while (merged < result.shards)
+            {
+                // Hand the earliest pending shard to every idle worker
+                for (Worker &worker : pool.workers())
+                {
+                    if (worker.pid < 0 || worker.busy)
+                        continue;
+                    uint64_t index;
+                    if (!returned.empty())
+                    {
+                        index = returned.front();
+                        returned.pop_front();
+                        ++result.reassigned_shards;
+                    }
+                    else if (planned < result.shards)
+                    {
+                        index = planned;
+                        outstanding[index] = plan_next();
+                    }
+                    else
+                    {
+                        break;
+                    }
+
+                    BinaryWriter request;
+                    request.write_u64(SHARD_REQUEST);
+                    request.write_u64(index);
+                    write_plan(request, outstanding[index]);
+                    worker.busy = true;
+                    worker.shard = index;
+                    worker.deadline = Clock::now() + timeout;
+                    if (!send_frame(worker.fd, request.data()))
+                        lose(worker);
+                }
+
+                std::vector<pollfd> waiting;
+                std::vector<Worker *> owners;
+                Clock::time_point earliest = Clock::time_point::max();
+                for (Worker &worker : pool.workers())
+                {
+                    if (worker.pid >= 0 && worker.busy)
+                    {
+                        waiting.push_back({worker.fd, POLLIN, 0});
+                        owners.push_back(&worker);
+                        earliest = std::min(earliest, worker.deadline);
+                    }
+                }
+                if (waiting.empty())
+                {
+                    // Only replacements forked during dispatch can still take work
+                    if (std::none_of(pool.workers().begin(), pool.workers().end(),
+                                     [](const Worker &worker)
+                                     { return worker.pid >= 0; }))
+                        throw std::runtime_error("Every worker process failed");
+                    continue;
+                }
+                // Wake up by the earliest deadline, rounded up to whole milliseconds
+                int wait_ms = -1;
+                if (timed)
+                {
+                    double left = std::chrono::duration<double, std::milli>(earliest - Clock::now()).count();
+                    wait_ms = static_cast<int>(std::min(std::max(std::ceil(left), 0.0), 1e9));
+                }
+                if (::poll(waiting.data(), waiting.size(), wait_ms) < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error("Cannot wait for the worker processes");
+                }
+
+                const Clock::time_point now = Clock::now();
+                for (size_t i = 0; i < waiting.size(); ++i)
+                {
+                    Worker &worker = *owners[i];
+                    if (waiting[i].revents == 0)
+                    {
+                        if (timed && now >= worker.deadline)
+                        {
+                            ++result.timed_out_workers;
+                            lose(worker);
+                        }
+                        continue;
+                    }
+                    std::string payload;
+                    if (!receive_frame(worker.fd, payload))
+                    {
+                        lose(worker);
+                        continue;
+                    }
+
+                    BinaryReader reply(payload);
+                    uint64_t kind = reply.read_u64();
+                    if (kind == SHARD_ERROR)
+                    {
+                        throw std::runtime_error("Worker failed on shard " + std::to_string(worker.shard) +
+                                                 ": " + reply.read_string());
+                    }
+                    uint64_t index = reply.read_u64();
+                    if (kind != SHARD_RESULT || index != worker.shard)
+                    {
+                        lose(worker);
+                        continue;
+                    }
+                    std::vector<std::string> states;
+                    for (size_t t = 0; t < tests.size(); ++t)
+                        states.push_back(reply.read_string());
+                    worker.busy = false;
+                    outstanding.erase(index);
+                    finished[index] = std::move(states);
+                }
+
+                for (auto next = finished.find(merged); next != finished.end(); next = finished.find(merged))
+                {
+                    merge_shard(tests, next->second, merged == 0);
+                    finished.erase(next);
+                    ++merged;
+                }
+            }
+
+            for (Worker &worker : pool.workers())
+                pool.stop(worker, false);
+        }
+#endif
+
+        std::vector<ProbeId> evaluate_probes = probes_for(tests, "test.evaluate: ");
+        for (size_t t = 0; t < tests.size(); ++t)
+        {
+            RNG_TIMED_SCOPE(evaluate_probes[t], 1);
+            result.verdicts.push_back(tests[t]->evaluate(significance_level));
+        }
+        result.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+} // namespace rng
@@ -0,0 +1,168 @@
+#include "../../include/engine/fused_runner.hpp"
+#include "../../include/utils/instrumentation.hpp"
+#include "../../include/utils/parallel.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Numbers handed to every test before moving on (fits in L2)
+        constexpr size_t CHUNK_SIZE = 8192;
+        // Smallest part worth a thread of its own
+        constexpr size_t MIN_PART_SIZE = 1 << 16;
+        // Numbers per thread read from a source per round
+        constexpr size_t BLOCK_SIZE = 1 << 18;
+
+        // `probes` come from probes_for(tests, "test.update: "), resolved once
+        // by the caller since copies share the names of the originals
+        void feed(const std::vector<StreamingTest *> &tests, const std::vector<ProbeId> &probes,
+                  const double *numbers, size_t count)
+        {
+            for (size_t offset = 0; offset < count; offset += CHUNK_SIZE)
+            {
+                size_t length = std::min(CHUNK_SIZE, count - offset);
+                for (size_t t = 0; t < tests.size(); ++t)
+                {
+                    RNG_TIMED_SCOPE(probes[t], length);
+                    tests[t]->update(numbers + offset, length);
+                }
+            }
+        }
+
+        // Copies of the tests for parts 1..shards-1; part 0 uses the originals
+        std::vector<std::vector<std::unique_ptr<StreamingTest>>> make_copies(
+            const std::vector<StreamingTest *> &tests, size_t shards)
+        {
+            std::vector<std::vector<std::unique_ptr<StreamingTest>>> copies(shards);
+            for (size_t s = 1; s < shards; ++s)
+            {
+                for (StreamingTest *test : tests)
+                {
+                    copies[s].push_back(test->clone_empty());
+                }
+            }
+            return copies;
+        }
+
+        std::vector<StreamingTest *> targets_for(const std::vector<StreamingTest *> &tests,
+                                                 std::vector<std::unique_ptr<StreamingTest>> &copies,
+                                                 size_t shard)
+        {
+            if (shard == 0)
+                return tests;
+            std::vector<StreamingTest *> targets;
+            for (auto &copy : copies)
+                targets.push_back(copy.get());
+            return targets;
+        }
+
+        // Merges (and clears) the copies of parts 1..parts-1 in sequence order
+        void merge_copies(const std::vector<StreamingTest *> &tests,
+                          std::vector<std::vector<std::unique_ptr<StreamingTest>>> &copies,
+                          size_t parts)
+        {
+            static const ProbeId probe = RNG_PROBE("test.merge");
+            RNG_TIMED_SCOPE(probe, parts - 1);
+            for (size_t s = 1; s < parts; ++s)
+            {
+                for (size_t t = 0; t < tests.size(); ++t)
+                {
+                    tests[t]->merge(*copies[s][t]);
+                    copies[s][t]->reset();
+                }
+            }
+        }
+
+        std::vector<bool> evaluate_all(const std::vector<StreamingTest *> &tests, double significance_level)
+        {
+            std::vector<ProbeId> probes = probes_for(tests, "test.evaluate: ");
+            std::vector<bool> verdicts;
+            for (size_t t = 0; t < tests.size(); ++t)
+            {
+                RNG_TIMED_SCOPE(probes[t], 1);
+                verdicts.push_back(tests[t]->evaluate(significance_level));
+            }
+            return verdicts;
+        }
+    } // namespace
+
+    std::vector<bool> run_fused(const std::vector<StreamingTest *> &tests,
+                                const std::vector<double> &numbers,
+                                double significance_level,
+                                size_t num_threads)
+    {
+        for (StreamingTest *test : tests)
+        {
+            test->reset();
+        }
+
+        feed_fused(tests, numbers.data(), numbers.size(), num_threads);
+        return evaluate_all(tests, significance_level);
+    }
+
+    void feed_fused(const std::vector<StreamingTest *> &tests,
+                    const double *numbers, size_t count,
+                    size_t num_threads)
+    {
+        size_t threads = num_threads == 0 ? default_thread_count() : num_threads;
+        size_t shards = std::max<size_t>(1, std::min(threads, count / MIN_PART_SIZE));
+        auto copies = make_copies(tests, shards);
+        std::vector<ProbeId> probes = probes_for(tests, "test.update: ");
+
+        parallel_for_shards(count, shards, [&](size_t shard, size_t begin, size_t end)
+                            { feed(targets_for(tests, copies[shard], shard), probes, numbers + begin, end - begin); });
+
+        merge_copies(tests, copies, shards);
+    }
+
+    std::vector<bool> run_fused(const std::vector<StreamingTest *> &tests,
+                                DataSource &source,
+                                double significance_level,
+                                size_t num_threads)
+    {
+        for (StreamingTest *test : tests)
+        {
+            test->reset();
+        }
+
+        size_t shards = num_threads == 0 ? default_thread_count() : num_threads;
+        auto copies = make_copies(tests, shards);
+        std::vector<ProbeId> probes = probes_for(tests, "test.update: ");
+        std::vector<double> block(shards * BLOCK_SIZE);
+        static const ProbeId read_probe = RNG_PROBE("source.read");
+        static const ProbeId numbers_probe = RNG_PROBE("source.numbers");
+
+        while (true)
+        {
+            size_t filled = 0;
+            while (filled < block.size())
+            {
+                size_t count;
+                {
+                    RNG_TIMED_SCOPE(read_probe, 0);
+                    count = source.read(block.data() + filled, block.size() - filled);
+                }
+                RNG_COUNT(numbers_probe, count);
+                if (count == 0)
+                    break;
+                filled += count;
+            }
+            if (filled == 0)
+                break;
+
+            size_t parts = std::max<size_t>(1, std::min(shards, filled / MIN_PART_SIZE));
+            parallel_for_shards(filled, parts, [&](size_t shard, size_t begin, size_t end)
+                                { feed(targets_for(tests, copies[shard], shard), probes, block.data() + begin, end - begin); });
+            merge_copies(tests, copies, parts);
+
+            if (filled < block.size())
+                break;
+        }
+
+        return evaluate_all(tests, significance_level);
+    }
+
+} // namespace rng
@@ -0,0 +1,276 @@
+#include "../../include/engine/monitor.hpp"
+#include "../../include/tests/edf_tests.hpp"
+#include "../../include/tests/statistics.hpp"
+#include "../../include/utils/instrumentation.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Pair sums hold values rounded to multiples of 2^-20: products stay
+        // below 2^38, so sums over 2^24 pairs fit in 63 bits
+        constexpr double FIXED_SCALE = 1 << 20;
+        constexpr size_t MAX_WINDOW = 1 << 24;
+        constexpr size_t MIN_WINDOW = 8;
+
+        double two_sided_normal_p_value(double z)
+        {
+            return 2.0 * (1.0 - normal_cdf(std::abs(z)));
+        }
+    } // namespace
+
+    WindowMonitor::WindowMonitor(const MonitorOptions &options, AlertHandler on_alert)
+        : options_(options), on_alert_(std::move(on_alert)), position_(0),
+          sum_squared_counts_(0), window_changes_(0), last_value_(0.0), last_increasing_(false),
+          sum_x_(0), sum_y_(0), sum_xx_(0), sum_yy_(0), sum_xy_(0),
+          seen_(0), rejected_(0), evaluations_(0), until_evaluation_(options.window)
+    {
+        if (options.window < MIN_WINDOW || options.window > MAX_WINDOW)
+        {
+            throw std::invalid_argument("Monitor window must hold between 8 and 2^24 numbers");
+        }
+        if (options.step == 0 || options.window % options.step != 0)
+        {
+            throw std::invalid_argument("Monitor step must divide the window");
+        }
+        if (options.chi_square_bins < 2 || options.chi_square_bins > options.window)
+        {
+            throw std::invalid_argument("Monitor needs between 2 and window chi-square bins");
+        }
+        if (options.persistence == 0)
+        {
+            throw std::invalid_argument("Monitor persistence must be positive");
+        }
+
+        centred_.assign(options.window, 0);
+        bins_.assign(options.window, 0);
+        changes_.assign(options.window, 0);
+        bin_counts_.assign(options.chi_square_bins, 0);
+    }
+
+    void WindowMonitor::push(double number)
+    {
+        if (!(number >= 0.0 && number <= 1.0))
+        {
+            ++rejected_;
+            return;
+        }
+
+        const size_t window = options_.window;
+        const size_t bins = options_.chi_square_bins;
+        size_t bin = static_cast<size_t>(number * bins);
+        if (bin == bins)
+            bin--;
+        int64_t y = static_cast<int64_t>((number - 0.5) * FIXED_SCALE);
+        size_t position = position_;
+        size_t next = position + 1 == window ? 0 : position + 1;
+
+        if (seen_ >= window)
+        {
+            // Sample i - window leaves: its bin, the pair it starts and the
+            // direction change of sample i - window + 2, which it anchors
+            int64_t count = --bin_counts_[bins_[position]];
+            sum_squared_counts_ -= 2 * count + 1;
+
+            int64_t a = centred_[position];
+            int64_t b = centred_[next];
+            sum_x_ -= a;
+            sum_y_ -= b;
+            sum_xx_ -= a * a;
+            sum_yy_ -= b * b;
+            sum_xy_ -= a * b;
+
+            size_t anchored = next + 1 == window ? 0 : next + 1;
+            window_changes_ -= changes_[anchored];
+        }
+
+        uint8_t change = 0;
+        if (seen_ >= 1)
+        {
+            size_t previous = position == 0 ? window - 1 : position - 1;
+            int64_t x = centred_[previous];
+            sum_x_ += x;
+            sum_y_ += y;
+            sum_xx_ += x * x;
+            sum_yy_ += y * y;
+            sum_xy_ += x * y;
+
+            bool increasing = number > last_value_;
+            change = seen_ >= 2 && increasing != last_increasing_;
+            last_increasing_ = increasing;
+        }
+        changes_[position] = change;
+        window_changes_ += change;
+
+        last_value_ = number;
+        centred_[position] = y;
+        bins_[position] = static_cast<uint32_t>(bin);
+        int64_t count = bin_counts_[bin]++;
+        sum_squared_counts_ += 2 * count + 1;
+
+        position_ = next;
+        ++seen_;
+        if (--until_evaluation_ == 0)
+        {
+            until_evaluation_ = options_.step;
+            evaluate();
+        }
+    }
+
+    void WindowMonitor::push(const double *numbers, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            push(numbers[i]);
+    }
+
+    void WindowMonitor::evaluate()
+    {
+        ++evaluations_;
+        bool window_boundary = position_ == 0;
+        double n = static_cast<double>(options_.window);
+
+        double chi_square = static_cast<double>(options_.chi_square_bins) * sum_squared_counts_ / n - n;
+        track(MonitorStatistic::ChiSquare,
+              chi_square_p_value(chi_square, static_cast<double>(options_.chi_square_bins - 1)),
+              window_boundary);
+
+        double runs = static_cast<double>(window_changes_ + 1);
+        double runs_z = (runs - (2.0 * n - 1.0) / 3.0) / std::sqrt((16.0 * n - 29.0) / 90.0);
+        track(MonitorStatistic::Runs, two_sided_normal_p_value(runs_z), window_boundary);
+
+        double pairs = n - 1.0;
+        double sx = static_cast<double>(sum_x_), sy = static_cast<double>(sum_y_);
+        double numerator = sum_xy_ - sx * sy / pairs;
+        double denominator = (sum_xx_ - sx * sx / pairs) * (sum_yy_ - sy * sy / pairs);
+        // A constant window has no correlation to speak of and fails outright
+        double correlation_p = denominator > 0.0
+                                   ? two_sided_normal_p_value(numerator / std::sqrt(denominator) * std::sqrt(pairs))
+                                   : 0.0;
+        track(MonitorStatistic::SerialCorrelation, correlation_p, window_boundary);
+    }
+
+    void WindowMonitor::track(MonitorStatistic statistic, double p_value, bool window_boundary)
+    {
+        Tracker &tracker = trackers_[static_cast<size_t>(statistic)];
+        tracker.p_value = p_value;
+
+        MonitorAlert alert;
+        alert.sample = seen_;
+        alert.statistic = statistic;
+
+        bool low = p_value <= options_.alert_level;
+        if (low == tracker.alarmed)
+        {
+            tracker.streak = 0;
+        }
+        else if (++tracker.streak >= options_.persistence)
+        {
+            tracker.alarmed = low;
+            tracker.streak = 0;
+            alert.kind = low ? AlertKind::Raised : AlertKind::Cleared;
+            alert.p_value = p_value;
+            if (on_alert_)
+                on_alert_(alert);
+        }
+
+        if (!window_boundary || options_.drift_windows == 0)
+            return;
+        tracker.window_p_values.push_back(p_value);
+        if (tracker.window_p_values.size() < options_.drift_windows)
+            return;
+
+        KolmogorovSmirnovTest ks(EdfMode::Exact, 2, 1);
+        ks.run_test(tracker.window_p_values, options_.drift_level);
+        tracker.window_p_values.clear();
+        if (ks.get_p_value() <= options_.drift_level)
+        {
+            alert.kind = AlertKind::Drift;
+            alert.p_value = ks.get_p_value();
+            if (on_alert_)
+                on_alert_(alert);
+        }
+    }
+
+    double WindowMonitor::get_p_value(MonitorStatistic statistic) const
+    {
+        return trackers_[static_cast<size_t>(statistic)].p_value;
+    }
+
+    bool WindowMonitor::in_alarm(MonitorStatistic statistic) const
+    {
+        return trackers_[static_cast<size_t>(statistic)].alarmed;
+    }
+
+    MonitorSummary run_monitor(DataSource &source, const MonitorOptions &options,
+                               const AlertHandler &on_alert, size_t chunk)
+    {
+        if (chunk == 0)
+        {
+            throw std::invalid_argument("Monitor chunk must hold at least one number");
+        }
+
+        static const ProbeId update_probe = RNG_PROBE("monitor.update");
+
+        MonitorSummary summary;
+        WindowMonitor monitor(options, [&summary, &on_alert](const MonitorAlert &alert)
+                              {
+                                  ++summary.alerts;
+                                  if (on_alert)
+                                      on_alert(alert);
+                              });
+
+        std::vector<double> buffer(chunk);
+        while (size_t count = source.read(buffer.data(), buffer.size()))
+        {
+            RNG_TIMED_SCOPE(update_probe, count);
+            auto start = std::chrono::steady_clock::now();
+            monitor.push(buffer.data(), count);
+            summary.update_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        summary.samples = monitor.samples();
+        summary.rejected = monitor.rejected();
+        summary.evaluations = monitor.evaluations();
+        return summary;
+    }
+
+    std::string statistic_to_string(MonitorStatistic statistic)
+    {
+        switch (statistic)
+        {
+        case MonitorStatistic::ChiSquare:
+            return "chi-square";
+        case MonitorStatistic::Runs:
+            return "runs";
+        default:
+            return "serial-correlation";
+        }
+    }
+
+    std::string format_alert(const MonitorAlert &alert)
+    {
+        std::stringstream ss;
+        ss << "[" << alert.sample << "] ";
+        switch (alert.kind)
+        {
+        case AlertKind::Raised:
+            ss << "ALERT " << statistic_to_string(alert.statistic) << " window p-value ";
+            break;
+        case AlertKind::Cleared:
+            ss << "CLEARED " << statistic_to_string(alert.statistic) << " window p-value ";
+            break;
+        default:
+            ss << "DRIFT " << statistic_to_string(alert.statistic) << " p-values of disjoint windows, KS p-value ";
+            break;
+        }
+        ss << std::scientific << std::setprecision(3) << alert.p_value;
+        return ss.str();
+    }
+
+} // namespace rng
@@ -0,0 +1,559 @@
+#include "../../include/engine/period_analysis.hpp"
+#include "../../include/generators/lcg.hpp"
+#include "../../include/generators/mcg.hpp"
+#include "../../include/utils/modular.hpp"
+#include "../../include/utils/parallel.hpp"
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        constexpr size_t MIN_ORBIT_SHARD = 1 << 16;
+
+        bool test_bit(const std::vector<uint64_t> &bits, uint64_t i)
+        {
+            return (bits[i >> 6] >> (i & 63)) & 1;
+        }
+
+        void set_bit(std::vector<uint64_t> &bits, uint64_t i)
+        {
+            bits[i >> 6] |= 1ULL << (i & 63);
+        }
+
+        // Deterministic Miller-Rabin for all 64-bit n
+        bool is_prime(uint64_t n)
+        {
+            if (n < 2)
+                return false;
+            for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+            {
+                if (n % p == 0)
+                    return n == p;
+            }
+            uint64_t d = n - 1;
+            unsigned s = 0;
+            while ((d & 1) == 0)
+            {
+                d >>= 1;
+                ++s;
+            }
+            for (uint64_t base : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+            {
+                uint64_t x = pow_mod(base, d, n);
+                if (x == 1 || x == n - 1)
+                    continue;
+                bool composite = true;
+                for (unsigned r = 1; r < s && composite; ++r)
+                {
+                    x = mul_mod(x, x, n);
+                    composite = x != n - 1;
+                }
+                if (composite)
+                    return false;
+            }
+            return true;
+        }
+
+        // Pollard's rho with Brent's cycle finding; n is odd and composite
+        uint64_t find_divisor(uint64_t n)
+        {
+            for (uint64_t increment = 1;; ++increment)
+            {
+                auto f = [n, increment](uint64_t x)
+                { return add_mod(mul_mod(x, x, n), increment, n); };
+                uint64_t x = 2, y = 2, g = 1;
+                for (uint64_t power = 1; g == 1; power <<= 1)
+                {
+                    x = y;
+                    for (uint64_t i = 0; i < power && g == 1; ++i)
+                    {
+                        y = f(y);
+                        g = std::gcd(x > y ? x - y : y - x, n);
+                    }
+                }
+                if (g != n)
+                    return g;
+            }
+        }
+
+        void collect_prime_factors(uint64_t n, std::vector<uint64_t> &primes)
+        {
+            if (n == 1)
+                return;
+            if (is_prime(n))
+            {
+                primes.push_back(n);
+                return;
+            }
+            uint64_t divisor = find_divisor(n);
+            collect_prime_factors(divisor, primes);
+            collect_prime_factors(n / divisor, primes);
+        }
+
+        uint64_t lcm(uint64_t a, uint64_t b)
+        {
+            return a / std::gcd(a, b) * b;
+        }
+
+        // Carmichael function: exponent of the multiplicative group mod n
+        uint64_t carmichael(const std::vector<std::pair<uint64_t, unsigned>> &factors)
+        {
+            uint64_t result = 1;
+            for (const auto &[p, e] : factors)
+            {
+                uint64_t value = p - 1;
+                for (unsigned i = 1; i < e; ++i)
+                    value *= p;
+                if (p == 2 && e >= 3)
+                    value /= 2;
+                result = lcm(result, value);
+            }
+            return result;
+        }
+
+        // Smallest divisor d of `multiple` with holds(d) true, given
+        // holds(multiple) and that the set where it holds is closed under gcd
+        template <typename Predicate>
+        unsigned __int128 reduce_order(unsigned __int128 multiple,
+                                       const std::vector<uint64_t> &primes, Predicate holds)
+        {
+            for (uint64_t p : primes)
+            {
+                while (multiple % p == 0 && holds(multiple / p))
+                    multiple /= p;
+            }
+            return multiple;
+        }
+
+        std::vector<uint64_t> distinct_primes(uint64_t n)
+        {
+            std::vector<uint64_t> primes;
+            for (const auto &factor : factorize(n))
+                primes.push_back(factor.first);
+            return primes;
+        }
+
+        // Multiplicative order of a modulo n, gcd(a, n) = 1
+        uint64_t multiplicative_order(uint64_t a, uint64_t n)
+        {
+            if (n == 1)
+                return 1;
+            uint64_t exponent = carmichael(factorize(n));
+            return static_cast<uint64_t>(reduce_order(exponent, distinct_primes(exponent),
+                                                      [a, n](unsigned __int128 k)
+                                                      { return pow_mod(a, static_cast<uint64_t>(k), n) == 1; }));
+        }
+
+        struct Affine
+        {
+            uint64_t a;
+            uint64_t c;
+        };
+
+        // x -> a x + c applied `steps` times, as a single affine map mod m
+        Affine affine_power(Affine map, unsigned __int128 steps, uint64_t m)
+        {
+            Affine result{1 % m, 0};
+            while (steps > 0)
+            {
+                if (steps & 1)
+                    result = {mul_mod(result.a, map.a, m), add_mod(mul_mod(map.a, result.c, m), map.c, m)};
+                map = {mul_mod(map.a, map.a, m), add_mod(mul_mod(map.a, map.c, m), map.c, m)};
+                steps >>= 1;
+            }
+            return result;
+        }
+
+        // Period of x under x -> (a x + c) mod m, with m given by its prime
+        // factors. Primes of m dividing a make their component collapse onto
+        // a fixed point, so only the part of m coprime to a matters; there
+        // the map is a bijection whose order divides
+        // ord(a) * (m / gcd(translation after ord(a) steps, m)).
+        uint64_t affine_period(uint64_t a, uint64_t c, uint64_t x,
+                               const std::vector<std::pair<uint64_t, unsigned>> &factors)
+        {
+            uint64_t coprime = 1;
+            for (const auto &[p, e] : factors)
+            {
+                if (a % p != 0)
+                {
+                    for (unsigned i = 0; i < e; ++i)
+                        coprime *= p;
+                }
+            }
+            if (coprime == 1)
+                return 1;
+
+            Affine map{a % coprime, c % coprime};
+            x %= coprime;
+            uint64_t order = multiplicative_order(map.a, coprime);
+            uint64_t translation = affine_power(map, order, coprime).c;
+            uint64_t repeats = coprime / std::gcd(translation, coprime);
+
+            std::vector<uint64_t> primes = distinct_primes(order);
+            for (uint64_t p : distinct_primes(repeats))
+                primes.push_back(p);
+            std::sort(primes.begin(), primes.end());
+            primes.erase(std::unique(primes.begin(), primes.end()), primes.end());
+
+            unsigned __int128 period = reduce_order(static_cast<unsigned __int128>(order) * repeats, primes,
+                                                    [&](unsigned __int128 k)
+                                                    {
+                                                        Affine step = affine_power(map, k, coprime);
+                                                        return add_mod(mul_mod(step.a, x, coprime), step.c, coprime) == x;
+                                                    });
+            return static_cast<uint64_t>(period);
+        }
+
+        bool states_equal(const RandomGenerator &a, const RandomGenerator &b)
+        {
+            return a.get_state() == b.get_state();
+        }
+    } // namespace
+
+    CycleDetection detect_cycle(const RandomGenerator &generator, uint64_t max_steps)
+    {
+        CycleDetection result;
+        auto hare = generator.clone();
+        const std::vector<uint64_t> start = generator.get_state();
+
+        // Phase 1: the hare runs ahead; the saved state jumps to the hare at
+        // every power of two until the hare meets it, giving the period.
+        // Outputs are a function of the state just entered, so differing
+        // outputs rule out equal states without comparing the full state.
+        std::vector<uint64_t> saved = start;
+        bool saved_has_output = false;
+        uint64_t saved_output = 0;
+        uint64_t power = 1;
+        uint64_t lambda = 1;
+
+        uint64_t output = hare->generate_raw();
+        ++result.steps;
+        while ((saved_has_output && output != saved_output) || hare->get_state() != saved)
+        {
+            if (result.steps >= max_steps)
+                return result;
+            if (power == lambda)
+            {
+                saved = hare->get_state();
+                saved_output = output;
+                saved_has_output = true;
+                power *= 2;
+                lambda = 0;
+            }
+            output = hare->generate_raw();
+            ++result.steps;
+            ++lambda;
+        }
+
+        // Phase 2: two walkers `lambda` apart meet where the cycle starts
+        auto tortoise = generator.clone();
+        hare = generator.clone();
+        hare->jump_ahead(lambda);
+        if (!hare->supports_jump_ahead())
+            result.steps += lambda;
+
+        uint64_t mu = 0;
+        if (!states_equal(*tortoise, *hare))
+        {
+            while (true)
+            {
+                uint64_t a = tortoise->generate_raw();
+                uint64_t b = hare->generate_raw();
+                result.steps += 2;
+                ++mu;
+                if (a == b && states_equal(*tortoise, *hare))
+                    break;
+            }
+        }
+
+        result.found = true;
+        result.period = lambda;
+        result.tail_length = mu;
+        return result;
+    }
+
+    OrbitMap map_orbits(const RandomGenerator &generator, uint64_t state_count, size_t num_threads)
+    {
+        if (generator.get_state().size() != 1)
+        {
+            throw std::invalid_argument("Exhaustive orbit mapping needs a single-word generator state");
+        }
+        if (state_count == 0 || state_count > MAX_ORBIT_STATES)
+        {
+            throw std::invalid_argument("State count must be between 1 and " + std::to_string(MAX_ORBIT_STATES));
+        }
+
+        const size_t n = static_cast<size_t>(state_count);
+        size_t threads = num_threads == 0 ? default_thread_count() : num_threads;
+        size_t shards = std::min(threads, n / MIN_ORBIT_SHARD + 1);
+
+        // Successor of every state, each shard stepping its own clone
+        std::vector<uint32_t> next(n);
+        parallel_for_shards(n, shards, [&](size_t, size_t begin, size_t end)
+                            {
+            auto walker = generator.clone();
+            std::vector<uint64_t> state(1);
+            for (size_t x = begin; x < end; ++x)
+            {
+                state[0] = x;
+                walker->set_state(state);
+                walker->generate_raw();
+                uint64_t successor = walker->get_state()[0];
+                if (successor >= state_count)
+                {
+                    throw std::invalid_argument("State " + std::to_string(x) + " steps to " +
+                                                std::to_string(successor) + ", outside the mapped range");
+                }
+                next[x] = static_cast<uint32_t>(successor);
+            } });
+
+        // Peel states with no predecessors until only the cycles remain;
+        // `tail_order` lists the peeled states from the leaves inwards
+        std::vector<uint32_t> indegree(n, 0);
+        for (uint32_t successor : next)
+            ++indegree[successor];
+
+        std::vector<uint32_t> tail_order;
+        for (size_t x = 0; x < n; ++x)
+        {
+            if (indegree[x] == 0)
+                tail_order.push_back(static_cast<uint32_t>(x));
+        }
+        for (size_t i = 0; i < tail_order.size(); ++i)
+        {
+            if (--indegree[next[tail_order[i]]] == 0)
+                tail_order.push_back(next[tail_order[i]]);
+        }
+
+        std::vector<uint64_t> on_cycle((n + 63) / 64, 0);
+        for (size_t x = 0; x < n; ++x)
+        {
+            if (indegree[x] != 0)
+                set_bit(on_cycle, x);
+        }
+
+        // Label the cycles; the in-degree array is reused for the labels
+        OrbitMap map;
+        map.state_count = state_count;
+        std::vector<uint32_t> &label = indegree;
+        std::vector<uint64_t> labelled((n + 63) / 64, 0);
+        for (size_t x = 0; x < n; ++x)
+        {
+            if (!test_bit(on_cycle, x) || test_bit(labelled, x))
+                continue;
+            OrbitCycle cycle;
+            cycle.smallest_state = x;
+            uint32_t id = static_cast<uint32_t>(map.cycles.size());
+            size_t y = x;
+            do
+            {
+                set_bit(labelled, y);
+                label[y] = id;
+                cycle.smallest_state = std::min<uint64_t>(cycle.smallest_state, y);
+                ++cycle.length;
+                y = next[y];
+            } while (y != x);
+            cycle.basin_size = cycle.length;
+            map.cycles.push_back(cycle);
+        }
+
+        // Walk the tails from the cycles outwards. Once a state's label is
+        // known its successor entry is no longer needed, so `next` is
+        // overwritten with the distance to the cycle (0 on the cycle itself).
+        for (size_t x = 0; x < n; ++x)
+        {
+            if (test_bit(on_cycle, x))
+                next[x] = 0;
+        }
+        for (size_t i = tail_order.size(); i-- > 0;)
+        {
+            uint32_t x = tail_order[i];
+            uint32_t successor = next[x];
+            label[x] = label[successor];
+            next[x] = next[successor] + 1;
+            OrbitCycle &cycle = map.cycles[label[x]];
+            ++cycle.basin_size;
+            cycle.longest_tail = std::max<uint64_t>(cycle.longest_tail, next[x]);
+        }
+
+        std::stable_sort(map.cycles.begin(), map.cycles.end(), [](const OrbitCycle &a, const OrbitCycle &b)
+                         { return a.basin_size > b.basin_size; });
+        return map;
+    }
+
+    std::vector<std::pair<uint64_t, unsigned>> factorize(uint64_t n)
+    {
+        if (n == 0)
+        {
+            throw std::invalid_argument("Cannot factorize zero");
+        }
+        std::vector<uint64_t> primes;
+        while (n % 2 == 0)
+        {
+            primes.push_back(2);
+            n /= 2;
+        }
+        for (uint64_t p = 3; p < 1000 && p * p <= n; p += 2)
+        {
+            while (n % p == 0)
+            {
+                primes.push_back(p);
+                n /= p;
+            }
+        }
+        collect_prime_factors(n, primes);
+        std::sort(primes.begin(), primes.end());
+
+        std::vector<std::pair<uint64_t, unsigned>> factors;
+        for (uint64_t p : primes)
+        {
+            if (!factors.empty() && factors.back().first == p)
+                ++factors.back().second;
+            else
+                factors.emplace_back(p, 1);
+        }
+        return factors;
+    }
+
+    AnalyticPeriod analyze_lcg(uint64_t a, uint64_t c, uint64_t m, uint64_t state)
+    {
+        if (m == 0)
+        {
+            throw std::invalid_argument("Modulus cannot be zero");
+        }
+        a %= m;
+        c %= m;
+        state %= m;
+        auto factors = factorize(m);
+
+        AnalyticPeriod result;
+        result.max_period = m;
+        result.period = affine_period(a, c, state, factors);
+        result.full_period = result.period == m;
+
+        // Hull-Dobell: the period is m for every seed exactly when all three hold
+        bool coprime_increment = std::gcd(c, m) == 1;
+        bool all_primes_divide = true;
+        for (const auto &factor : factors)
+            all_primes_divide = all_primes_divide && (a + m - 1) % m % factor.first == 0;
+        bool four_divides = m % 4 != 0 || (a + m - 1) % m % 4 == 0;
+
+        std::stringstream ss;
+        ss << "Hull-Dobell conditions:"
+           << "\n  1. gcd(c, m) = 1: " << (coprime_increment ? "yes" : "no")
+           << "\n  2. a - 1 divisible by every prime factor of m: " << (all_primes_divide ? "yes" : "no")
+           << "\n  3. a - 1 divisible by 4 when 4 divides m: " << (four_divides ? "yes" : "no");
+        if (coprime_increment && all_primes_divide && four_divides)
+            ss << "\nFull period " << m << " for every seed";
+        else
+            ss << "\nNot full period; the orbit through " << state << " has period " << result.period
+               << " of " << m << " possible";
+        result.explanation = ss.str();
+        return result;
+    }
+
+    AnalyticPeriod analyze_lcg(const LCG &generator)
+    {
+        return analyze_lcg(generator.multiplier(), generator.increment(), generator.modulus(),
+                           generator.get_state()[0]);
+    }
+
+    AnalyticPeriod analyze_mcg(uint64_t a, uint64_t m, uint64_t state)
+    {
+        if (m == 0)
+        {
+            throw std::invalid_argument("Modulus cannot be zero");
+        }
+        a %= m;
+        state %= m;
+        auto factors = factorize(m);
+
+        AnalyticPeriod result;
+        result.max_period = carmichael(factors);
+        result.period = affine_period(a, 0, state, factors);
+        result.full_period = result.period == result.max_period;
+
+        std::stringstream ss;
+        if (std::gcd(a, m) != 1)
+        {
+            ss << "gcd(a, m) = " << std::gcd(a, m) << ": the sequence loses information and"
+               << " settles into period " << result.period;
+        }
+        else if (state == 0)
+        {
+            ss << "State 0 is a fixed point";
+        }
+        else
+        {
+            uint64_t reduced = m / std::gcd(state, m);
+            ss << "Period = multiplicative order of a modulo m / gcd(x, m) (reduced modulus "
+               << reduced << ") = " << result.period
+               << "\nLargest possible period (Carmichael lambda(m)): " << result.max_period;
+            uint64_t order = multiplicative_order(a, m);
+            if (order == result.max_period)
+                ss << "\na has maximal order" << (factors.size() == 1 && factors[0].second == 1 ? " (a primitive root of the prime m)" : "");
+            else
+                ss << "\na has order " << order << ", a divisor of lambda(m)";
+        }
+        result.explanation = ss.str();
+        return result;
+    }
+
+    AnalyticPeriod analyze_mcg(const MCG &generator)
+    {
+        return analyze_mcg(generator.multiplier(), generator.modulus(), generator.get_state()[0]);
+    }
+
+    std::string format_cycle_detection(const CycleDetection &result)
+    {
+        std::stringstream ss;
+        if (!result.found)
+        {
+            ss << "No cycle within " << result.steps << " steps";
+            return ss.str();
+        }
+        ss << "Period: " << result.period
+           << "\nTail length: " << result.tail_length
+           << "\nGenerator steps: " << result.steps;
+        return ss.str();
+    }
+
+    std::string format_orbit_map(const OrbitMap &map, size_t max_cycles)
+    {
+        uint64_t cycle_states = 0;
+        for (const auto &cycle : map.cycles)
+            cycle_states += cycle.length;
+
+        std::stringstream ss;
+        ss << "States: " << map.state_count
+           << "\nCycles: " << map.cycles.size()
+           << "\nStates on cycles: " << cycle_states;
+        for (size_t i = 0; i < map.cycles.size() && i < max_cycles; ++i)
+        {
+            const OrbitCycle &cycle = map.cycles[i];
+            ss << "\n  cycle through " << cycle.smallest_state << ": length " << cycle.length
+               << ", basin " << cycle.basin_size << ", longest tail " << cycle.longest_tail;
+        }
+        if (map.cycles.size() > max_cycles)
+            ss << "\n  ... " << map.cycles.size() - max_cycles << " more";
+        return ss.str();
+    }
+
+    std::string format_analytic_period(const AnalyticPeriod &result)
+    {
+        std::stringstream ss;
+        ss << "Period: " << result.period
+           << "\nMaximum period: " << result.max_period
+           << (result.full_period ? " (reached)" : " (not reached)")
+           << "\n"
+           << result.explanation;
+        return ss.str();
+    }
+
+} // namespace rng
@@ -0,0 +1,225 @@
+#include "../../include/engine/pipeline.hpp"
+#include "../../include/utils/instrumentation.hpp"
+#include "../../include/utils/parallel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Ring of recycled buffers with one producer and several consumers
+        // that each read every buffer in sequence order
+        class BufferRing
+        {
+        public:
+            BufferRing(size_t buffer_count, size_t buffer_size, size_t consumers)
+                : slots_(buffer_count), consumers_(consumers), published_(0),
+                  finished_(false), aborted_(false)
+            {
+                for (auto &slot : slots_)
+                    slot.data.resize(buffer_size);
+            }
+
+            // Buffer for sequence number `sequence`; blocks until every
+            // consumer has released its previous use. Returns null on abort.
+            double *acquire(uint64_t sequence)
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                Slot &slot = slots_[sequence % slots_.size()];
+                slot_free_.wait(lock, [this, &slot]
+                                { return slot.readers == 0 || aborted_; });
+                return aborted_ ? nullptr : slot.data.data();
+            }
+
+            void publish(uint64_t sequence, size_t length)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                Slot &slot = slots_[sequence % slots_.size()];
+                slot.length = length;
+                slot.readers = consumers_;
+                published_ = sequence + 1;
+                data_ready_.notify_all();
+            }
+
+            void finish()
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                finished_ = true;
+                data_ready_.notify_all();
+            }
+
+            void abort()
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                aborted_ = true;
+                data_ready_.notify_all();
+                slot_free_.notify_all();
+            }
+
+            // Waits for buffer `sequence`; false once the stream has ended
+            bool wait_for(uint64_t sequence, const double *&data, size_t &length)
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                data_ready_.wait(lock, [this, sequence]
+                                 { return published_ > sequence || finished_ || aborted_; });
+                if (aborted_ || published_ <= sequence)
+                    return false;
+                const Slot &slot = slots_[sequence % slots_.size()];
+                data = slot.data.data();
+                length = slot.length;
+                return true;
+            }
+
+            void release(uint64_t sequence)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--slots_[sequence % slots_.size()].readers == 0)
+                    slot_free_.notify_one();
+            }
+
+        private:
+            struct Slot
+            {
+                std::vector<double> data;
+                size_t length = 0;
+                size_t readers = 0; // consumers still to read the buffer
+            };
+
+            std::vector<Slot> slots_;
+            const size_t consumers_;
+            std::mutex mutex_;
+            std::condition_variable data_ready_;
+            std::condition_variable slot_free_;
+            uint64_t published_;
+            bool finished_;
+            bool aborted_;
+        };
+
+        double seconds_since(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    } // namespace
+
+    std::vector<bool> run_pipelined(RandomGenerator &generator,
+                                    const std::vector<StreamingTest *> &tests,
+                                    uint64_t count,
+                                    double significance_level,
+                                    const PipelineOptions &options,
+                                    PipelineStats *stats)
+    {
+        if (options.buffer_size == 0 || options.buffer_count < 2)
+        {
+            throw std::invalid_argument("Pipeline needs at least two non-empty buffers");
+        }
+
+        size_t threads = options.test_threads;
+        if (threads == 0)
+            threads = std::max<size_t>(1, default_thread_count() - 1);
+        threads = std::max<size_t>(1, std::min(threads, tests.size()));
+
+        // Tests are dealt out to the stages round-robin
+        std::vector<std::vector<StreamingTest *>> stages(threads);
+        for (size_t i = 0; i < tests.size(); ++i)
+        {
+            tests[i]->reset();
+            stages[i % threads].push_back(tests[i]);
+        }
+
+        BufferRing ring(options.buffer_count, options.buffer_size, threads);
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<std::thread> workers;
+        for (size_t s = 0; s < threads; ++s)
+        {
+            workers.emplace_back([&ring, &stages, &errors, s]
+                                 {
+                try
+                {
+                    std::vector<ProbeId> probes = probes_for(stages[s], "test.update: ");
+                    const double *data;
+                    size_t length;
+                    for (uint64_t sequence = 0; ring.wait_for(sequence, data, length); ++sequence)
+                    {
+                        for (size_t t = 0; t < stages[s].size(); ++t)
+                        {
+                            RNG_TIMED_SCOPE(probes[t], length);
+                            stages[s][t]->update(data, length);
+                        }
+                        ring.release(sequence);
+                    }
+                }
+                catch (...)
+                {
+                    errors[s] = std::current_exception();
+                    ring.abort();
+                } });
+        }
+
+        static const ProbeId fill_probe = RNG_PROBE("generator.fill");
+        PipelineStats local;
+        local.test_threads = threads;
+        auto start = std::chrono::steady_clock::now();
+        std::exception_ptr producer_error;
+        try
+        {
+            uint64_t produced = 0;
+            for (uint64_t sequence = 0; produced < count; ++sequence)
+            {
+                auto wait_start = std::chrono::steady_clock::now();
+                double *buffer = ring.acquire(sequence);
+                local.stalled_seconds += seconds_since(wait_start);
+                if (buffer == nullptr)
+                    break;
+
+                auto fill_start = std::chrono::steady_clock::now();
+                size_t length = static_cast<size_t>(std::min<uint64_t>(options.buffer_size, count - produced));
+                {
+                    RNG_TIMED_SCOPE(fill_probe, length);
+                    generator.fill(buffer, length);
+                }
+                local.generate_seconds += seconds_since(fill_start);
+
+                ring.publish(sequence, length);
+                produced += length;
+                ++local.buffers_filled;
+            }
+            ring.finish();
+        }
+        catch (...)
+        {
+            producer_error = std::current_exception();
+            ring.abort();
+        }
+
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        if (producer_error)
+            std::rethrow_exception(producer_error);
+        for (const auto &error : errors)
+        {
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        std::vector<ProbeId> evaluate_probes = probes_for(tests, "test.evaluate: ");
+        std::vector<bool> verdicts;
+        for (size_t t = 0; t < tests.size(); ++t)
+        {
+            RNG_TIMED_SCOPE(evaluate_probes[t], 1);
+            verdicts.push_back(tests[t]->evaluate(significance_level));
+        }
+        local.elapsed_seconds = seconds_since(start);
+        if (stats != nullptr)
+            *stats = local;
+        return verdicts;
+    }
+
+} // namespace rng
@@ -0,0 +1,273 @@
+#include "../../include/engine/result_cache.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/serialization.hpp"
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rng
+{
+
+    namespace
+    {
+        const std::string CACHE_MAGIC = "RNGRCCH1";
+        // Records larger than this are taken as damage, not data
+        constexpr uint64_t MAX_RECORD_SIZE = 1 << 20;
+
+        uint64_t fnv1a(const std::string &data, uint64_t hash = 0xcbf29ce484222325ULL)
+        {
+            for (char c : data)
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 0x100000001b3ULL;
+            }
+            return hash;
+        }
+
+        std::pair<uint64_t, uint64_t> digest(const std::string &key)
+        {
+            uint64_t first = fnv1a(key);
+            uint64_t second = fnv1a(key, 0x84222325cbf29ce4ULL);
+            return {splitmix64(first), splitmix64(second)};
+        }
+
+        uint64_t read_u64_at(const std::string &data, size_t offset)
+        {
+            uint64_t value = 0;
+            for (int i = 0; i < 8; ++i)
+                value |= static_cast<uint64_t>(static_cast<unsigned char>(data[offset + i])) << (8 * i);
+            return value;
+        }
+
+#ifndef _WIN32
+        // Holds a flock() for the lifetime of the object
+        class FileLock
+        {
+        public:
+            FileLock(int fd, int operation) : fd_(fd)
+            {
+                if (::flock(fd_, operation) != 0)
+                    throw std::runtime_error("Cannot lock the result cache");
+            }
+            ~FileLock() { ::flock(fd_, LOCK_UN); }
+            FileLock(const FileLock &) = delete;
+            FileLock &operator=(const FileLock &) = delete;
+
+        private:
+            int fd_;
+        };
+
+        std::string read_range(int fd, uint64_t offset, uint64_t size)
+        {
+            std::string data(static_cast<size_t>(size), '\0');
+            size_t done = 0;
+            while (done < data.size())
+            {
+                ssize_t count = ::pread(fd, &data[done], data.size() - done, static_cast<off_t>(offset + done));
+                if (count < 0)
+                    throw std::runtime_error("Cannot read the result cache");
+                if (count == 0)
+                    break;
+                done += static_cast<size_t>(count);
+            }
+            data.resize(done);
+            return data;
+        }
+
+        uint64_t file_size(int fd)
+        {
+            struct stat info;
+            if (::fstat(fd, &info) != 0)
+                throw std::runtime_error("Cannot stat the result cache");
+            return static_cast<uint64_t>(info.st_size);
+        }
+#endif
+    } // namespace
+
+#ifndef _WIN32
+    ResultCache::ResultCache(const std::string &path)
+        : path_(path), fd_(-1), read_offset_(0)
+    {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (fd_ < 0)
+        {
+            throw std::runtime_error("Cannot open result cache " + path);
+        }
+
+        try
+        {
+            FileLock lock(fd_, LOCK_EX);
+            uint64_t size = file_size(fd_);
+            if (size == 0)
+            {
+                if (::write(fd_, CACHE_MAGIC.data(), CACHE_MAGIC.size()) != static_cast<ssize_t>(CACHE_MAGIC.size()))
+                    throw std::runtime_error("Cannot write result cache " + path);
+            }
+            else if (read_range(fd_, 0, CACHE_MAGIC.size()) != CACHE_MAGIC)
+            {
+                throw std::runtime_error(path + " is not a result cache");
+            }
+            read_offset_ = CACHE_MAGIC.size();
+
+            std::lock_guard<std::mutex> guard(mutex_);
+            catch_up();
+            // Whatever follows the last whole record was cut short by a crash
+            if (file_size(fd_) > read_offset_ && ::ftruncate(fd_, static_cast<off_t>(read_offset_)) != 0)
+                throw std::runtime_error("Cannot repair result cache " + path);
+        }
+        catch (...)
+        {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    ResultCache::~ResultCache()
+    {
+        ::close(fd_);
+    }
+
+    void ResultCache::catch_up()
+    {
+        uint64_t size = file_size(fd_);
+        if (size <= read_offset_)
+            return;
+        std::string data = read_range(fd_, read_offset_, size - read_offset_);
+
+        size_t offset = 0;
+        while (data.size() - offset >= 8)
+        {
+            uint64_t length = read_u64_at(data, offset);
+            if (length > MAX_RECORD_SIZE || data.size() - offset - 8 < length + 8)
+                break;
+            std::string payload = data.substr(offset + 8, static_cast<size_t>(length));
+            if (read_u64_at(data, offset + 8 + length) != fnv1a(payload))
+                break;
+
+            BinaryReader reader(payload);
+            std::pair<uint64_t, uint64_t> key_digest;
+            key_digest.first = reader.read_u64();
+            key_digest.second = reader.read_u64();
+            Entry entry;
+            entry.key = reader.read_string();
+            entry.result.p_value = reader.read_f64();
+            entry.result.passed = reader.read_bool();
+            entry.result.seconds = reader.read_f64();
+            index_[key_digest] = std::move(entry);
+            offset += 16 + static_cast<size_t>(length);
+        }
+        read_offset_ += offset;
+    }
+
+    bool ResultCache::lookup(const std::string &key, CachedResult &result)
+    {
+        std::pair<uint64_t, uint64_t> key_digest = digest(key);
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto found = index_.find(key_digest);
+        if (found == index_.end())
+        {
+            FileLock lock(fd_, LOCK_SH);
+            catch_up();
+            found = index_.find(key_digest);
+        }
+        if (found == index_.end() || found->second.key != key)
+            return false;
+        result = found->second.result;
+        return true;
+    }
+
+    void ResultCache::store(const std::string &key, const CachedResult &result)
+    {
+        std::pair<uint64_t, uint64_t> key_digest = digest(key);
+        BinaryWriter payload;
+        payload.write_u64(key_digest.first);
+        payload.write_u64(key_digest.second);
+        payload.write_string(key);
+        payload.write_f64(result.p_value);
+        payload.write_bool(result.passed);
+        payload.write_f64(result.seconds);
+
+        BinaryWriter record;
+        record.write_u64(payload.data().size());
+        std::string bytes = record.data() + payload.data();
+        BinaryWriter trailer;
+        trailer.write_u64(fnv1a(payload.data()));
+        bytes += trailer.data();
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        FileLock lock(fd_, LOCK_EX);
+        // Records of other writers first, so read_offset_ can move past ours.
+        // Nobody else writes while we hold the lock, so bytes catch_up()
+        // could not parse were left by a writer that crashed; they would
+        // hide every later record and are cut off as on opening.
+        catch_up();
+        if (file_size(fd_) > read_offset_ && ::ftruncate(fd_, static_cast<off_t>(read_offset_)) != 0)
+            throw std::runtime_error("Cannot repair result cache " + path_);
+        ssize_t written = ::write(fd_, bytes.data(), bytes.size());
+        if (written != static_cast<ssize_t>(bytes.size()))
+        {
+            throw std::runtime_error("Cannot append to result cache " + path_);
+        }
+        // O_APPEND leaves the offset at the end of our record
+        off_t end = ::lseek(fd_, 0, SEEK_CUR);
+        if (end < 0)
+            throw std::runtime_error("Cannot read the result cache position");
+        read_offset_ = static_cast<uint64_t>(end);
+        index_[key_digest] = Entry{key, result};
+    }
+#else
+    ResultCache::ResultCache(const std::string &path)
+        : path_(path), fd_(-1), read_offset_(0)
+    {
+        throw std::runtime_error("The result cache needs POSIX file locking");
+    }
+
+    ResultCache::~ResultCache() {}
+
+    void ResultCache::catch_up() {}
+
+    bool ResultCache::lookup(const std::string &, CachedResult &)
+    {
+        return false;
+    }
+
+    void ResultCache::store(const std::string &, const CachedResult &) {}
+#endif
+
+    size_t ResultCache::size() const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return index_.size();
+    }
+
+    std::string generator_fingerprint(const RandomGenerator &generator)
+    {
+        std::stringstream ss;
+        ss << generator.get_name() << "|state:" << std::hex;
+        for (uint64_t word : generator.get_state())
+            ss << word << ',';
+
+        std::unique_ptr<RandomGenerator> copy = generator.clone();
+        BinaryWriter outputs;
+        for (int i = 0; i < 64; ++i)
+            outputs.write_u64(copy->generate_raw());
+        ss << "|outputs:" << fnv1a(outputs.data());
+        return ss.str();
+    }
+
+    std::string make_cache_key(const std::string &generator_fingerprint, uint64_t offset, uint64_t length,
+                               const std::string &test_config, double significance_level)
+    {
+        std::stringstream ss;
+        ss << generator_fingerprint << "|offset:" << offset << "|length:" << length << "|test:" << test_config
+           << "|alpha:" << std::setprecision(17) << significance_level;
+        return ss.str();
+    }
+
+} // namespace rng
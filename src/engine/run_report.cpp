@@ -0,0 +1,62 @@
+#include "../../include/engine/run_report.hpp"
+#include "../../include/utils/instrumentation.hpp"
+#include "../../include/utils/cpu_dispatch.hpp"
+#include "../../include/utils/json_writer.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace rng
+{
+
+    void write_run_report(std::ostream &out, const RunReport &report)
+    {
+        JsonWriter json(out);
+        json.begin_object()
+            .field("generator", report.generator_name)
+            .field("seed", report.seed)
+            .field("sequence_length", report.sequence_length)
+            .field("significance_level", report.significance_level)
+            .field("wall_seconds", report.wall_seconds)
+            .field("cpu_level", cpu_level_name(selected_cpu_level()));
+
+        if (report.verdicts.size() != report.tests.size())
+        {
+            throw std::invalid_argument("Run report needs one verdict per test");
+        }
+        json.key("tests").begin_array();
+        for (size_t i = 0; i < report.tests.size(); ++i)
+        {
+            const RandomnessTest *test = report.tests[i];
+            json.begin_object()
+                .field("name", test->get_test_name())
+                .field("p_value", test->get_p_value())
+                .field("passed", static_cast<bool>(report.verdicts[i]))
+                .field("result", test->get_test_result())
+                .end_object();
+        }
+        json.end_array();
+
+        json.key("instrumentation").begin_object();
+        json.field("enabled", instrumentation_enabled());
+        json.key("probes").begin_array();
+        for (const ProbeTotals &probe : instrumentation_snapshot())
+        {
+            if (probe.calls == 0)
+                continue;
+            json.begin_object()
+                .field("name", probe.name)
+                .field("calls", probe.calls)
+                .field("seconds", probe.nanoseconds * 1e-9)
+                .field("items", probe.items)
+                .field("ns_per_item", probe.items > 0 ? static_cast<double>(probe.nanoseconds) / probe.items : NAN)
+                .field("threads", probe.threads)
+                .end_object();
+        }
+        json.end_array();
+        json.end_object();
+
+        json.end_object();
+        out << "\n";
+    }
+
+} // namespace rng
@@ -0,0 +1,144 @@
+#include "../../include/engine/second_level.hpp"
+#include "../../include/tests/randomness_tests.hpp"
+#include "../../include/tests/edf_tests.hpp"
+#include "../../include/utils/parallel.hpp"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    std::vector<SecondLevelResult> run_second_level(const RandomGenerator &prototype,
+                                                    const TestSuiteFactory &make_tests,
+                                                    const SecondLevelOptions &options)
+    {
+        if (options.replications < 2)
+        {
+            throw std::invalid_argument("At least two replications are required");
+        }
+
+        std::vector<SecondLevelResult> results;
+        for (const auto &test : make_tests())
+        {
+            SecondLevelResult result;
+            result.test_name = test->get_test_name();
+            result.p_values.assign(options.replications, std::numeric_limits<double>::quiet_NaN());
+            results.push_back(std::move(result));
+        }
+
+        const size_t threads = options.num_threads == 0 ? default_thread_count() : options.num_threads;
+        std::vector<std::vector<size_t>> failures(threads, std::vector<size_t>(results.size(), 0));
+        // The thread budget is shared between the shards and the tests inside them
+        const size_t shards = std::max<size_t>(1, std::min(threads, options.replications));
+        const size_t threads_per_shard = std::max<size_t>(1, threads / shards);
+
+        parallel_for_shards(options.replications, threads, [&](size_t shard, size_t begin, size_t end)
+                            {
+            ScopedThreadLimit limit(threads_per_shard);
+            std::unique_ptr<RandomGenerator> generator = prototype.clone();
+            std::vector<std::unique_ptr<RandomnessTest>> tests = make_tests();
+
+            // Consecutive substreams follow each other, so only the first needs a jump
+            if (options.mode == ReplicationMode::Substreams)
+                generator->jump_ahead(static_cast<uint64_t>(begin) * options.sample_size);
+
+            for (size_t r = begin; r < end; ++r)
+            {
+                if (options.mode == ReplicationMode::DistinctSeeds)
+                    generator->set_seed(options.base_seed + r);
+
+                std::vector<double> numbers = generator->generate_sequence(options.sample_size);
+                for (size_t t = 0; t < tests.size(); ++t)
+                {
+                    if (!tests[t]->run_test(numbers, options.significance_level))
+                        failures[shard][t]++;
+                    results[t].p_values[r] = tests[t]->get_p_value();
+                }
+            } });
+
+        for (size_t t = 0; t < results.size(); ++t)
+        {
+            SecondLevelResult &result = results[t];
+            for (const auto &shard : failures)
+                result.first_level_failures += shard[t];
+
+            std::vector<double> valid;
+            for (double p : result.p_values)
+            {
+                if (!std::isnan(p))
+                    valid.push_back(p);
+            }
+            if (valid.size() < 2)
+            {
+                result.ks_p_value = result.chi_square_p_value = result.combined_p_value = 0.0;
+                result.verdict = SecondLevelVerdict::Fail;
+                continue;
+            }
+
+            KolmogorovSmirnovTest ks(EdfMode::Exact, 2, 1);
+            ks.run_test(valid, options.suspicious_level);
+            result.ks_p_value = ks.get_p_value();
+
+            size_t bins = std::min<size_t>(10, std::max<size_t>(2, valid.size() / 5));
+            ChiSquareTest chi_square(bins);
+            chi_square.run_test(valid, options.suspicious_level);
+            result.chi_square_p_value = chi_square.get_p_value();
+
+            // Kolmogorov-Smirnov statistic itself, for the report
+            std::vector<double> sorted = valid;
+            std::sort(sorted.begin(), sorted.end());
+            double d = 0.0;
+            for (size_t i = 0; i < sorted.size(); ++i)
+            {
+                d = std::max(d, std::max((i + 1.0) / sorted.size() - sorted[i], sorted[i] - static_cast<double>(i) / sorted.size()));
+            }
+            result.ks_statistic = d;
+
+            result.combined_p_value = std::min(1.0, 2.0 * std::min(result.ks_p_value, result.chi_square_p_value));
+            if (result.combined_p_value < options.failure_level)
+                result.verdict = SecondLevelVerdict::Fail;
+            else if (result.combined_p_value < options.suspicious_level)
+                result.verdict = SecondLevelVerdict::Suspicious;
+            else
+                result.verdict = SecondLevelVerdict::Pass;
+        }
+
+        return results;
+    }
+
+    std::string verdict_to_string(SecondLevelVerdict verdict)
+    {
+        switch (verdict)
+        {
+        case SecondLevelVerdict::Pass:
+            return "PASSED";
+        case SecondLevelVerdict::Suspicious:
+            return "SUSPICIOUS";
+        default:
+            return "FAILED";
+        }
+    }
+
+    std::string format_second_level(const std::vector<SecondLevelResult> &results)
+    {
+        std::stringstream ss;
+        for (const auto &result : results)
+        {
+            ss << result.test_name
+               << "\n  Replications: " << result.p_values.size()
+               << ", first-level failures: " << result.first_level_failures
+               << std::fixed << std::setprecision(4)
+               << "\n  KS statistic of p-values: " << result.ks_statistic
+               << " (p = " << result.ks_p_value << ")"
+               << "\n  Chi-square p-value of p-values: " << result.chi_square_p_value
+               << "\n  Combined p-value: " << result.combined_p_value
+               << "\n  Verdict: " << verdict_to_string(result.verdict) << "\n\n";
+        }
+        return ss.str();
+    }
+
+} // namespace rng
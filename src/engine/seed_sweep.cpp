@@ -0,0 +1,182 @@
+#include "../../include/engine/seed_sweep.hpp"
+#include "../../include/utils/parallel.hpp"
+#include "../../include/utils/thread_pool.hpp"
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Reusable state of one pool worker
+        struct WorkerContext
+        {
+            std::vector<std::unique_ptr<RandomGenerator>> generators; // one clone per swept generator
+            std::vector<std::unique_ptr<RandomnessTest>> tests;
+            std::vector<double> sample;
+            std::vector<SeedRangeSummary> ranges; // merged after the sweep
+        };
+    } // namespace
+
+    SeedSweepReport run_seed_sweep(const std::vector<const RandomGenerator *> &generators,
+                                   const TestSuiteFactory &make_tests,
+                                   const SeedSweepOptions &options,
+                                   std::ostream *out)
+    {
+        if (options.seed_count == 0 || options.seeds_per_job == 0 || options.seeds_per_range == 0)
+        {
+            throw std::invalid_argument("Seed count, seeds per job and seeds per range must be positive");
+        }
+
+        const uint64_t range_count = (options.seed_count + options.seeds_per_range - 1) / options.seeds_per_range;
+        WorkStealingPool pool(options.num_threads);
+        std::vector<WorkerContext> contexts(pool.size());
+        for (auto &context : contexts)
+        {
+            for (const RandomGenerator *generator : generators)
+            {
+                context.generators.push_back(generator->clone());
+            }
+            // Every pool thread already runs its own tests; threaded tests get
+            // one thread each so the sweep stays at the pool size
+            ScopedThreadLimit limit(1);
+            context.tests = make_tests();
+            context.sample.resize(options.sample_size);
+            context.ranges.resize(generators.size() * range_count);
+        }
+
+        SeedSweepReport report;
+        report.tests_per_seed = contexts.empty() ? 0 : contexts[0].tests.size();
+
+        std::mutex output_mutex;
+        if (out != nullptr)
+        {
+            *out << "generator,seed,status,failed_tests,min_p_value\n";
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (size_t g = 0; g < generators.size(); ++g)
+        {
+            for (uint64_t offset = 0; offset < options.seed_count; offset += options.seeds_per_job)
+            {
+                uint64_t job_end = std::min(options.seed_count, offset + options.seeds_per_job);
+                pool.submit([&, g, offset, job_end](size_t worker)
+                            {
+                    WorkerContext &context = contexts[worker];
+                    RandomGenerator &generator = *context.generators[g];
+                    std::ostringstream lines;
+
+                    for (uint64_t i = offset; i < job_end; ++i)
+                    {
+                        uint64_t seed = options.first_seed + i;
+                        SeedRangeSummary &range = context.ranges[g * range_count + i / options.seeds_per_range];
+                        range.seeds++;
+
+                        try
+                        {
+                            generator.set_seed(seed);
+                        }
+                        catch (const std::invalid_argument &)
+                        {
+                            range.invalid_seeds++;
+                            lines << generator.get_name() << ',' << seed << ",invalid,0,\n";
+                            continue;
+                        }
+
+                        for (double &number : context.sample)
+                            number = generator.generate();
+
+                        size_t failed = 0;
+                        double min_p_value = 1.0;
+                        for (auto &test : context.tests)
+                        {
+                            if (!test->run_test(context.sample, options.significance_level))
+                                failed++;
+                            double p_value = test->get_p_value();
+                            if (!std::isnan(p_value))
+                                min_p_value = std::min(min_p_value, p_value);
+                        }
+                        if (failed > 0)
+                            range.failed_seeds++;
+
+                        lines << generator.get_name() << ',' << seed << ','
+                              << (failed > 0 ? "fail" : "pass") << ',' << failed << ','
+                              << min_p_value << '\n';
+                    }
+
+                    if (out != nullptr)
+                    {
+                        std::lock_guard<std::mutex> lock(output_mutex);
+                        *out << lines.str();
+                        out->flush();
+                    } });
+            }
+        }
+        pool.wait();
+
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (size_t g = 0; g < generators.size(); ++g)
+        {
+            for (uint64_t r = 0; r < range_count; ++r)
+            {
+                SeedRangeSummary summary;
+                summary.generator_name = generators[g]->get_name();
+                summary.first_seed = options.first_seed + r * options.seeds_per_range;
+                for (const auto &context : contexts)
+                {
+                    const SeedRangeSummary &part = context.ranges[g * range_count + r];
+                    summary.seeds += part.seeds;
+                    summary.failed_seeds += part.failed_seeds;
+                    summary.invalid_seeds += part.invalid_seeds;
+                }
+                report.ranges.push_back(summary);
+            }
+        }
+
+        report.seeds_tested = options.seed_count * generators.size();
+        report.elapsed_seconds = elapsed;
+        report.seeds_per_second = elapsed > 0.0 ? report.seeds_tested / elapsed : 0.0;
+        report.numbers_per_second = report.seeds_per_second * options.sample_size;
+        return report;
+    }
+
+    std::string format_seed_sweep(const SeedSweepReport &report, double significance_level)
+    {
+        double expected = 1.0 - std::pow(1.0 - significance_level, static_cast<double>(report.tests_per_seed));
+
+        std::stringstream ss;
+        ss << "Seeds tested: " << report.seeds_tested
+           << " in " << std::fixed << std::setprecision(2) << report.elapsed_seconds << " s"
+           << "\nThroughput: " << report.seeds_per_second << " seeds/s, "
+           << std::setprecision(0) << report.numbers_per_second << " numbers/s"
+           << std::setprecision(4)
+           << "\nExpected failure rate for a good generator (" << report.tests_per_seed
+           << " tests): " << expected << "\n\n";
+
+        for (const auto &range : report.ranges)
+        {
+            uint64_t valid = range.seeds - range.invalid_seeds;
+            double rate = valid > 0 ? static_cast<double>(range.failed_seeds) / valid : 0.0;
+            ss << range.generator_name << " seeds " << range.first_seed << "-"
+               << range.first_seed + range.seeds - 1
+               << ": failure rate " << rate
+               << " (" << range.failed_seeds << "/" << valid << ")";
+            if (range.invalid_seeds > 0)
+                ss << ", " << range.invalid_seeds << " invalid";
+            if (valid > 0 && rate > expected + 3.0 * std::sqrt(expected * (1.0 - expected) / valid))
+                ss << "  <-- elevated";
+            ss << '\n';
+        }
+        return ss.str();
+    }
+
+} // namespace rng
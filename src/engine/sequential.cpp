@@ -0,0 +1,171 @@
+#include "../../include/engine/sequential.hpp"
+#include "../../include/engine/fused_runner.hpp"
+#include "../../include/tests/statistics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Numbers generated at a time; the time budget is checked between blocks
+        constexpr size_t BLOCK_SIZE = 1 << 20;
+
+        std::string verdict_to_string(SequentialVerdict verdict)
+        {
+            switch (verdict)
+            {
+            case SequentialVerdict::Pass:
+                return "PASS";
+            case SequentialVerdict::Fail:
+                return "FAIL";
+            default:
+                return "INCONCLUSIVE";
+            }
+        }
+    } // namespace
+
+    double alpha_spent(SpendingFunction spending, double alpha, double t)
+    {
+        if (t <= 0.0)
+            return 0.0;
+        if (t >= 1.0)
+            return alpha;
+        if (spending == SpendingFunction::Pocock)
+            return alpha * std::log(1.0 + (std::exp(1.0) - 1.0) * t);
+        return 2.0 - 2.0 * normal_cdf(normal_quantile(1.0 - alpha / 2.0) / std::sqrt(t));
+    }
+
+    SequentialReport run_sequential(RandomGenerator &generator,
+                                    const std::vector<StreamingTest *> &tests,
+                                    const SequentialOptions &options)
+    {
+        if (options.max_numbers == 0 || options.first_look == 0)
+        {
+            throw std::invalid_argument("Sequential runs need a positive length and first look");
+        }
+        if (!(options.growth > 1.0))
+        {
+            throw std::invalid_argument("Look sizes must grow by a factor above 1");
+        }
+        if (!(options.significance_level > 0.0 && options.significance_level < 1.0))
+        {
+            throw std::invalid_argument("Significance level must be in (0, 1)");
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = [&start]()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        SequentialReport report;
+        std::vector<size_t> open;
+        for (size_t t = 0; t < tests.size(); ++t)
+        {
+            tests[t]->reset();
+            SequentialTestResult result;
+            result.test_name = tests[t]->get_test_name();
+            report.tests.push_back(result);
+            open.push_back(t);
+        }
+
+        std::vector<double> block(static_cast<size_t>(std::min<uint64_t>(BLOCK_SIZE, options.max_numbers)));
+        uint64_t seen = 0;
+        uint64_t next_look = std::min(options.first_look, options.max_numbers);
+        double spent_before = 0.0;
+        bool failed = false;
+
+        while (!open.empty())
+        {
+            std::vector<StreamingTest *> active;
+            for (size_t t : open)
+                active.push_back(tests[t]);
+
+            while (seen < next_look && !report.time_budget_exhausted)
+            {
+                size_t count = static_cast<size_t>(std::min<uint64_t>(block.size(), next_look - seen));
+                generator.fill(block.data(), count);
+                feed_fused(active, block.data(), count, options.num_threads);
+                seen += count;
+                if (options.time_budget_seconds > 0.0 && elapsed() >= options.time_budget_seconds &&
+                    seen < options.max_numbers)
+                    report.time_budget_exhausted = true;
+            }
+
+            bool last = seen >= options.max_numbers;
+            double spent = last ? options.significance_level
+                                : alpha_spent(options.spending, options.significance_level,
+                                              static_cast<double>(seen) / options.max_numbers);
+            double threshold = spent - spent_before;
+            spent_before = spent;
+            ++report.looks;
+
+            std::vector<size_t> still_open;
+            for (size_t t : open)
+            {
+                tests[t]->evaluate(threshold);
+                SequentialTestResult &result = report.tests[t];
+                result.p_value = tests[t]->get_p_value();
+                result.threshold = threshold;
+                result.decided_at = seen;
+                if (!std::isnan(result.p_value) && result.p_value <= threshold)
+                {
+                    result.verdict = SequentialVerdict::Fail;
+                    failed = true;
+                }
+                else if (last && !std::isnan(result.p_value))
+                {
+                    result.verdict = SequentialVerdict::Pass;
+                }
+                else if (!last)
+                {
+                    still_open.push_back(t);
+                }
+            }
+            open = std::move(still_open);
+
+            if (last || report.time_budget_exhausted || (failed && options.stop_at_first_failure))
+                break;
+            next_look = std::min<uint64_t>(
+                options.max_numbers,
+                std::max<uint64_t>(seen + 1, static_cast<uint64_t>(std::ceil(seen * options.growth))));
+        }
+
+        report.numbers_used = seen;
+        report.elapsed_seconds = elapsed();
+        bool all_passed = true;
+        for (const auto &result : report.tests)
+            all_passed = all_passed && result.verdict == SequentialVerdict::Pass;
+        report.verdict = failed ? SequentialVerdict::Fail
+                                : (all_passed ? SequentialVerdict::Pass : SequentialVerdict::Inconclusive);
+        return report;
+    }
+
+    std::string format_sequential(const SequentialReport &report)
+    {
+        std::stringstream ss;
+        ss << "Verdict: " << verdict_to_string(report.verdict) << " after " << report.numbers_used
+           << " numbers, " << report.looks << " looks, " << std::fixed << std::setprecision(3)
+           << report.elapsed_seconds << " s";
+        if (report.time_budget_exhausted)
+            ss << " (time budget exhausted)";
+        ss << "\n\n";
+        for (const auto &result : report.tests)
+        {
+            ss << result.test_name
+               << "\n  Verdict: " << verdict_to_string(result.verdict)
+               << " at " << result.decided_at << " numbers"
+               << std::scientific << std::setprecision(3)
+               << "\n  P-value: " << result.p_value << " (level spent at this look: " << result.threshold << ")"
+               << std::defaultfloat << "\n\n";
+        }
+        return ss.str();
+    }
+
+} // namespace rng
@@ -0,0 +1,33 @@
+#include "../../include/generators/combined.hpp"
+
+namespace rng
+{
+
+    MRG32k3a make_mrg32k3a()
+    {
+        constexpr uint64_t m1 = 4294967087ULL;
+        constexpr uint64_t m2 = 4294944443ULL;
+
+        // x_n = 1403580 x_(n-2) - 810728 x_(n-3) mod m1
+        MRG first({12345, 12345, 12345}, {0, 1403580, m1 - 810728}, m1);
+        // y_n = 527612 y_(n-1) - 1370589 y_(n-3) mod m2
+        MRG second({12345, 12345, 12345}, {527612, 0, m2 - 1370589}, m2);
+        return MRG32k3a("MRG32k3a (combined MRG)", first, second);
+    }
+
+    MRG32k3a make_mrg32k3a(uint64_t seed)
+    {
+        MRG32k3a generator = make_mrg32k3a();
+        generator.set_seed(seed);
+        return generator;
+    }
+
+    WichmannHill make_wichmann_hill(uint64_t seed)
+    {
+        WichmannHill generator("Wichmann-Hill (combined MCG)",
+                               MCG(1, 171, 30269), MCG(1, 172, 30307), MCG(1, 170, 30323));
+        generator.set_seed(seed);
+        return generator;
+    }
+
+} // namespace rng
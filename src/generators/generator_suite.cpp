@@ -0,0 +1,63 @@
+#include "../../include/generators/generator_suite.hpp"
+#include "../../include/generators/icg.hpp"
+#include "../../include/generators/mrg.hpp"
+#include "../../include/generators/lfg.hpp"
+#include "../../include/generators/msm.hpp"
+#include "../../include/generators/lcg.hpp"
+#include "../../include/generators/mcg.hpp"
+#include "../../include/generators/combined.hpp"
+#include "../../include/distributions/transformed_generator.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace rng
+{
+
+    std::vector<std::unique_ptr<RandomGenerator>> create_generator_suite()
+    {
+        std::vector<std::unique_ptr<RandomGenerator>> generators;
+        generators.push_back(std::make_unique<ICG>());
+        generators.push_back(std::make_unique<MRG>(std::vector<uint64_t>{1, 2, 3}, std::vector<uint64_t>{1, 1, 1}));
+        generators.push_back(std::make_unique<LFG>(1, 3, 7));
+        generators.push_back(std::make_unique<MSM>(12345));
+        generators.push_back(std::make_unique<LCG>());
+        generators.push_back(std::make_unique<MCG>());
+        generators.push_back(std::make_unique<MRG32k3a>(make_mrg32k3a()));
+        generators.push_back(std::make_unique<WichmannHill>(make_wichmann_hill(12345)));
+        generators.push_back(std::make_unique<MultiStreamICG>(12345));
+
+        // Samplers, tested through their probability integral transform
+        generators.push_back(std::make_unique<TransformedGenerator>(
+            std::make_unique<MCG>(), std::make_unique<NormalDistribution>()));
+        generators.push_back(std::make_unique<TransformedGenerator>(
+            std::make_unique<MCG>(), std::make_unique<ExponentialDistribution>()));
+        generators.push_back(std::make_unique<TransformedGenerator>(
+            std::make_unique<MCG>(), std::make_unique<GammaDistribution>(2.5)));
+        generators.push_back(std::make_unique<TransformedGenerator>(
+            std::make_unique<MCG>(), std::make_unique<PoissonDistribution>(4.0)));
+        generators.push_back(std::make_unique<TransformedGenerator>(
+            std::make_unique<MCG>(), std::make_unique<BinomialDistribution>(20, 0.3)));
+        return generators;
+    }
+
+    const std::vector<std::string> &generator_suite_keys()
+    {
+        static const std::vector<std::string> keys = {
+            "icg", "mrg", "lfg", "msm", "lcg", "mcg", "mrg32k3a", "wichmann-hill", "multistream-icg",
+            "normal", "exponential", "gamma", "poisson", "binomial"};
+        return keys;
+    }
+
+    std::unique_ptr<RandomGenerator> create_generator(const std::string &key)
+    {
+        const std::vector<std::string> &keys = generator_suite_keys();
+        auto found = std::find(keys.begin(), keys.end(), key);
+        if (found == keys.end())
+        {
+            throw std::invalid_argument("Unknown generator kind " + key);
+        }
+        auto generators = create_generator_suite();
+        return std::move(generators[static_cast<size_t>(found - keys.begin())]);
+    }
+
+} // namespace rng
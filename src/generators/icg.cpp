@@ -1,6 +1,8 @@
 #include "../../include/generators/icg.hpp"
+#include "../../include/utils/bits.hpp"
 #include <stdexcept>
 #include <numeric>
+#include <algorithm>
 
 namespace rng
 {
@@ -26,7 +28,7 @@ namespace rng
         }
     }
 
-    double ICG::generate()
+    uint64_t ICG::generate_raw()
     {
         if (current_ == 0)
         {
@@ -38,20 +40,34 @@ namespace rng
 
         // Apply ICG formula: x_(n+1) = (a * inverse(x_n) + b) mod m
         current_ = (a_ * inverse + b_) % m_;
+        return current_;
+    }
 
+    double ICG::generate()
+    {
         // Normalize to [0,1)
-        return static_cast<double>(current_) / m_;
+        return static_cast<double>(generate_raw()) / m_;
+    }
+
+    unsigned ICG::raw_bits() const
+    {
+        return floor_log2(m_);
     }
 
     std::vector<double> ICG::generate_sequence(size_t count)
     {
-        std::vector<double> sequence;
-        sequence.reserve(count);
+        std::vector<double> sequence(count);
+        fill(sequence.data(), count);
+        return sequence;
+    }
+
+    void ICG::fill(double *out, size_t count)
+    {
+        // Qualified call skips the virtual dispatch of generate()
         for (size_t i = 0; i < count; ++i)
         {
-            sequence.push_back(generate());
+            out[i] = ICG::generate();
         }
-        return sequence;
     }
 
     std::string ICG::get_name() const
@@ -97,4 +113,167 @@ namespace rng
         return static_cast<uint64_t>(t);
     }
 
-} // namespace rng
\ No newline at end of file
+    std::unique_ptr<RandomGenerator> ICG::clone() const
+    {
+        return std::make_unique<ICG>(*this);
+    }
+
+    std::vector<uint64_t> ICG::get_state() const
+    {
+        return {current_};
+    }
+
+    void ICG::set_state(const std::vector<uint64_t> &state)
+    {
+        if (state.size() != 1)
+        {
+            throw std::invalid_argument("ICG state is a single word");
+        }
+        if (state[0] >= m_)
+        {
+            throw std::invalid_argument("State must be less than modulus");
+        }
+        current_ = state[0];
+    }
+
+
+    MultiStreamICG::MultiStreamICG(uint64_t seed, size_t streams, uint64_t a, uint64_t b, uint64_t m)
+        : states_(streams), prefix_(streams), position_(streams), a_(a), b_(b), m_(m), reducer_(m == 0 ? 1 : m)
+    {
+        if (streams == 0)
+        {
+            throw std::invalid_argument("Need at least one stream");
+        }
+        if (m_ < 3 || m_ % 2 == 0 || m_ > 0xffffffffULL)
+        {
+            throw std::invalid_argument("Modulus must be odd and between 3 and 2^32 - 1");
+        }
+        if (a_ >= m_)
+        {
+            throw std::invalid_argument("Multiplier must be less than modulus");
+        }
+        if (b_ >= m_)
+        {
+            throw std::invalid_argument("Increment must be less than modulus");
+        }
+        set_seed(seed);
+    }
+
+    void MultiStreamICG::step()
+    {
+        const size_t n = states_.size();
+
+        // Zero has no inverse; like ICG, a stream at zero continues from one
+        uint64_t product = 1;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (states_[i] == 0)
+                states_[i] = 1;
+            product = reducer_.mul(product, states_[i]);
+            prefix_[i] = product;
+        }
+
+        uint64_t inverse = inverse_mod_odd(product, m_);
+        if (inverse == 0)
+        {
+            throw std::runtime_error("Multiplicative inverse does not exist");
+        }
+
+        // Walking back, inverse holds 1 / (x_0 ... x_i) before stream i
+        for (size_t i = n - 1; i > 0; --i)
+        {
+            uint64_t own = reducer_.mul(inverse, prefix_[i - 1]);
+            inverse = reducer_.mul(inverse, states_[i]);
+            states_[i] = reducer_.reduce(reducer_.mul(a_, own) + b_);
+        }
+        states_[0] = reducer_.reduce(reducer_.mul(a_, inverse) + b_);
+        position_ = 0;
+    }
+
+    uint64_t MultiStreamICG::generate_raw()
+    {
+        if (position_ == states_.size())
+            step();
+        return states_[position_++];
+    }
+
+    double MultiStreamICG::generate()
+    {
+        return static_cast<double>(generate_raw()) / m_;
+    }
+
+    void MultiStreamICG::fill(double *out, size_t count)
+    {
+        const double m = static_cast<double>(m_);
+        size_t done = 0;
+        while (done < count)
+        {
+            if (position_ == states_.size())
+                step();
+            size_t take = std::min(states_.size() - position_, count - done);
+            for (size_t i = 0; i < take; ++i)
+                out[done + i] = static_cast<double>(states_[position_ + i]) / m;
+            position_ += take;
+            done += take;
+        }
+    }
+
+    std::vector<double> MultiStreamICG::generate_sequence(size_t count)
+    {
+        std::vector<double> sequence(count);
+        fill(sequence.data(), count);
+        return sequence;
+    }
+
+    std::string MultiStreamICG::get_name() const
+    {
+        return "Multi-stream ICG (" + std::to_string(states_.size()) + " streams)";
+    }
+
+    void MultiStreamICG::set_seed(uint64_t seed)
+    {
+        uint64_t mix = seed;
+        for (uint64_t &state : states_)
+            state = splitmix64(mix) % m_;
+        position_ = states_.size();
+    }
+
+    unsigned MultiStreamICG::raw_bits() const
+    {
+        return floor_log2(m_);
+    }
+
+    std::unique_ptr<RandomGenerator> MultiStreamICG::clone() const
+    {
+        return std::make_unique<MultiStreamICG>(*this);
+    }
+
+    std::vector<uint64_t> MultiStreamICG::get_state() const
+    {
+        std::vector<uint64_t> state;
+        state.reserve(states_.size() + 1);
+        state.push_back(position_);
+        state.insert(state.end(), states_.begin(), states_.end());
+        return state;
+    }
+
+    void MultiStreamICG::set_state(const std::vector<uint64_t> &state)
+    {
+        if (state.size() != states_.size() + 1)
+        {
+            throw std::invalid_argument("Multi-stream ICG state is the position and one word per stream");
+        }
+        if (state[0] > states_.size())
+        {
+            throw std::invalid_argument("Position is past the last stream");
+        }
+        for (size_t i = 1; i < state.size(); ++i)
+        {
+            if (state[i] >= m_)
+                throw std::invalid_argument("State must be less than modulus");
+        }
+        position_ = static_cast<size_t>(state[0]);
+        std::copy(state.begin() + 1, state.end(), states_.begin());
+    }
+
+} // namespace rng
@@ -1,4 +1,6 @@
 #include "../../include/generators/lcg.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/modular.hpp"
 #include <stdexcept>
 
 namespace rng
@@ -51,28 +53,47 @@ namespace rng
 
             // 2. a-1 is divisible by all prime factors of m
             // 3. a-1 is divisible by 4 if m is divisible by 4
-            // These conditions are assumed to be satisfied by the default parameters
+            // These only decide whether the period is full, so they are not
+            // enforced here; analyze_lcg() (engine/period_analysis) reports them
         }
     }
 
-    double LCG::generate()
+    uint64_t LCG::generate_raw()
     {
-        // Apply the LCG formula: x_(n+1) = (a * x_n + c) mod m
-        current_ = (a_ * current_ + c_) % m_;
+        // Apply the LCG formula: x_(n+1) = (a * x_n + c) mod m; a * x_n + c
+        // only fits in 64 bits for m <= 2^32
+        if (m_ <= (1ULL << 32))
+            current_ = (a_ * current_ + c_) % m_;
+        else
+            current_ = add_mod(mul_mod(a_, current_, m_), c_, m_);
+        return current_;
+    }
 
+    double LCG::generate()
+    {
         // Normalize to [0,1)
-        return static_cast<double>(current_) / m_;
+        return static_cast<double>(generate_raw()) / m_;
+    }
+
+    unsigned LCG::raw_bits() const
+    {
+        return floor_log2(m_);
     }
 
     std::vector<double> LCG::generate_sequence(size_t count)
     {
-        std::vector<double> sequence;
-        sequence.reserve(count);
+        std::vector<double> sequence(count);
+        fill(sequence.data(), count);
+        return sequence;
+    }
+
+    void LCG::fill(double *out, size_t count)
+    {
+        // Qualified call skips the virtual dispatch of generate()
         for (size_t i = 0; i < count; ++i)
         {
-            sequence.push_back(generate());
+            out[i] = LCG::generate();
         }
-        return sequence;
     }
 
     std::string LCG::get_name() const
@@ -89,4 +110,51 @@ namespace rng
         current_ = seed;
     }
 
+    std::unique_ptr<RandomGenerator> LCG::clone() const
+    {
+        return std::make_unique<LCG>(*this);
+    }
+
+    void LCG::jump_ahead(uint64_t steps)
+    {
+        // Compose the affine map x -> a x + c with itself `steps` times by squaring
+        uint64_t total_a = 1 % m_, total_c = 0;
+        uint64_t step_a = a_, step_c = c_;
+        while (steps > 0)
+        {
+            if (steps & 1)
+            {
+                total_a = mul_mod(step_a, total_a, m_);
+                total_c = add_mod(mul_mod(step_a, total_c, m_), step_c, m_);
+            }
+            step_c = add_mod(mul_mod(step_a, step_c, m_), step_c, m_);
+            step_a = mul_mod(step_a, step_a, m_);
+            steps >>= 1;
+        }
+        current_ = add_mod(mul_mod(total_a, current_, m_), total_c, m_);
+    }
+
+    bool LCG::supports_jump_ahead() const
+    {
+        return true;
+    }
+
+    std::vector<uint64_t> LCG::get_state() const
+    {
+        return {current_};
+    }
+
+    void LCG::set_state(const std::vector<uint64_t> &state)
+    {
+        if (state.size() != 1)
+        {
+            throw std::invalid_argument("LCG state is a single word");
+        }
+        if (state[0] >= m_)
+        {
+            throw std::invalid_argument("State must be less than modulus");
+        }
+        current_ = state[0];
+    }
+
 } // namespace rng
\ No newline at end of file
@@ -19,9 +19,9 @@ namespace rng
         {
             throw std::invalid_argument("j must be less than k");
         }
-        if (k_ == 0)
+        if (j_ == 0)
         {
-            throw std::invalid_argument("k must be positive");
+            throw std::invalid_argument("j must be positive");
         }
         if (operation_ != '+' && operation_ != '-' &&
             operation_ != '*' && operation_ != '^')
@@ -47,11 +47,11 @@ namespace rng
         }
     }
 
-    double LFG::generate()
+    uint64_t LFG::generate_raw()
     {
-        // Get the lagged values
-        uint64_t x_j = state_[state_.size() - j_ - 1];
-        uint64_t x_k = state_[state_.size() - k_ - 1];
+        // Get the lagged values x_(n-j) and x_(n-k); the state holds the last k values
+        uint64_t x_j = state_[state_.size() - j_];
+        uint64_t x_k = state_[state_.size() - k_];
 
         // Calculate next value using the chosen operation
         uint64_t next = combine_values(x_j, x_k);
@@ -59,20 +59,34 @@ namespace rng
         // Update state
         state_.pop_front();
         state_.push_back(next);
+        return next;
+    }
 
+    double LFG::generate()
+    {
         // Normalize to [0,1)
-        return static_cast<double>(next) / m_;
+        return static_cast<double>(generate_raw()) / m_;
+    }
+
+    unsigned LFG::raw_bits() const
+    {
+        return 32;
     }
 
     std::vector<double> LFG::generate_sequence(size_t count)
     {
-        std::vector<double> sequence;
-        sequence.reserve(count);
+        std::vector<double> sequence(count);
+        fill(sequence.data(), count);
+        return sequence;
+    }
+
+    void LFG::fill(double *out, size_t count)
+    {
+        // Qualified call skips the virtual dispatch of generate()
         for (size_t i = 0; i < count; ++i)
         {
-            sequence.push_back(generate());
+            out[i] = LFG::generate();
         }
-        return sequence;
     }
 
     std::string LFG::get_name() const
@@ -102,4 +116,30 @@ namespace rng
         }
     }
 
+    std::unique_ptr<RandomGenerator> LFG::clone() const
+    {
+        return std::make_unique<LFG>(*this);
+    }
+
+    std::vector<uint64_t> LFG::get_state() const
+    {
+        return std::vector<uint64_t>(state_.begin(), state_.end());
+    }
+
+    void LFG::set_state(const std::vector<uint64_t> &state)
+    {
+        if (state.size() != k_)
+        {
+            throw std::invalid_argument("LFG state must hold k values");
+        }
+        for (uint64_t value : state)
+        {
+            if (value >= m_)
+            {
+                throw std::invalid_argument("State values must be less than modulus");
+            }
+        }
+        state_.assign(state.begin(), state.end());
+    }
+
 } // namespace rng
\ No newline at end of file
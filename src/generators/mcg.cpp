@@ -1,4 +1,6 @@
 #include "../../include/generators/mcg.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/modular.hpp"
 #include <stdexcept>
 
 namespace rng
@@ -29,42 +31,47 @@ namespace rng
             throw std::invalid_argument("Seed cannot be zero for MCG");
         }
 
-        // Check if the multiplier satisfies necessary conditions for maximum period
-        bool is_prime = true;
-        for (uint64_t i = 2; i * i <= m_; ++i)
-        {
-            if (m_ % i == 0)
-            {
-                is_prime = false;
-                break;
-            }
-        }
+        // Whether the period is full is left to analyze_mcg()
+        // (engine/period_analysis); trial division would take minutes for
+        // moduli near 2^64
+    }
 
-        if (!is_prime && m_ != 0)
-        {
-            // For non-prime modulus, additional checks could be implemented
-            // but we'll use the default parameters which are known to be good
-        }
+    uint64_t MCG::generate_raw()
+    {
+        // Apply the MCG formula: x_(n+1) = (a * x_n) mod m; a * x_n only fits
+        // in 64 bits for m <= 2^32
+        if (m_ <= (1ULL << 32))
+            current_ = (a_ * current_) % m_;
+        else
+            current_ = mul_mod(a_, current_, m_);
+        return current_;
     }
 
     double MCG::generate()
     {
-        // Apply the MCG formula: x_(n+1) = (a * x_n) mod m
-        current_ = (a_ * current_) % m_;
-
         // Normalize to [0,1)
-        return static_cast<double>(current_) / m_;
+        return static_cast<double>(generate_raw()) / m_;
+    }
+
+    unsigned MCG::raw_bits() const
+    {
+        return floor_log2(m_);
     }
 
     std::vector<double> MCG::generate_sequence(size_t count)
     {
-        std::vector<double> sequence;
-        sequence.reserve(count);
+        std::vector<double> sequence(count);
+        fill(sequence.data(), count);
+        return sequence;
+    }
+
+    void MCG::fill(double *out, size_t count)
+    {
+        // Qualified call skips the virtual dispatch of generate()
         for (size_t i = 0; i < count; ++i)
         {
-            sequence.push_back(generate());
+            out[i] = MCG::generate();
         }
-        return sequence;
     }
 
     std::string MCG::get_name() const
@@ -85,4 +92,43 @@ namespace rng
         current_ = seed;
     }
 
+    std::unique_ptr<RandomGenerator> MCG::clone() const
+    {
+        return std::make_unique<MCG>(*this);
+    }
+
+    void MCG::jump_ahead(uint64_t steps)
+    {
+        // x_(n+k) = a^k x_n mod m
+        current_ = mul_mod(pow_mod(a_, steps, m_), current_, m_);
+    }
+
+    bool MCG::supports_jump_ahead() const
+    {
+        return true;
+    }
+
+    std::vector<uint64_t> MCG::get_state() const
+    {
+        return {current_};
+    }
+
+    void MCG::set_state(const std::vector<uint64_t> &state)
+    {
+        if (state.size() != 1)
+        {
+            throw std::invalid_argument("MCG state is a single word");
+        }
+        if (state[0] >= m_)
+        {
+            throw std::invalid_argument("State must be less than modulus");
+        }
+        if (state[0] == 0)
+        {
+            // Zero is a fixed point of x -> a * x mod m
+            throw std::invalid_argument("State cannot be zero for MCG");
+        }
+        current_ = state[0];
+    }
+
 } // namespace rng
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "../../include/generators/mrg.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/modular.hpp"
 #include <stdexcept>
 #include <sstream>
 
@@ -49,7 +51,7 @@ namespace rng
         }
     }
 
-    double MRG::generate()
+    uint64_t MRG::generate_raw()
     {
         // Calculate next value using the recurrence relation:
         // x_n = (a_1 * x_(n-1) + a_2 * x_(n-2) + ... + a_k * x_(n-k)) mod m
@@ -65,20 +67,34 @@ namespace rng
         // Update state
         state_.pop_front();
         state_.push_back(next);
+        return next;
+    }
 
+    double MRG::generate()
+    {
         // Normalize to [0,1)
-        return static_cast<double>(next) / m_;
+        return static_cast<double>(generate_raw()) / m_;
+    }
+
+    unsigned MRG::raw_bits() const
+    {
+        return floor_log2(m_);
     }
 
     std::vector<double> MRG::generate_sequence(size_t count)
     {
-        std::vector<double> sequence;
-        sequence.reserve(count);
+        std::vector<double> sequence(count);
+        fill(sequence.data(), count);
+        return sequence;
+    }
+
+    void MRG::fill(double *out, size_t count)
+    {
+        // Qualified call skips the virtual dispatch of generate()
         for (size_t i = 0; i < count; ++i)
         {
-            sequence.push_back(generate());
+            out[i] = MRG::generate();
         }
-        return sequence;
     }
 
     std::string MRG::get_name() const
@@ -104,4 +120,80 @@ namespace rng
         }
     }
 
+    std::unique_ptr<RandomGenerator> MRG::clone() const
+    {
+        return std::make_unique<MRG>(*this);
+    }
+
+    void MRG::jump_ahead(uint64_t steps)
+    {
+        // The state (x_(n-k+1), ..., x_n) advances by the k x k companion
+        // matrix; raise it to the power `steps` by repeated squaring
+        using Matrix = std::vector<uint64_t>;
+        auto multiply = [this](const Matrix &lhs, const Matrix &rhs)
+        {
+            Matrix product(k_ * k_, 0);
+            for (size_t i = 0; i < k_; ++i)
+                for (size_t l = 0; l < k_; ++l)
+                {
+                    uint64_t left = lhs[i * k_ + l];
+                    if (left == 0)
+                        continue;
+                    for (size_t j = 0; j < k_; ++j)
+                        product[i * k_ + j] = add_mod(product[i * k_ + j], mul_mod(left, rhs[l * k_ + j], m_), m_);
+                }
+            return product;
+        };
+
+        Matrix step(k_ * k_, 0);
+        for (size_t i = 0; i + 1 < k_; ++i)
+            step[i * k_ + i + 1] = 1;
+        for (size_t i = 0; i < k_; ++i)
+            step[(k_ - 1) * k_ + (k_ - 1 - i)] = multipliers_[i] % m_;
+
+        Matrix total(k_ * k_, 0);
+        for (size_t i = 0; i < k_; ++i)
+            total[i * k_ + i] = 1 % m_;
+
+        while (steps > 0)
+        {
+            if (steps & 1)
+                total = multiply(step, total);
+            step = multiply(step, step);
+            steps >>= 1;
+        }
+
+        std::deque<uint64_t> next(k_, 0);
+        for (size_t i = 0; i < k_; ++i)
+            for (size_t j = 0; j < k_; ++j)
+                next[i] = add_mod(next[i], mul_mod(total[i * k_ + j], state_[j], m_), m_);
+        state_ = next;
+    }
+
+    bool MRG::supports_jump_ahead() const
+    {
+        return true;
+    }
+
+    std::vector<uint64_t> MRG::get_state() const
+    {
+        return std::vector<uint64_t>(state_.begin(), state_.end());
+    }
+
+    void MRG::set_state(const std::vector<uint64_t> &state)
+    {
+        if (state.size() != k_)
+        {
+            throw std::invalid_argument("MRG state must hold k values");
+        }
+        for (uint64_t value : state)
+        {
+            if (value >= m_)
+            {
+                throw std::invalid_argument("State values must be less than modulus");
+            }
+        }
+        state_.assign(state.begin(), state.end());
+    }
+
 } // namespace rng
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "../../include/generators/msm.hpp"
+#include "../../include/utils/bits.hpp"
 #include <stdexcept>
 #include <cmath>
 #include <string>
@@ -42,7 +43,7 @@ namespace rng
         return std::stoull(middle);
     }
 
-    double MSM::generate()
+    uint64_t MSM::generate_raw()
     {
         // Square the current value
         uint64_t square = current_ * current_;
@@ -56,19 +57,34 @@ namespace rng
             current_ = 1234567890123456ULL;
         }
 
+        return current_;
+    }
+
+    double MSM::generate()
+    {
         // Normalize to [0,1)
-        return static_cast<double>(current_) / (MAX_SEED + 1.0);
+        return static_cast<double>(generate_raw()) / (MAX_SEED + 1.0);
+    }
+
+    unsigned MSM::raw_bits() const
+    {
+        return floor_log2(MAX_SEED + 1);
     }
 
     std::vector<double> MSM::generate_sequence(size_t count)
     {
-        std::vector<double> sequence;
-        sequence.reserve(count);
+        std::vector<double> sequence(count);
+        fill(sequence.data(), count);
+        return sequence;
+    }
+
+    void MSM::fill(double *out, size_t count)
+    {
+        // Qualified call skips the virtual dispatch of generate()
         for (size_t i = 0; i < count; ++i)
         {
-            sequence.push_back(generate());
+            out[i] = MSM::generate();
         }
-        return sequence;
     }
 
     std::string MSM::get_name() const
@@ -82,4 +98,27 @@ namespace rng
         current_ = seed;
     }
 
+    std::unique_ptr<RandomGenerator> MSM::clone() const
+    {
+        return std::make_unique<MSM>(*this);
+    }
+
+    std::vector<uint64_t> MSM::get_state() const
+    {
+        return {current_};
+    }
+
+    void MSM::set_state(const std::vector<uint64_t> &state)
+    {
+        if (state.size() != 1)
+        {
+            throw std::invalid_argument("MSM state is a single word");
+        }
+        if (state[0] > MAX_SEED)
+        {
+            throw std::invalid_argument("State must not exceed " + std::to_string(MAX_SEED));
+        }
+        current_ = state[0];
+    }
+
 } // namespace rng
\ No newline at end of file
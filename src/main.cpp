@@ -1,11 +1,220 @@
 #include "../include/menu/menu_handler.hpp"
+#include "../include/engine/distributed.hpp"
+#include "../include/engine/monitor.hpp"
+#include "../include/generators/generator_suite.hpp"
+#include "../include/tests/randomness_tests.hpp"
+#include "../include/utils/cpu_dispatch.hpp"
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 
-int main()
+namespace
+{
+
+    void print_usage()
+    {
+        std::cout << "Usage: rng_suite [--cpu LEVEL]        interactive menu\n"
+                  << "       rng_suite [--cpu LEVEL] --monitor [FILE] [options]\n"
+                  << "       rng_suite [--cpu LEVEL] --distributed GENERATOR [options]\n"
+                  << "       rng_suite --cpu-info\n"
+                  << "--cpu runs the vector kernels at LEVEL (baseline, sse4.2, avx2 or avx512)\n"
+                  << "instead of the widest one this CPU supports; the RNG_CPU_LEVEL environment\n"
+                  << "variable does the same. --cpu-info prints the detected and selected levels.\n"
+                  << "Monitor mode watches numbers in [0, 1] read from FILE (a file or FIFO)\n"
+                  << "or from standard input, and prints an alert line whenever a\n"
+                  << "sliding-window p-value stays low or window p-values drift.\n"
+                  << "  --binary              native binary doubles instead of text\n"
+                  << "  --window N            numbers per window (default 65536)\n"
+                  << "  --step N              numbers between evaluations, dividing the window;\n"
+                  << "                        equal to the window for tumbling windows (default 4096)\n"
+                  << "  --bins N              chi-square bins (default 10)\n"
+                  << "  --alert-level P       window p-value that raises an alert (default 1e-4)\n"
+                  << "  --persistence N       evaluations in a row to raise or clear (default 2)\n"
+                  << "  --drift-windows N     disjoint windows per drift check, 0 for none (default 32)\n"
+                  << "  --chunk N             numbers read at a time (default 1024)\n"
+                  << "Exit status 2 means at least one alert was printed.\n"
+                  << "Distributed mode runs the streaming tests of the suite over numbers of\n"
+                  << "GENERATOR, one of:";
+        for (const std::string &key : rng::generator_suite_keys())
+            std::cout << " " << key;
+        std::cout << "\n"
+                  << "split into shards handed to forked worker processes.\n"
+                  << "  --seed N              generator seed (default 1)\n"
+                  << "  --numbers N           numbers to test (default 16777216)\n"
+                  << "  --shard-size N        numbers per shard (default 4194304)\n"
+                  << "  --workers N           worker processes, 0 to run in this one (default 2)\n"
+                  << "  --threads N           threads per worker, 0 for all cores (default 1)\n"
+                  << "  --timeout S           seconds before a silent worker is replaced (default 600)\n"
+                  << "  --restarts N          replacement workers allowed (default 8)\n"
+                  << "  --tcp                 talk to the workers over loopback TCP\n"
+                  << "  --alpha P             significance level (default 0.01)\n"
+                  << "Exit status 2 means at least one test failed.\n";
+    }
+
+    int run_monitor_mode(int argc, char **argv)
+    {
+        rng::MonitorOptions options;
+        std::string path;
+        bool binary = false;
+        size_t chunk = 1024;
+
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument("Missing value after " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--binary")
+                binary = true;
+            else if (arg == "--window")
+                options.window = std::stoull(next());
+            else if (arg == "--step")
+                options.step = std::stoull(next());
+            else if (arg == "--bins")
+                options.chi_square_bins = std::stoull(next());
+            else if (arg == "--alert-level")
+                options.alert_level = std::stod(next());
+            else if (arg == "--persistence")
+                options.persistence = std::stoull(next());
+            else if (arg == "--drift-windows")
+                options.drift_windows = std::stoull(next());
+            else if (arg == "--chunk")
+                chunk = std::stoull(next());
+            else if (arg.size() > 1 && arg[0] == '-')
+                throw std::invalid_argument("Unknown option " + arg);
+            else if (path.empty())
+                path = arg;
+            else
+                throw std::invalid_argument("More than one input given");
+        }
+
+        std::ifstream file;
+        if (!path.empty() && path != "-")
+        {
+            file.open(path, binary ? std::ios::binary : std::ios::in);
+            if (!file)
+                throw std::runtime_error("Cannot open " + path);
+        }
+        rng::StreamSource source(file.is_open() ? static_cast<std::istream &>(file) : std::cin, binary);
+
+        rng::MonitorSummary summary = rng::run_monitor(source, options, [](const rng::MonitorAlert &alert)
+                                                       { std::cout << rng::format_alert(alert) << std::endl; },
+                                                       chunk);
+
+        std::cerr << "Monitored " << summary.samples << " numbers (" << summary.rejected
+                  << " outside [0, 1] dropped), " << summary.evaluations << " evaluations, "
+                  << summary.alerts << " alerts";
+        if (summary.samples > 0)
+            std::cerr << ", " << summary.update_seconds * 1e9 / summary.samples << " ns per number";
+        std::cerr << std::endl;
+        return summary.alerts > 0 ? 2 : 0;
+    }
+
+    int run_distributed_mode(int argc, char **argv)
+    {
+        if (argc < 3 || argv[2][0] == '-')
+            throw std::invalid_argument("--distributed needs a generator");
+        std::unique_ptr<rng::RandomGenerator> generator = rng::create_generator(argv[2]);
+
+        rng::DistributedOptions options;
+        options.total_numbers = 1ULL << 24;
+        uint64_t seed = 1;
+        double significance_level = 0.01;
+        for (int i = 3; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument("Missing value after " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--seed")
+                seed = std::stoull(next());
+            else if (arg == "--numbers")
+                options.total_numbers = std::stoull(next());
+            else if (arg == "--shard-size")
+                options.shard_size = std::stoull(next());
+            else if (arg == "--workers")
+                options.workers = std::stoull(next());
+            else if (arg == "--threads")
+                options.threads_per_worker = std::stoull(next());
+            else if (arg == "--timeout")
+                options.shard_timeout_seconds = std::stod(next());
+            else if (arg == "--restarts")
+                options.max_restarts = std::stoull(next());
+            else if (arg == "--tcp")
+                options.transport = rng::DistributedTransport::LoopbackTcp;
+            else if (arg == "--alpha")
+                significance_level = std::stod(next());
+            else
+                throw std::invalid_argument("Unknown option " + arg);
+        }
+
+        std::vector<std::unique_ptr<rng::RandomnessTest>> suite = rng::create_test_suite();
+        std::vector<rng::StreamingTest *> tests;
+        for (const auto &test : suite)
+        {
+            if (auto *streaming = dynamic_cast<rng::StreamingTest *>(test.get()))
+                tests.push_back(streaming);
+        }
+
+        generator->set_seed(seed);
+        // Workers are forked, so pending output must not be copied into them
+        std::cout.flush();
+        rng::DistributedResult result = rng::run_distributed(*generator, tests, options, significance_level);
+
+        bool all_passed = true;
+        for (size_t t = 0; t < tests.size(); ++t)
+        {
+            std::cout << tests[t]->get_test_name() << "\n"
+                      << tests[t]->get_test_result() << "\n\n";
+            all_passed &= result.verdicts[t];
+        }
+        std::cerr << "Tested " << options.total_numbers << " numbers of " << generator->get_name() << " in "
+                  << result.shards << " shards, " << result.elapsed_seconds << " s, " << result.worker_failures
+                  << " worker failures (" << result.timed_out_workers << " timed out), "
+                  << result.reassigned_shards << " shards reassigned" << std::endl;
+        return all_passed ? 0 : 2;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
 {
     try
     {
+        if (argc > 2 && std::string(argv[1]) == "--cpu")
+        {
+            rng::select_cpu_level(rng::parse_cpu_level(argv[2]));
+            argv[2] = argv[0];
+            argv += 2;
+            argc -= 2;
+        }
+
+        if (argc > 1)
+        {
+            std::string mode = argv[1];
+            if (mode == "--cpu-info")
+            {
+                std::cout << "detected: " << rng::cpu_level_name(rng::detected_cpu_level())
+                          << "\nselected: " << rng::cpu_level_name(rng::selected_cpu_level()) << std::endl;
+                return 0;
+            }
+            if (mode == "--monitor")
+                return run_monitor_mode(argc, argv);
+            if (mode == "--distributed")
+                return run_distributed_mode(argc, argv);
+            print_usage();
+            return mode == "--help" || mode == "-h" ? 0 : 1;
+        }
+
         rng::MenuHandler menu;
         menu.run();
     }
@@ -21,4 +230,4 @@ int main()
     }
 
     return 0;
-}
\ No newline at end of file
+}
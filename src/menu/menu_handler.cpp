@@ -1,12 +1,25 @@
 #include "../../include/menu/menu_handler.hpp"
-#include "../../include/generators/icg.hpp"
-#include "../../include/generators/mrg.hpp"
-#include "../../include/generators/lfg.hpp"
-#include "../../include/generators/msm.hpp"
+#include "../../include/generators/generator_suite.hpp"
 #include "../../include/generators/lcg.hpp"
 #include "../../include/generators/mcg.hpp"
 #include "../../include/tests/randomness_tests.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/engine/fused_runner.hpp"
+#include "../../include/engine/second_level.hpp"
+#include "../../include/engine/seed_sweep.hpp"
+#include "../../include/engine/period_analysis.hpp"
+#include "../../include/engine/checkpoint.hpp"
+#include "../../include/engine/pipeline.hpp"
+#include "../../include/engine/run_report.hpp"
+#include "../../include/engine/sequential.hpp"
+#include "../../include/engine/battery.hpp"
+#include "../../include/engine/result_cache.hpp"
+#include "../../include/engine/distributed.hpp"
+#include "../../include/utils/instrumentation.hpp"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <fstream>
 #include <limits>
 #include <cstdlib>
 
@@ -17,16 +30,12 @@ namespace rng
     {
         initialize_generators();
         tests_ = create_test_suite();
+        bit_tests_ = create_bit_test_suite();
     }
 
     void MenuHandler::initialize_generators()
     {
-        generators_.push_back(std::make_unique<ICG>());
-        generators_.push_back(std::make_unique<MRG>(std::vector<uint64_t>{1, 2, 3}, std::vector<uint64_t>{1, 1, 1}));
-        generators_.push_back(std::make_unique<LFG>(1, 3, 7));
-        generators_.push_back(std::make_unique<MSM>(12345));
-        generators_.push_back(std::make_unique<LCG>());
-        generators_.push_back(std::make_unique<MCG>());
+        generators_ = create_generator_suite();
     }
 
     void MenuHandler::display_main_menu() const
@@ -59,7 +68,7 @@ namespace rng
 
             if (choice > 0 && choice <= generators_.size())
             {
-                handle_generator_selection();
+                handle_generator_selection(generators_[choice - 1].get());
             }
             else
             {
@@ -70,7 +79,58 @@ namespace rng
         }
     }
 
-    void MenuHandler::handle_generator_selection()
+    void MenuHandler::handle_generator_selection(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Execution Mode\n";
+        std::cout << "==============\n\n";
+        std::cout << "1. Single sequence\n";
+        std::cout << "2. Second-level testing (replicated runs)\n";
+        std::cout << "3. Seed sweep\n";
+        std::cout << "4. Period analysis\n";
+        std::cout << "5. Long run with checkpoints\n";
+        std::cout << "6. Pipelined run (generate while testing)\n";
+        std::cout << "7. Sequential screening (stop once decided)\n";
+        std::cout << "8. Test battery (quick / standard / exhaustive)\n";
+        std::cout << "9. Sharded run over worker processes\n";
+        std::cout << "Choice (1-9): ";
+
+        int choice;
+        std::cin >> choice;
+
+        switch (choice)
+        {
+        case 2:
+            handle_second_level(generator);
+            break;
+        case 3:
+            handle_seed_sweep(generator);
+            break;
+        case 4:
+            handle_period_analysis(generator);
+            break;
+        case 5:
+            handle_checkpointed_run(generator);
+            break;
+        case 6:
+            handle_pipelined_run(generator);
+            break;
+        case 7:
+            handle_sequential_run(generator);
+            break;
+        case 8:
+            handle_battery_run(generator);
+            break;
+        case 9:
+            handle_distributed_run(generator);
+            break;
+        default:
+            handle_sequence_generation(generator);
+            break;
+        }
+    }
+
+    void MenuHandler::handle_sequence_generation(RandomGenerator *generator)
     {
         clear_screen();
         std::cout << "Generator Parameters\n";
@@ -79,10 +139,28 @@ namespace rng
         uint64_t seed = get_valid_seed();
         size_t sequence_length = get_valid_sequence_length();
 
-        RandomGenerator *generator = generators_[0].get(); // Using first generator as example
         generator->set_seed(seed);
+        reset_instrumentation();
+        auto start = std::chrono::steady_clock::now();
+
+        // Allocation and generation are timed apart, so the run report shows
+        // which of the two dominates
+        static const ProbeId allocate_probe = RNG_PROBE("sequence.allocate");
+        static const ProbeId fill_probe = RNG_PROBE("generator.fill");
+        std::vector<double> numbers;
+        {
+            RNG_TIMED_SCOPE(allocate_probe, sequence_length);
+            numbers.resize(sequence_length);
+        }
+        {
+            RNG_TIMED_SCOPE(fill_probe, sequence_length);
+            generator->fill(numbers.data(), numbers.size());
+        }
 
-        std::vector<double> numbers = generator->generate_sequence(sequence_length);
+        RunReport report;
+        report.generator_name = generator->get_name();
+        report.seed = seed;
+        report.sequence_length = sequence_length;
 
         std::cout << "\nGenerated " << sequence_length << " numbers.\n";
         std::cout << "Would you like to run randomness tests? (y/n): ";
@@ -92,36 +170,468 @@ namespace rng
 
         if (choice == 'y' || choice == 'Y')
         {
-            handle_test_selection(numbers);
+            handle_test_selection(numbers, report, start);
+        }
+
+        std::cout << "\nWould you like to run bit-level tests on the raw output? (y/n): ";
+        std::cin >> choice;
+
+        if (choice == 'y' || choice == 'Y')
+        {
+            generator->set_seed(seed);
+            handle_bit_test_selection(generator, sequence_length);
         }
     }
 
-    void MenuHandler::handle_test_selection(const std::vector<double> &numbers)
+    void MenuHandler::handle_test_selection(const std::vector<double> &numbers, RunReport &report,
+                                            std::chrono::steady_clock::time_point start)
     {
         clear_screen();
         std::cout << "Randomness Tests\n";
         std::cout << "================\n\n";
 
-        double significance_level = get_valid_significance_level();
-        display_test_results(numbers, significance_level);
+        report.significance_level = get_valid_significance_level();
+        display_test_results(numbers, report, start);
     }
 
-    void MenuHandler::display_test_results(const std::vector<double> &numbers, double significance_level)
+    void MenuHandler::display_test_results(const std::vector<double> &numbers, RunReport &report,
+                                           std::chrono::steady_clock::time_point start)
     {
+        double significance_level = report.significance_level;
         clear_screen();
         std::cout << "Test Results\n";
         std::cout << "============\n\n";
 
+        // Streaming tests share a single pass over the numbers
+        std::vector<StreamingTest *> streaming;
+        for (const auto &test : tests_)
+        {
+            if (auto *streaming_test = dynamic_cast<StreamingTest *>(test.get()))
+                streaming.push_back(streaming_test);
+        }
+        std::vector<bool> fused_verdicts = run_fused(streaming, numbers, significance_level);
+
+        size_t fused_index = 0;
         for (const auto &test : tests_)
         {
             std::cout << "Running " << test->get_test_name() << "...\n";
-            bool passed = test->run_test(numbers, significance_level);
+            bool passed;
+            if (dynamic_cast<StreamingTest *>(test.get()) == nullptr)
+            {
+                RNG_TIMED_SCOPE(RNG_PROBE("test.run: " + test->get_test_name()), numbers.size());
+                passed = test->run_test(numbers, significance_level);
+            }
+            else
+            {
+                passed = fused_verdicts[fused_index++];
+            }
+            std::cout << test->get_test_result() << "\n\n";
+            report.tests.push_back(test.get());
+            report.verdicts.push_back(passed);
+        }
+        report.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Write a JSON run report" << (instrumentation_enabled() ? " with stage timings" : "")
+                  << "? (y/n): ";
+        char choice;
+        std::cin >> choice;
+        if (choice == 'y' || choice == 'Y')
+        {
+            std::string path;
+            std::cout << "Report file path: ";
+            std::cin >> path;
+            std::ofstream file(path);
+            if (file)
+            {
+                write_run_report(file, report);
+                std::cout << "Report written to " << path << "\n";
+            }
+            else
+            {
+                std::cout << "Cannot open " << path << "\n";
+            }
+        }
+
+        pause();
+    }
+
+    void MenuHandler::handle_bit_test_selection(RandomGenerator *generator, size_t sequence_length)
+    {
+        clear_screen();
+        std::cout << "Bit-Level Tests\n";
+        std::cout << "===============\n\n";
+
+        double significance_level = get_valid_significance_level();
+        BitSequence bits = generate_bit_sequence(*generator, sequence_length * generator->raw_bits());
+
+        clear_screen();
+        std::cout << "Test Results\n";
+        std::cout << "============\n\n";
+        std::cout << "Using " << bits.bit_count << " bits (" << bits.value_bits << " per output)\n\n";
+
+        for (const auto &test : bit_tests_)
+        {
+            std::cout << "Running " << test->get_test_name() << "...\n";
+            test->run_test(bits, significance_level);
             std::cout << test->get_test_result() << "\n\n";
         }
 
         pause();
     }
 
+    void MenuHandler::handle_second_level(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Second-Level Testing\n";
+        std::cout << "====================\n\n";
+
+        SecondLevelOptions options;
+        options.base_seed = get_valid_seed();
+        options.sample_size = get_valid_sequence_length();
+        options.replications = get_valid_replication_count();
+
+        std::cout << "Replications from:\n";
+        std::cout << "1. Disjoint substreams of one seed\n";
+        std::cout << "2. Distinct seeds\n";
+        std::cout << "Choice (1-2): ";
+
+        int choice;
+        std::cin >> choice;
+        options.mode = choice == 2 ? ReplicationMode::DistinctSeeds : ReplicationMode::Substreams;
+        options.significance_level = get_valid_significance_level();
+
+        generator->set_seed(options.base_seed);
+        std::cout << "\nRunning " << options.replications << " replications of "
+                  << options.sample_size << " numbers...\n";
+        std::vector<SecondLevelResult> results = run_second_level(*generator, create_test_suite, options);
+
+        clear_screen();
+        std::cout << "Second-Level Results\n";
+        std::cout << "====================\n\n";
+        std::cout << format_second_level(results);
+
+        pause();
+    }
+
+    void MenuHandler::handle_seed_sweep(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Seed Sweep\n";
+        std::cout << "==========\n\n";
+
+        SeedSweepOptions options;
+        std::cout << "First seed: ";
+        std::cin >> options.first_seed;
+        std::cout << "Number of seeds: ";
+        std::cin >> options.seed_count;
+        options.sample_size = get_valid_sequence_length();
+        options.seeds_per_range = std::max<uint64_t>(1, options.seed_count / 10);
+        options.significance_level = get_valid_significance_level();
+
+        std::cout << "Write per-seed results to a CSV file? (y/n): ";
+        char choice;
+        std::cin >> choice;
+        std::ofstream csv;
+        if (choice == 'y' || choice == 'Y')
+        {
+            std::string path;
+            std::cout << "CSV file path: ";
+            std::cin >> path;
+            csv.open(path);
+            if (!csv)
+            {
+                std::cout << "Cannot open " << path << ", continuing without CSV output\n";
+            }
+        }
+
+        std::cout << "\nSweeping " << options.seed_count << " seeds...\n";
+        SeedSweepReport report = run_seed_sweep({generator}, create_test_suite, options,
+                                                csv.is_open() ? &csv : nullptr);
+
+        clear_screen();
+        std::cout << "Seed Sweep Results\n";
+        std::cout << "==================\n\n";
+        std::cout << format_seed_sweep(report, options.significance_level);
+
+        pause();
+    }
+
+    void MenuHandler::handle_period_analysis(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Period Analysis\n";
+        std::cout << "===============\n\n";
+
+        uint64_t seed = get_valid_seed();
+        generator->set_seed(seed);
+
+        uint64_t max_steps;
+        std::cout << "Maximum steps for cycle detection: ";
+        std::cin >> max_steps;
+
+        uint64_t state_count = 0;
+        if (generator->get_state().size() == 1)
+        {
+            std::cout << "Map every state in [0, N) exhaustively? N (0 to skip, at most "
+                      << MAX_ORBIT_STATES << "): ";
+            std::cin >> state_count;
+        }
+
+        clear_screen();
+        std::cout << "Period Analysis Results\n";
+        std::cout << "=======================\n\n";
+
+        if (auto *lcg = dynamic_cast<LCG *>(generator))
+        {
+            std::cout << "Analytic period:\n" << format_analytic_period(analyze_lcg(*lcg)) << "\n\n";
+        }
+        else if (auto *mcg = dynamic_cast<MCG *>(generator))
+        {
+            std::cout << "Analytic period:\n" << format_analytic_period(analyze_mcg(*mcg)) << "\n\n";
+        }
+
+        std::cout << "Cycle detection from seed " << seed << ":\n"
+                  << format_cycle_detection(detect_cycle(*generator, max_steps)) << "\n\n";
+
+        if (state_count > 0)
+        {
+            try
+            {
+                std::cout << "Orbit map:\n" << format_orbit_map(map_orbits(*generator, state_count)) << "\n";
+            }
+            catch (const std::invalid_argument &e)
+            {
+                std::cout << "Orbit map unavailable: " << e.what() << "\n";
+            }
+        }
+
+        pause();
+    }
+
+    void MenuHandler::handle_checkpointed_run(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Long Run with Checkpoints\n";
+        std::cout << "=========================\n\n";
+
+        CheckpointOptions options;
+        uint64_t seed = get_valid_seed();
+        std::cout << "Total numbers to test: ";
+        std::cin >> options.total_numbers;
+        std::cout << "Numbers between checkpoints: ";
+        std::cin >> options.interval;
+        std::cout << "Checkpoint file path: ";
+        std::cin >> options.path;
+        double significance_level = get_valid_significance_level();
+
+        std::vector<StreamingTest *> streaming;
+        for (const auto &test : tests_)
+        {
+            if (auto *streaming_test = dynamic_cast<StreamingTest *>(test.get()))
+                streaming.push_back(streaming_test);
+        }
+
+        generator->set_seed(seed);
+        CheckpointedRunResult result;
+        try
+        {
+            result = run_checkpointed(*generator, streaming, options, significance_level);
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "\nRun aborted: " << e.what() << "\n";
+            pause();
+            return;
+        }
+
+        clear_screen();
+        std::cout << "Test Results\n";
+        std::cout << "============\n\n";
+        if (result.resumed)
+            std::cout << "Resumed from checkpoint after " << result.resumed_at << " numbers\n";
+        std::cout << "Checkpoints written: " << result.checkpoints_written << "\n\n";
+        for (StreamingTest *test : streaming)
+        {
+            std::cout << test->get_test_name() << "\n"
+                      << test->get_test_result() << "\n\n";
+        }
+
+        pause();
+    }
+
+    void MenuHandler::handle_pipelined_run(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Pipelined Run\n";
+        std::cout << "=============\n\n";
+
+        uint64_t seed = get_valid_seed();
+        size_t sequence_length = get_valid_sequence_length();
+        double significance_level = get_valid_significance_level();
+
+        std::vector<StreamingTest *> streaming;
+        for (const auto &test : tests_)
+        {
+            if (auto *streaming_test = dynamic_cast<StreamingTest *>(test.get()))
+                streaming.push_back(streaming_test);
+        }
+
+        generator->set_seed(seed);
+        PipelineStats stats;
+        run_pipelined(*generator, streaming, sequence_length, significance_level, PipelineOptions(), &stats);
+
+        clear_screen();
+        std::cout << "Test Results\n";
+        std::cout << "============\n\n";
+        std::cout << "Wall time: " << stats.elapsed_seconds << " s (generation "
+                  << stats.generate_seconds << " s, generator stalled " << stats.stalled_seconds
+                  << " s), " << stats.buffers_filled << " buffers, "
+                  << stats.test_threads << " test threads\n\n";
+        for (StreamingTest *test : streaming)
+        {
+            std::cout << test->get_test_name() << "\n"
+                      << test->get_test_result() << "\n\n";
+        }
+
+        pause();
+    }
+
+    void MenuHandler::handle_sequential_run(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Sequential Screening\n";
+        std::cout << "====================\n\n";
+
+        uint64_t seed = get_valid_seed();
+        SequentialOptions options;
+        std::cout << "Maximum numbers to test:\n";
+        options.max_numbers = get_valid_sequence_length();
+        options.significance_level = get_valid_significance_level();
+        std::cout << "Time budget in seconds (0 for none): ";
+        std::cin >> options.time_budget_seconds;
+
+        std::vector<StreamingTest *> streaming;
+        for (const auto &test : tests_)
+        {
+            if (auto *streaming_test = dynamic_cast<StreamingTest *>(test.get()))
+                streaming.push_back(streaming_test);
+        }
+
+        generator->set_seed(seed);
+        SequentialReport report = run_sequential(*generator, streaming, options);
+
+        clear_screen();
+        std::cout << "Sequential Results\n";
+        std::cout << "==================\n\n";
+        std::cout << format_sequential(report);
+
+        pause();
+    }
+
+    void MenuHandler::handle_distributed_run(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Sharded Run over Worker Processes\n";
+        std::cout << "=================================\n\n";
+
+        DistributedOptions options;
+        uint64_t seed = get_valid_seed();
+        std::cout << "Total numbers to test: ";
+        std::cin >> options.total_numbers;
+        std::cout << "Numbers per shard: ";
+        std::cin >> options.shard_size;
+        std::cout << "Worker processes (0 to run the shards in this process): ";
+        std::cin >> options.workers;
+        double significance_level = get_valid_significance_level();
+
+        std::vector<StreamingTest *> streaming;
+        for (const auto &test : tests_)
+        {
+            if (auto *streaming_test = dynamic_cast<StreamingTest *>(test.get()))
+                streaming.push_back(streaming_test);
+        }
+
+        generator->set_seed(seed);
+        DistributedResult result;
+        try
+        {
+            // Workers are forked, so pending output must not be copied into them
+            std::cout.flush();
+            result = run_distributed(*generator, streaming, options, significance_level);
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "\nRun aborted: " << e.what() << "\n";
+            pause();
+            return;
+        }
+
+        clear_screen();
+        std::cout << "Test Results\n";
+        std::cout << "============\n\n";
+        std::cout << "Wall time: " << result.elapsed_seconds << " s, " << result.shards << " shards, "
+                  << result.worker_failures << " worker failures (" << result.timed_out_workers
+                  << " timed out), " << result.reassigned_shards << " shards reassigned\n\n";
+        for (StreamingTest *test : streaming)
+        {
+            std::cout << test->get_test_name() << "\n"
+                      << test->get_test_result() << "\n\n";
+        }
+
+        pause();
+    }
+
+    void MenuHandler::handle_battery_run(RandomGenerator *generator)
+    {
+        clear_screen();
+        std::cout << "Test Battery\n";
+        std::cout << "============\n\n";
+
+        std::cout << "1. Quick\n";
+        std::cout << "2. Standard\n";
+        std::cout << "3. Exhaustive\n";
+        std::cout << "Choice (1-3): ";
+        int choice;
+        std::cin >> choice;
+        BatteryTier tier = choice == 3 ? BatteryTier::Exhaustive
+                                       : (choice == 2 ? BatteryTier::Standard : BatteryTier::Quick);
+        Battery battery = make_battery(tier);
+
+        uint64_t seed = get_valid_seed();
+        BatteryOptions options;
+        options.significance_level = get_valid_significance_level();
+        std::cout << "Time budget in seconds (0 for none): ";
+        std::cin >> options.time_budget_seconds;
+
+        std::cout << "Cost data from an rng_bench CSV file (path, or - to measure now): ";
+        std::string path;
+        std::cin >> path;
+
+        std::cout << "Results cache file (path, or - for none): ";
+        std::string cache_path;
+        std::cin >> cache_path;
+        std::unique_ptr<ResultCache> cache;
+        if (cache_path != "-")
+        {
+            cache = std::make_unique<ResultCache>(cache_path);
+            options.cache = cache.get();
+        }
+
+        generator->set_seed(seed);
+        CostModel costs = path == "-" ? calibrate_cost_model(battery, *generator)
+                                      : load_cost_model(path, generator->get_name());
+
+        std::cout << "\nRunning the " << battery.name << " battery...\n";
+        BatteryReport report = run_battery(*generator, battery, costs, options);
+
+        clear_screen();
+        std::cout << "Battery Results\n";
+        std::cout << "===============\n\n";
+        std::cout << format_battery(report);
+
+        pause();
+    }
+
     uint64_t MenuHandler::get_valid_seed() const
     {
         uint64_t seed;
@@ -162,6 +672,14 @@ namespace rng
         }
     }
 
+    size_t MenuHandler::get_valid_replication_count() const
+    {
+        size_t replications;
+        std::cout << "Enter number of replications (at least 2): ";
+        std::cin >> replications;
+        return replications < 2 ? 2 : replications;
+    }
+
     void MenuHandler::clear_screen() const
     {
 #ifdef _WIN32
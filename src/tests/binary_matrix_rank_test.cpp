@@ -0,0 +1,177 @@
+#include "../../include/tests/binary_matrix_rank_test.hpp"
+#include "../../include/tests/statistics.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/parallel.hpp"
+#include "../../include/utils/cpu_dispatch.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Rank over GF(2) of a size x size matrix stored as rows of `words` words.
+        // The matrix is destroyed.
+        size_t gf2_rank(uint64_t *rows, size_t size, size_t words)
+        {
+            const auto xor_words = kernels().xor_words;
+            size_t rank = 0;
+            for (size_t col = 0; col < size && rank < size; ++col)
+            {
+                const size_t word = col >> 6;
+                const uint64_t bit = 1ULL << (col & 63);
+
+                size_t pivot = rank;
+                while (pivot < size && (rows[pivot * words + word] & bit) == 0)
+                    ++pivot;
+                if (pivot == size)
+                    continue;
+
+                // Rows at or below `rank` are zero before column `col`
+                uint64_t *pivot_row = rows + rank * words;
+                if (pivot != rank)
+                    std::swap_ranges(pivot_row + word, pivot_row + words, rows + pivot * words + word);
+
+                for (size_t r = rank + 1; r < size; ++r)
+                {
+                    uint64_t *row = rows + r * words;
+                    if ((row[word] & bit) == 0)
+                        continue;
+                    // Short tails are not worth a call through the table
+                    if (words - word < 4)
+                    {
+                        for (size_t i = word; i < words; ++i)
+                            row[i] ^= pivot_row[i];
+                    }
+                    else
+                    {
+                        xor_words(row + word, pivot_row + word, words - word);
+                    }
+                }
+                ++rank;
+            }
+            return rank;
+        }
+
+        // Probability that a random size x size matrix over GF(2) has rank r
+        double rank_probability(size_t size, size_t r)
+        {
+            double exponent = static_cast<double>(r) * (2.0 * size - r) - static_cast<double>(size) * size;
+            double product = 1.0;
+            for (size_t i = 0; i < r; ++i)
+            {
+                double a = 1.0 - std::ldexp(1.0, static_cast<int>(i) - static_cast<int>(size));
+                double b = 1.0 - std::ldexp(1.0, static_cast<int>(i) - static_cast<int>(r));
+                product *= a * a / b;
+            }
+            return std::ldexp(product, static_cast<int>(exponent));
+        }
+    } // namespace
+
+    BinaryMatrixRankTest::BinaryMatrixRankTest(size_t size, size_t num_threads)
+        : size_(size), num_threads_(num_threads == 0 ? default_thread_count() : num_threads),
+          chi_square_value_(0.0), p_value_(0.0)
+    {
+        if (size_ < MIN_SIZE || size_ > MAX_SIZE)
+        {
+            throw std::invalid_argument("Matrix size must be between " + std::to_string(MIN_SIZE) +
+                                        " and " + std::to_string(MAX_SIZE));
+        }
+    }
+
+    bool BinaryMatrixRankTest::run_test(const BitSequence &bits, double significance_level)
+    {
+        const size_t bits_per_matrix = size_ * size_;
+        const size_t matrices = bits.bit_count / bits_per_matrix;
+        if (matrices == 0)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "Not enough bits for a single " + std::to_string(size_) + "x" +
+                              std::to_string(size_) + " matrix\nTest FAILED";
+            return false;
+        }
+
+        const size_t words = (size_ + 63) / 64;
+        const size_t shards = std::min(num_threads_, matrices);
+        std::vector<std::array<uint64_t, 4>> shard_counts(shards, std::array<uint64_t, 4>{});
+
+        // Classes: rank L, L-1, L-2, and L-3 or lower
+        parallel_for_shards(matrices, shards, [&](size_t shard, size_t begin, size_t end)
+                            {
+            std::vector<uint64_t> rows(size_ * words);
+            for (size_t m = begin; m < end; ++m)
+            {
+                size_t offset = m * bits_per_matrix;
+                for (size_t r = 0; r < size_; ++r)
+                {
+                    for (size_t w = 0; w < words; ++w)
+                    {
+                        unsigned count = static_cast<unsigned>(std::min<size_t>(64, size_ - w * 64));
+                        rows[r * words + w] = read_bits(bits.words.data(), offset, count);
+                        offset += count;
+                    }
+                }
+                size_t deficiency = size_ - gf2_rank(rows.data(), size_, words);
+                ++shard_counts[shard][std::min<size_t>(deficiency, 3)];
+            } });
+
+        std::array<uint64_t, 4> counts{};
+        for (const auto &shard : shard_counts)
+        {
+            for (size_t i = 0; i < 4; ++i)
+                counts[i] += shard[i];
+        }
+
+        std::array<double, 4> probabilities{};
+        probabilities[0] = rank_probability(size_, size_);
+        probabilities[1] = rank_probability(size_, size_ - 1);
+        probabilities[2] = rank_probability(size_, size_ - 2);
+        probabilities[3] = 1.0 - probabilities[0] - probabilities[1] - probabilities[2];
+
+        chi_square_value_ = 0.0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            double expected = matrices * probabilities[i];
+            double diff = counts[i] - expected;
+            chi_square_value_ += diff * diff / expected;
+        }
+        p_value_ = chi_square_p_value(chi_square_value_, 3.0);
+
+        bool passed = p_value_ > significance_level;
+
+        std::stringstream ss;
+        ss << "Matrices: " << matrices << " (" << size_ << "x" << size_ << ")"
+           << "\nRank L / L-1 / L-2 / lower: " << counts[0] << " / " << counts[1] << " / "
+           << counts[2] << " / " << counts[3]
+           << "\nChi-square value: " << std::fixed << std::setprecision(4) << chi_square_value_
+           << "\nDegrees of freedom: 3"
+           << "\nP-value: " << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    std::string BinaryMatrixRankTest::get_test_name() const
+    {
+        return "Binary Matrix Rank Test (" + std::to_string(size_) + "x" + std::to_string(size_) + ")";
+    }
+
+    std::string BinaryMatrixRankTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double BinaryMatrixRankTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+} // namespace rng
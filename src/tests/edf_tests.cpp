@@ -0,0 +1,336 @@
+#include "../../include/tests/edf_tests.hpp"
+#include "../../include/utils/parallel.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        constexpr size_t CHUNK_SIZE = 1 << 16;
+        constexpr double LOG_CLAMP = 1e-16;
+
+        // Asymptotic Kolmogorov distribution upper tail P(K > lambda)
+        double kolmogorov_q(double lambda)
+        {
+            if (lambda < 0.2)
+                return 1.0;
+            double sum = 0.0;
+            for (int j = 1; j <= 100; ++j)
+            {
+                double term = std::exp(-2.0 * j * j * lambda * lambda);
+                sum += (j % 2 == 1) ? term : -term;
+                if (term < 1e-12)
+                    break;
+            }
+            return std::min(1.0, std::max(0.0, 2.0 * sum));
+        }
+
+        // Limiting Anderson-Darling distribution (Marsaglia & Marsaglia, 2004)
+        double anderson_darling_cdf(double z)
+        {
+            if (z <= 0.0)
+                return 0.0;
+            if (z < 2.0)
+            {
+                return std::exp(-1.2337141 / z) / std::sqrt(z) *
+                       (2.00012 + (0.247105 - (0.0649821 - (0.0347962 - (0.011672 - 0.00168691 * z) * z) * z) * z) * z);
+            }
+            return std::exp(-std::exp(1.0776 - (2.30695 - (0.43424 - (0.082433 - (0.008056 - 0.0003146 * z) * z) * z) * z) * z));
+        }
+
+        double clamp_unit(double u)
+        {
+            return std::min(1.0 - LOG_CLAMP, std::max(LOG_CLAMP, u));
+        }
+
+        // Sum of |p + q j| over j = 1..k
+        long double sum_abs_linear(long double p, long double q, uint64_t k)
+        {
+            auto sum = [&](uint64_t first, uint64_t last) // of p + q j over first..last
+            {
+                if (first > last)
+                    return 0.0L;
+                long double terms = static_cast<long double>(last - first + 1);
+                return terms * p + q * terms * (static_cast<long double>(first) + static_cast<long double>(last)) / 2.0L;
+            };
+            // The sign changes once, after j = -p / q
+            uint64_t split = 0;
+            if (q != 0.0L)
+            {
+                long double root = -p / q;
+                split = root <= 0.0L ? 0 : (root >= static_cast<long double>(k) ? k : static_cast<uint64_t>(root));
+            }
+            else if (p < 0.0L)
+            {
+                split = k;
+            }
+            long double head = sum(1, split), tail = sum(split + 1, k);
+            return std::abs(head) + std::abs(tail);
+        }
+    } // namespace
+
+    // Shared driver
+    EmpiricalDistributionTest::EmpiricalDistributionTest(EdfMode mode, size_t bucket_count, size_t num_threads)
+        : mode_(mode), bucket_count_(bucket_count),
+          num_threads_(num_threads == 0 ? default_thread_count() : num_threads),
+          statistic_(0.0), error_bound_(0.0), p_value_(0.0)
+    {
+        if (bucket_count_ < 2)
+        {
+            throw std::invalid_argument("Bucket count must be at least 2");
+        }
+    }
+
+    bool EmpiricalDistributionTest::run_test(const std::vector<double> &numbers, double significance_level)
+    {
+        VectorSource source(numbers);
+        return run_test(source, significance_level);
+    }
+
+    bool EmpiricalDistributionTest::run_test(DataSource &source, double significance_level)
+    {
+        size_t n = 0;
+        error_bound_ = 0.0;
+
+        if (mode_ == EdfMode::Exact)
+        {
+            std::vector<double> sorted;
+            sorted.reserve(source.size_hint());
+            std::vector<double> chunk(CHUNK_SIZE);
+            while (size_t count = source.read(chunk.data(), chunk.size()))
+            {
+                sorted.insert(sorted.end(), chunk.begin(), chunk.begin() + count);
+            }
+            n = sorted.size();
+            if (n > 0)
+            {
+                parallel_sort(sorted, num_threads_);
+                evaluate_sorted(sorted);
+            }
+        }
+        else
+        {
+            std::vector<uint64_t> counts(bucket_count_, 0);
+            std::vector<double> chunk(CHUNK_SIZE);
+            const double scale = static_cast<double>(bucket_count_);
+            while (size_t count = source.read(chunk.data(), chunk.size()))
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    size_t bucket = static_cast<size_t>(chunk[i] * scale);
+                    counts[std::min(bucket, bucket_count_ - 1)]++;
+                }
+                n += count;
+            }
+            if (n > 0)
+            {
+                evaluate_buckets(counts, n);
+            }
+        }
+
+        if (n == 0)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "No numbers to test\nTest FAILED";
+            return false;
+        }
+
+        bool passed = p_value_ > significance_level;
+
+        std::stringstream ss;
+        ss << "Sample size: " << n
+           << "\nMode: " << (mode_ == EdfMode::Exact ? "exact (sorted)" : "bucketed (" + std::to_string(bucket_count_) + " buckets)")
+           << '\n'
+           << describe()
+           << "\nP-value: " << std::fixed << std::setprecision(4) << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    double EmpiricalDistributionTest::get_error_bound() const
+    {
+        return error_bound_;
+    }
+
+    std::string EmpiricalDistributionTest::get_config() const
+    {
+        // The bucket count only matters in bucketed mode
+        if (mode_ == EdfMode::Exact)
+            return get_test_name() + "|mode=exact";
+        return get_test_name() + "|mode=bucketed|buckets=" + std::to_string(bucket_count_);
+    }
+
+    std::string EmpiricalDistributionTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double EmpiricalDistributionTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+    // Kolmogorov-Smirnov Test Implementation
+    KolmogorovSmirnovTest::KolmogorovSmirnovTest(EdfMode mode, size_t bucket_count, size_t num_threads)
+        : EmpiricalDistributionTest(mode, bucket_count, num_threads) {}
+
+    void KolmogorovSmirnovTest::evaluate_sorted(const std::vector<double> &sorted)
+    {
+        const size_t n = sorted.size();
+        const double inv_n = 1.0 / n;
+        double d = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double above = (i + 1) * inv_n - sorted[i];
+            double below = sorted[i] - i * inv_n;
+            d = std::max(d, std::max(above, below));
+        }
+        statistic_ = d;
+        compute_p_value(n);
+    }
+
+    void KolmogorovSmirnovTest::evaluate_buckets(const std::vector<uint64_t> &counts, size_t n)
+    {
+        const double width = 1.0 / counts.size();
+        double lower = 0.0; // |F_n - F| at the bucket edges, where F_n is known exactly
+        double upper = 0.0; // worst case for any placement of values inside a bucket
+        uint64_t cumulative = 0;
+
+        for (size_t b = 0; b < counts.size(); ++b)
+        {
+            double left = b * width;
+            double right = (b + 1) * width;
+            double before = static_cast<double>(cumulative) / n;
+            cumulative += counts[b];
+            double after = static_cast<double>(cumulative) / n;
+
+            lower = std::max(lower, std::abs(after - right));
+            upper = std::max(upper, std::max(after - left, right - before));
+        }
+
+        statistic_ = 0.5 * (lower + upper);
+        error_bound_ = 0.5 * (upper - lower);
+        compute_p_value(n);
+    }
+
+    void KolmogorovSmirnovTest::compute_p_value(size_t n)
+    {
+        // Stephens' small-sample correction of the asymptotic distribution
+        double root = std::sqrt(static_cast<double>(n));
+        p_value_ = kolmogorov_q((root + 0.12 + 0.11 / root) * statistic_);
+    }
+
+    std::string KolmogorovSmirnovTest::describe() const
+    {
+        std::stringstream ss;
+        ss << "KS statistic D: " << std::fixed << std::setprecision(6) << statistic_;
+        if (mode_ == EdfMode::Bucketed)
+            ss << " (+/- " << error_bound_ << ")";
+        return ss.str();
+    }
+
+    std::string KolmogorovSmirnovTest::get_test_name() const
+    {
+        return "Kolmogorov-Smirnov Test";
+    }
+
+    // Anderson-Darling Test Implementation
+    AndersonDarlingTest::AndersonDarlingTest(EdfMode mode, size_t bucket_count, size_t num_threads)
+        : EmpiricalDistributionTest(mode, bucket_count, num_threads) {}
+
+    void AndersonDarlingTest::evaluate_sorted(const std::vector<double> &sorted)
+    {
+        // A^2 = -n - (1/n) sum_i [(2i - 1) ln u_i + (2(n - i) + 1) ln(1 - u_i)]
+        const size_t n = sorted.size();
+        long double sum = 0.0L;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double u = clamp_unit(sorted[i]);
+            sum += (2.0L * i + 1.0L) * std::log(u) + (2.0L * (n - i) - 1.0L) * std::log1p(-u);
+        }
+        statistic_ = static_cast<double>(-static_cast<long double>(n) - sum / n);
+        p_value_ = 1.0 - anderson_darling_cdf(statistic_);
+    }
+
+    void AndersonDarlingTest::evaluate_buckets(const std::vector<uint64_t> &counts, size_t n)
+    {
+        // Values of bucket b share ranks r+1..r+k, so the rank weights sum to
+        // k(2r + k) for ln u and k(2n - 2r - k) for ln(1 - u).
+        //
+        // Value j of the bucket adds f_j(u) = a_j ln u + b_j ln(1 - u) with
+        // a_j = 2(r + j) - 1 and b_j = 2(n - r - j) + 1, evaluated at the
+        // centre c. f_j is concave, so over the bucket [L, R]
+        //   min(f_j(L), f_j(R)) <= f_j(u) <= f_j(c) + |f_j'(c)| h,
+        // h the larger distance from c to an edge. Both sides are linear in
+        // j and are summed per bucket in closed form, which brackets A^2.
+        const double width = 1.0 / counts.size();
+        const long double nn = static_cast<long double>(n);
+        long double sum = 0.0L;
+        long double above = 0.0L; // largest excess of the true sum over the estimate
+        long double below = 0.0L; // largest shortfall
+        uint64_t cumulative = 0;
+
+        for (size_t b = 0; b < counts.size(); ++b)
+        {
+            if (counts[b] == 0)
+                continue;
+            const uint64_t count = counts[b];
+            long double k = static_cast<long double>(count);
+            long double r = static_cast<long double>(cumulative);
+            double centre = (b + 0.5) * width;
+            long double log_c = std::log(centre), log_1c = std::log1p(-centre);
+            sum += k * (2.0L * r + k) * log_c + k * (2.0L * nn - 2.0L * r - k) * log_1c;
+
+            double left = clamp_unit(b * width), right = clamp_unit((b + 1) * width);
+            long double h = std::max(centre - left, right - centre);
+            long double log_l = std::log(left), log_1l = std::log1p(-left);
+            long double log_r = std::log(right), log_1r = std::log1p(-right);
+
+            // a_j = a0 + 2j and b_j = b0 - 2j
+            long double a0 = 2.0L * r - 1.0L, b0 = 2.0L * (nn - r) + 1.0L;
+            // f_j'(c) = a_j / c - b_j / (1 - c)
+            above += h * sum_abs_linear(a0 / centre - b0 / (1.0L - centre), 2.0L / centre + 2.0L / (1.0L - centre), count);
+
+            // min(f_j(L), f_j(R)) - f_j(c) = g_j(R) - f_j(c) + min(d_j, 0),
+            // with d_j = f_j(L) - f_j(R)
+            long double pr = a0 * (log_r - log_c) + b0 * (log_1r - log_1c);
+            long double qr = 2.0L * (log_r - log_c) - 2.0L * (log_1r - log_1c);
+            long double pd = a0 * (log_l - log_r) + b0 * (log_1l - log_1r);
+            long double qd = 2.0L * (log_l - log_r) - 2.0L * (log_1l - log_1r);
+            long double to_right = k * pr + qr * k * (k + 1.0L) / 2.0L;
+            long double difference = k * pd + qd * k * (k + 1.0L) / 2.0L;
+            long double negative_part = (difference - sum_abs_linear(pd, qd, count)) / 2.0L;
+            below += -std::min(0.0L, to_right + negative_part);
+
+            cumulative += count;
+        }
+        statistic_ = static_cast<double>(-nn - sum / nn);
+        // A^2 falls as the sum rises
+        error_bound_ = static_cast<double>(std::max(above, below) / nn);
+        p_value_ = 1.0 - anderson_darling_cdf(statistic_);
+    }
+
+    std::string AndersonDarlingTest::describe() const
+    {
+        std::stringstream ss;
+        ss << "AD statistic A^2: " << std::fixed << std::setprecision(6) << statistic_;
+        if (mode_ == EdfMode::Bucketed)
+            ss << " (+/- " << error_bound_ << ", bucket centres)";
+        return ss.str();
+    }
+
+    std::string AndersonDarlingTest::get_test_name() const
+    {
+        return "Anderson-Darling Test";
+    }
+
+} // namespace rng
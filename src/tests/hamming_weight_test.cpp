@@ -0,0 +1,297 @@
+#include "../../include/tests/hamming_weight_test.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/parallel.hpp"
+#include "../../include/utils/cpu_dispatch.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Outputs per shard below which a step is not split over threads
+        constexpr size_t MIN_SHARD_SIZE = 1 << 16;
+        // Outputs unpacked from the bit stream at a time
+        constexpr size_t UNPACK_SIZE = 4096;
+
+        size_t power_of_three(size_t exponent)
+        {
+            size_t result = 1;
+            for (size_t i = 0; i < exponent; ++i)
+                result *= 3;
+            return result;
+        }
+
+        // P-value of the largest of m standard normal |z| values (Sidak)
+        double max_z_p_value(double max_z, size_t m)
+        {
+            double q = std::erfc(max_z / std::sqrt(2.0));
+            return -std::expm1(static_cast<double>(m) * std::log1p(-std::min(q, 1.0 - 1e-16)));
+        }
+    } // namespace
+
+    HammingWeightCounts::HammingWeightCounts(unsigned value_bits, size_t tuple_length)
+        : value_bits_(value_bits), tuple_length_(tuple_length), class_of_weight_(value_bits + 1, 0),
+          counts_(size_t(1) << (2 * tuple_length), 0), code_(0), head_(0), count_(0)
+    {
+        if (tuple_length_ == 0 || tuple_length_ > HammingWeightDependencyTest::MAX_TUPLE_LENGTH)
+        {
+            throw std::invalid_argument("Tuple length must be between 1 and " +
+                                        std::to_string(HammingWeightDependencyTest::MAX_TUPLE_LENGTH));
+        }
+        if (value_bits_ < HammingWeightDependencyTest::MIN_VALUE_BITS || value_bits_ > 64)
+        {
+            throw std::invalid_argument("Outputs must have between " +
+                                        std::to_string(HammingWeightDependencyTest::MIN_VALUE_BITS) +
+                                        " and 64 bits");
+        }
+
+        // Binomial(w, 1/2) weights; the middle class is the band around w/2
+        // whose probability is closest to 1/3
+        const unsigned w = value_bits_;
+        std::vector<double> pmf(w + 1);
+        for (unsigned i = 0; i <= w; ++i)
+            pmf[i] = std::exp(std::lgamma(w + 1.0) - std::lgamma(i + 1.0) - std::lgamma(w - i + 1.0) - w * std::log(2.0));
+
+        unsigned low = w / 2, high = (w + 1) / 2;
+        double band = 0.0;
+        for (unsigned i = low; i <= high; ++i)
+            band += pmf[i];
+        while (low > 0 && std::abs(band + pmf[low - 1] + pmf[high + 1] - 1.0 / 3.0) < std::abs(band - 1.0 / 3.0))
+        {
+            band += pmf[--low] + pmf[++high];
+        }
+
+        std::fill(class_probability_, class_probability_ + 3, 0.0);
+        for (unsigned i = 0; i <= w; ++i)
+        {
+            class_of_weight_[i] = i < low ? 0 : (i > high ? 2 : 1);
+            class_probability_[class_of_weight_[i]] += pmf[i];
+        }
+    }
+
+    inline void HammingWeightCounts::push(unsigned weight_class)
+    {
+        if (count_ + 1 < tuple_length_)
+            head_ |= static_cast<uint64_t>(weight_class) << (2 * count_);
+        code_ = ((code_ << 2) | weight_class) & (counts_.size() - 1);
+        if (++count_ >= tuple_length_)
+            ++counts_[code_];
+    }
+
+    void HammingWeightCounts::update(const uint64_t *outputs, size_t count)
+    {
+        const uint64_t mask = value_bits_ == 64 ? ~0ULL : (1ULL << value_bits_) - 1;
+        const auto popcounts = kernels().popcounts;
+        uint8_t weights[UNPACK_SIZE];
+        for (size_t offset = 0; offset < count; offset += UNPACK_SIZE)
+        {
+            size_t length = std::min(UNPACK_SIZE, count - offset);
+            popcounts(outputs + offset, length, mask, weights);
+            for (size_t i = 0; i < length; ++i)
+                push(class_of_weight_[weights[i]]);
+        }
+    }
+
+    void HammingWeightCounts::merge(const HammingWeightCounts &other)
+    {
+        if (other.count_ == 0)
+            return;
+        if (count_ == 0)
+        {
+            counts_ = other.counts_;
+            code_ = other.code_;
+            head_ = other.head_;
+            count_ = other.count_;
+            return;
+        }
+
+        // Tuples straddling the two parts end in the first k - 1 outputs of
+        // the other part, which it could not count
+        uint64_t joined = std::min<uint64_t>(other.count_, tuple_length_ - 1);
+        for (uint64_t i = 0; i < joined; ++i)
+            push(static_cast<unsigned>((other.head_ >> (2 * i)) & 3));
+
+        for (size_t i = 0; i < counts_.size(); ++i)
+            counts_[i] += other.counts_[i];
+        if (other.count_ > joined)
+            code_ = other.code_;
+        count_ += other.count_ - joined;
+    }
+
+    size_t HammingWeightCounts::statistics() const
+    {
+        return 2 * power_of_three(tuple_length_ - 1);
+    }
+
+    double HammingWeightCounts::max_z() const
+    {
+        const uint64_t n = tuples();
+        if (n == 0)
+            return 0.0;
+
+        // Orthonormal functions of the class under its distribution: the
+        // constant, the standardized class and the quadratic orthogonal to both
+        double g[3][3];
+        const double *p = class_probability_;
+        double mean = p[1] + 2.0 * p[2];
+        double sd = std::sqrt(p[1] * (1.0 - mean) * (1.0 - mean) + p[0] * mean * mean + p[2] * (2.0 - mean) * (2.0 - mean));
+        double square_mean = 0.0, square_linear = 0.0;
+        for (int v = 0; v < 3; ++v)
+        {
+            g[0][v] = 1.0;
+            g[1][v] = (v - mean) / sd;
+            square_mean += p[v] * v * v;
+            square_linear += p[v] * v * v * g[1][v];
+        }
+        double norm = 0.0;
+        for (int v = 0; v < 3; ++v)
+        {
+            g[2][v] = v * v - square_mean - square_linear * g[1][v];
+            norm += p[v] * g[2][v] * g[2][v];
+        }
+        for (int v = 0; v < 3; ++v)
+            g[2][v] /= std::sqrt(norm);
+
+        // Dense base-3 array of the counts, digit j being the class j
+        // outputs before the newest
+        const size_t k = tuple_length_;
+        const size_t cells = power_of_three(k);
+        std::vector<double> values(cells);
+        for (size_t index = 0; index < cells; ++index)
+        {
+            uint64_t code = 0;
+            size_t rest = index;
+            for (size_t j = 0; j < k; ++j)
+            {
+                code |= static_cast<uint64_t>(rest % 3) << (2 * j);
+                rest /= 3;
+            }
+            values[index] = static_cast<double>(counts_[code]);
+        }
+
+        // Apply the 3x3 transform along every digit
+        for (size_t stride = 1; stride < cells; stride *= 3)
+        {
+            for (size_t start = 0; start < cells; start += 3 * stride)
+            {
+                for (size_t offset = start; offset < start + stride; ++offset)
+                {
+                    double x[3] = {values[offset], values[offset + stride], values[offset + 2 * stride]};
+                    for (int f = 0; f < 3; ++f)
+                        values[offset + f * stride] = g[f][0] * x[0] + g[f][1] * x[1] + g[f][2] * x[2];
+                }
+            }
+        }
+
+        // Products whose oldest factor is constant repeat a shorter tuple's
+        // sum shifted in time, so only the others are kept
+        const size_t oldest = cells / 3;
+        double largest = 0.0;
+        for (size_t index = oldest; index < cells; ++index)
+            largest = std::max(largest, std::abs(values[index]));
+        return largest / std::sqrt(static_cast<double>(n));
+    }
+
+    HammingWeightDependencyTest::HammingWeightDependencyTest(size_t tuple_length, size_t first_size, size_t num_threads)
+        : tuple_length_(tuple_length), first_size_(first_size),
+          num_threads_(num_threads == 0 ? default_thread_count() : num_threads), p_value_(0.0)
+    {
+        if (tuple_length_ == 0 || tuple_length_ > MAX_TUPLE_LENGTH)
+        {
+            throw std::invalid_argument("Tuple length must be between 1 and " + std::to_string(MAX_TUPLE_LENGTH));
+        }
+        if (first_size_ == 0)
+        {
+            throw std::invalid_argument("First sample size must be positive");
+        }
+    }
+
+    bool HammingWeightDependencyTest::run_test(const BitSequence &bits, double significance_level)
+    {
+        const unsigned w = bits.value_bits;
+        if (w < MIN_VALUE_BITS || w > 64)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "Needs outputs of at least " + std::to_string(MIN_VALUE_BITS) + " bits\nTest FAILED";
+            return false;
+        }
+        const size_t n = bits.bit_count / w;
+        if (n < tuple_length_)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "Not enough outputs for a single tuple\nTest FAILED";
+            return false;
+        }
+
+        std::vector<size_t> sizes;
+        for (size_t size = std::min(first_size_, n); size < n; size *= 2)
+            sizes.push_back(size);
+        sizes.push_back(n);
+
+        std::stringstream ss;
+        ss << "Outputs of " << w << " bits, tuples of " << tuple_length_ << " weight classes";
+
+        HammingWeightCounts total(w, tuple_length_);
+        size_t done = 0;
+        p_value_ = 1.0;
+        for (size_t size : sizes)
+        {
+            const size_t fresh = size - done;
+            const size_t shards = std::min(num_threads_, fresh / MIN_SHARD_SIZE + 1);
+            std::vector<HammingWeightCounts> parts(shards, HammingWeightCounts(w, tuple_length_));
+            parallel_for_shards(fresh, shards, [&](size_t shard, size_t begin, size_t end)
+                                {
+                uint64_t buffer[UNPACK_SIZE];
+                for (size_t i = begin; i < end; i += UNPACK_SIZE)
+                {
+                    size_t count = std::min(UNPACK_SIZE, end - i);
+                    for (size_t j = 0; j < count; ++j)
+                        buffer[j] = read_bits(bits.words.data(), (done + i + j) * w, w);
+                    parts[shard].update(buffer, count);
+                } });
+            for (const auto &part : parts)
+                total.merge(part);
+            done = size;
+
+            double max_z = total.max_z();
+            double p = max_z_p_value(max_z, total.statistics());
+            double corrected = std::min(1.0, p * sizes.size());
+            p_value_ = std::min(p_value_, corrected);
+            ss << "\n" << size << " outputs: max |z| = " << std::fixed << std::setprecision(4) << max_z
+               << ", corrected p = " << std::scientific << std::setprecision(3) << corrected << std::defaultfloat;
+            if (corrected <= significance_level)
+                break;
+        }
+
+        bool passed = p_value_ > significance_level;
+        ss << "\nStatistics per size: " << total.statistics()
+           << "\nP-value: " << std::fixed << std::setprecision(4) << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    std::string HammingWeightDependencyTest::get_test_name() const
+    {
+        return "Hamming Weight Dependency Test (k=" + std::to_string(tuple_length_) + ")";
+    }
+
+    std::string HammingWeightDependencyTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double HammingWeightDependencyTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+} // namespace rng
@@ -0,0 +1,1314 @@
+#include "../../include/tests/knuth_tests.hpp"
+#include "../../include/tests/statistics.hpp"
+#include "../../include/utils/serialization.hpp"
+#include "../../include/utils/parallel.hpp"
+#include "../../include/utils/cpu_dispatch.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Adjacent classes are lumped until each has at least this probability
+        constexpr double MIN_CLASS_PROBABILITY = 0.01;
+        // Up to this many digits, the digits in a hand are looked up by its mask
+        constexpr size_t MAX_TABLE_DIGITS = 16;
+        // Slots of the maximum-of-t bin lookup
+        constexpr size_t MIN_BIN_SLOTS = 1024;
+        constexpr size_t MAX_BIN_SLOTS = 1 << 16;
+
+        size_t to_digit(double number, size_t digits)
+        {
+            size_t digit = static_cast<size_t>(number * digits);
+            return digit >= digits ? digits - 1 : digit;
+        }
+
+        std::vector<uint64_t> widen(const std::vector<uint8_t> &digits)
+        {
+            return std::vector<uint64_t>(digits.begin(), digits.end());
+        }
+
+        std::vector<uint8_t> read_digits(BinaryReader &in, size_t size, size_t digits)
+        {
+            std::vector<uint8_t> result;
+            for (uint64_t value : in.read_u64_vector(size))
+            {
+                if (value >= digits)
+                    throw std::runtime_error("Serialized state holds an invalid digit");
+                result.push_back(static_cast<uint8_t>(value));
+            }
+            return result;
+        }
+
+        // Pearson statistic of `counts` against `probabilities` after lumping
+        // rare classes; stores the degrees of freedom in `df`
+        double lumped_chi_square(const std::vector<double> &probabilities,
+                                 const std::vector<uint64_t> &counts, size_t &df)
+        {
+            uint64_t total = std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+            std::vector<double> lumped_probabilities;
+            std::vector<double> lumped_counts;
+            double probability = 0.0, count = 0.0;
+            for (size_t i = 0; i < probabilities.size(); ++i)
+            {
+                probability += probabilities[i];
+                count += static_cast<double>(counts[i]);
+                if (probability >= MIN_CLASS_PROBABILITY)
+                {
+                    lumped_probabilities.push_back(probability);
+                    lumped_counts.push_back(count);
+                    probability = count = 0.0;
+                }
+            }
+            if (count > 0.0 || probability > 0.0)
+            {
+                if (lumped_probabilities.empty())
+                {
+                    lumped_probabilities.push_back(0.0);
+                    lumped_counts.push_back(0.0);
+                }
+                lumped_probabilities.back() += probability;
+                lumped_counts.back() += count;
+            }
+
+            double chi_square = 0.0;
+            for (size_t i = 0; i < lumped_probabilities.size(); ++i)
+            {
+                double expected = total * lumped_probabilities[i];
+                double diff = lumped_counts[i] - expected;
+                chi_square += diff * diff / expected;
+            }
+            df = lumped_probabilities.size() - 1;
+            return chi_square;
+        }
+
+        // Numbers per shard below which run_test() does not split the work
+        constexpr size_t MIN_SHARD_SIZE = 1 << 16;
+
+        // Knuth's inverse covariance matrix and class probabilities for run
+        // lengths 1..5 and >= 6 (TAOCP Vol. 2, 3rd ed., 3.3.2 (10)-(11))
+        constexpr double RUNS_A[6][6] = {
+            {4529.4, 9044.9, 13568, 18091, 22615, 27892},
+            {9044.9, 18097, 27139, 36187, 45234, 55789},
+            {13568, 27139, 40721, 54281, 67852, 83685},
+            {18091, 36187, 54281, 72414, 90470, 111580},
+            {22615, 45234, 67852, 90470, 113262, 139476},
+            {27892, 55789, 83685, 111580, 139476, 172860}};
+        constexpr double RUNS_B[6] = {1.0 / 6, 5.0 / 24, 11.0 / 120, 19.0 / 720, 29.0 / 5040, 1.0 / 840};
+
+        std::string format_result(const std::string &details, double chi_square, size_t df,
+                                  double p_value, double significance_level, bool passed)
+        {
+            std::stringstream ss;
+            ss << details
+               << "\nChi-square value: " << std::fixed << std::setprecision(4) << chi_square
+               << "\nDegrees of freedom: " << df
+               << "\nP-value: " << p_value
+               << "\nSignificance level: " << significance_level
+               << "\nTest " << (passed ? "PASSED" : "FAILED");
+            return ss.str();
+        }
+    } // namespace
+
+    // Gap Test Implementation
+    GapTest::GapTest(double alpha, double beta, size_t max_gap)
+        : alpha_(alpha), beta_(beta), max_gap_(max_gap), gap_counts_(max_gap + 1, 0),
+          hit_seen_(false), leading_(0), trailing_(0), count_(0), chi_square_value_(0.0), p_value_(0.0)
+    {
+        if (!(0.0 <= alpha_ && alpha_ < beta_ && beta_ <= 1.0))
+        {
+            throw std::invalid_argument("Gap interval must satisfy 0 <= alpha < beta <= 1");
+        }
+        if (max_gap_ == 0)
+        {
+            throw std::invalid_argument("Maximum gap length must be positive");
+        }
+    }
+
+    void GapTest::reset()
+    {
+        std::fill(gap_counts_.begin(), gap_counts_.end(), 0);
+        hit_seen_ = false;
+        leading_ = trailing_ = count_ = 0;
+    }
+
+    void GapTest::record_gap(uint64_t length)
+    {
+        gap_counts_[std::min<uint64_t>(length, max_gap_)]++;
+    }
+
+    void GapTest::update(const double *numbers, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (numbers[i] >= alpha_ && numbers[i] < beta_)
+            {
+                if (hit_seen_)
+                    record_gap(trailing_);
+                else
+                    leading_ = trailing_;
+                hit_seen_ = true;
+                trailing_ = 0;
+            }
+            else
+            {
+                ++trailing_;
+            }
+        }
+        count_ += count;
+    }
+
+    void GapTest::merge(const StreamingTest &other)
+    {
+        const auto &rhs = dynamic_cast<const GapTest &>(other);
+        if (rhs.hit_seen_)
+        {
+            // The gap open at the end of this part closes in the other one
+            if (hit_seen_)
+                record_gap(trailing_ + rhs.leading_);
+            else
+                leading_ = trailing_ + rhs.leading_;
+            hit_seen_ = true;
+            trailing_ = rhs.trailing_;
+            for (size_t i = 0; i < gap_counts_.size(); ++i)
+                gap_counts_[i] += rhs.gap_counts_[i];
+        }
+        else
+        {
+            trailing_ += rhs.trailing_;
+        }
+        count_ += rhs.count_;
+    }
+
+    std::unique_ptr<StreamingTest> GapTest::clone_empty() const
+    {
+        return std::make_unique<GapTest>(alpha_, beta_, max_gap_);
+    }
+
+    void GapTest::save_state(BinaryWriter &out) const
+    {
+        out.write_u64_vector(gap_counts_);
+        out.write_bool(hit_seen_);
+        out.write_u64(leading_);
+        out.write_u64(trailing_);
+        out.write_u64(count_);
+    }
+
+    void GapTest::load_state(BinaryReader &in)
+    {
+        gap_counts_ = in.read_u64_vector(gap_counts_.size());
+        hit_seen_ = in.read_bool();
+        leading_ = in.read_u64();
+        trailing_ = in.read_u64();
+        count_ = in.read_u64();
+    }
+
+    bool GapTest::evaluate(double significance_level)
+    {
+        uint64_t gaps = std::accumulate(gap_counts_.begin(), gap_counts_.end(), uint64_t(0));
+        if (gaps == 0)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "No complete gaps observed\nTest FAILED";
+            return false;
+        }
+
+        // P(gap = r) = p (1 - p)^r, P(gap >= t) = (1 - p)^t
+        double p = beta_ - alpha_;
+        chi_square_value_ = 0.0;
+        for (size_t r = 0; r <= max_gap_; ++r)
+        {
+            double probability = r < max_gap_ ? p * std::pow(1.0 - p, static_cast<double>(r))
+                                              : std::pow(1.0 - p, static_cast<double>(max_gap_));
+            double expected = gaps * probability;
+            double diff = gap_counts_[r] - expected;
+            chi_square_value_ += diff * diff / expected;
+        }
+        p_value_ = chi_square_p_value(chi_square_value_, static_cast<double>(max_gap_));
+
+        bool passed = p_value_ > significance_level;
+        std::stringstream details;
+        details << "Interval: [" << alpha_ << ", " << beta_ << "), gaps observed: " << gaps;
+        result_message_ = format_result(details.str(), chi_square_value_, max_gap_, p_value_,
+                                        significance_level, passed);
+        return passed;
+    }
+
+    std::string GapTest::get_test_name() const
+    {
+        return "Gap Test";
+    }
+
+    std::string GapTest::get_config() const
+    {
+        std::stringstream ss;
+        ss << get_test_name() << std::setprecision(17) << "|alpha=" << alpha_ << "|beta=" << beta_
+           << "|max_gap=" << max_gap_;
+        return ss.str();
+    }
+
+    std::string GapTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double GapTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+    // Poker Test Implementation
+    PokerTest::PokerTest(size_t digits, size_t hand_size)
+        : digits_(digits), hand_size_(hand_size), counts_(hand_size * hand_size, 0),
+          block_(hand_size, 0), previous_(hand_size, 0), suffix_masks_(hand_size, 0), prefix_mask_(0), count_(0),
+          chi_square_value_(0.0), p_value_(0.0)
+    {
+        if (digits_ < 2 || digits_ > 64)
+        {
+            throw std::invalid_argument("Number of digits must be between 2 and 64");
+        }
+        if (hand_size_ < 2 || hand_size_ > 64)
+        {
+            throw std::invalid_argument("Hand size must be between 2 and 64");
+        }
+
+        // P(r distinct) = d (d-1) ... (d-r+1) / d^k * S(k, r), computed as the
+        // distribution of distinct digits after each draw
+        std::vector<double> distinct(hand_size_ + 1, 0.0);
+        distinct[0] = 1.0;
+        for (size_t draw = 0; draw < hand_size_; ++draw)
+        {
+            for (size_t r = draw + 1; r > 0; --r)
+            {
+                distinct[r] = distinct[r] * r / digits_ + distinct[r - 1] * (digits_ - r + 1) / digits_;
+            }
+            distinct[0] = 0.0;
+        }
+        probabilities_.assign(distinct.begin() + 1, distinct.end());
+
+        if (digits_ <= MAX_TABLE_DIGITS)
+        {
+            for (uint64_t hand_mask = 0; hand_mask < (1ULL << digits_); ++hand_mask)
+                distinct_table_.push_back(static_cast<uint8_t>(__builtin_popcountll(hand_mask)));
+        }
+    }
+
+    void PokerTest::reset()
+    {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        head_.clear();
+        prefix_mask_ = 0;
+        count_ = 0;
+    }
+
+    void PokerTest::update(const double *numbers, size_t count)
+    {
+        // Locals, since stores of digits may alias any member
+        const size_t digits = digits_;
+        const size_t k = hand_size_;
+        const uint8_t *table = distinct_table_.empty() ? nullptr : distinct_table_.data();
+        auto distinct = [table](uint64_t hand_mask)
+        { return table ? table[hand_mask] : static_cast<size_t>(__builtin_popcountll(hand_mask)); };
+
+        uint64_t *counts = counts_.data();
+        uint64_t *suffix_masks = suffix_masks_.data();
+        uint8_t *block = block_.data();
+        uint8_t *previous = previous_.data();
+        uint64_t prefix_mask = prefix_mask_;
+        uint64_t position = count_;
+        size_t offset = position % k;
+        for (size_t i = 0; i < count; ++i, ++position)
+        {
+            uint8_t digit = static_cast<uint8_t>(to_digit(numbers[i], digits));
+            if (position < k - 1)
+                head_.push_back(digit);
+            block[offset] = digit;
+            prefix_mask |= 1ULL << digit;
+            if (offset == k - 1)
+            {
+                counts[distinct(prefix_mask) - 1]++;
+
+                // The block becomes the previous one
+                uint64_t suffix_mask = 0;
+                for (size_t j = k; j-- > 0;)
+                {
+                    suffix_mask |= 1ULL << block[j];
+                    suffix_masks[j] = suffix_mask;
+                }
+                std::swap(block, previous);
+                prefix_mask = 0;
+                offset = 0;
+            }
+            else
+            {
+                // The hand ending here starts at offset + 1 of the previous block
+                if (position >= k)
+                    counts[(offset + 1) * k + distinct(suffix_masks[offset + 1] | prefix_mask) - 1]++;
+                ++offset;
+            }
+        }
+        if (block != block_.data())
+            std::swap(block_, previous_);
+        prefix_mask_ = prefix_mask;
+        count_ = position;
+    }
+
+    std::vector<uint8_t> PokerTest::last_digits() const
+    {
+        const size_t k = hand_size_;
+        size_t size = static_cast<size_t>(std::min<uint64_t>(count_, k - 1));
+        uint64_t block_start = count_ - count_ % k;
+        std::vector<uint8_t> last(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            uint64_t position = count_ - size + i;
+            last[i] = position >= block_start ? block_[position - block_start] : previous_[position + k - block_start];
+        }
+        return last;
+    }
+
+    // Rebuilds the blocks of a part of count_ numbers from its last digits;
+    // hands still to come need no earlier ones
+    void PokerTest::restore_blocks(const std::vector<uint8_t> &last)
+    {
+        const size_t k = hand_size_;
+        uint64_t block_start = count_ - count_ % k;
+        prefix_mask_ = 0;
+        for (size_t i = 0; i < last.size(); ++i)
+        {
+            uint64_t position = count_ - last.size() + i;
+            if (position >= block_start)
+            {
+                block_[position - block_start] = last[i];
+                prefix_mask_ |= 1ULL << last[i];
+            }
+            else
+            {
+                previous_[position + k - block_start] = last[i];
+            }
+        }
+        uint64_t mask = 0;
+        for (size_t i = k; count_ >= k && i-- > count_ % k + 1;)
+        {
+            mask |= 1ULL << previous_[i];
+            suffix_masks_[i] = mask;
+        }
+    }
+
+    void PokerTest::merge(const StreamingTest &other)
+    {
+        const auto &rhs = dynamic_cast<const PokerTest &>(other);
+        const size_t k = hand_size_;
+
+        // Hands across the seam lie within the last k - 1 digits here and the
+        // first k - 1 there
+        std::vector<uint8_t> seam = last_digits();
+        const uint64_t seam_start = count_ - seam.size();
+        seam.insert(seam.end(), rhs.head_.begin(), rhs.head_.end());
+        for (size_t start = 0; start + k <= seam.size(); ++start)
+        {
+            uint64_t hand_mask = 0;
+            for (size_t i = start; i < start + k; ++i)
+                hand_mask |= 1ULL << seam[i];
+            counts_[(seam_start + start) % k * k + __builtin_popcountll(hand_mask) - 1]++;
+        }
+
+        // Offsets in the other part are shifted by the length of this one
+        for (size_t row = 0; row < k; ++row)
+        {
+            size_t shifted = (count_ + row) % k;
+            for (size_t r = 0; r < k; ++r)
+                counts_[shifted * k + r] += rhs.counts_[row * k + r];
+        }
+
+        for (size_t i = 0; head_.size() < k - 1 && i < rhs.head_.size(); ++i)
+            head_.push_back(rhs.head_[i]);
+        std::vector<uint8_t> last = rhs.count_ >= k - 1
+                                        ? rhs.last_digits()
+                                        : std::vector<uint8_t>(seam.end() - std::min(seam.size(), k - 1), seam.end());
+        count_ += rhs.count_;
+        restore_blocks(last);
+    }
+
+    std::unique_ptr<StreamingTest> PokerTest::clone_empty() const
+    {
+        return std::make_unique<PokerTest>(digits_, hand_size_);
+    }
+
+    void PokerTest::save_state(BinaryWriter &out) const
+    {
+        out.write_u64_vector(counts_);
+        out.write_u64(count_);
+        out.write_u64_vector(widen(head_));
+        out.write_u64_vector(widen(last_digits()));
+    }
+
+    void PokerTest::load_state(BinaryReader &in)
+    {
+        counts_ = in.read_u64_vector(counts_.size());
+        count_ = in.read_u64();
+        size_t size = static_cast<size_t>(std::min<uint64_t>(count_, hand_size_ - 1));
+        head_ = read_digits(in, size, digits_);
+        restore_blocks(read_digits(in, size, digits_));
+    }
+
+    bool PokerTest::evaluate(double significance_level)
+    {
+        // The sequence starts a hand at every multiple of hand_size
+        std::vector<uint64_t> counts(counts_.begin(), counts_.begin() + hand_size_);
+        uint64_t hands = std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+        if (hands == 0)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "No complete hands observed\nTest FAILED";
+            return false;
+        }
+
+        size_t df = 0;
+        chi_square_value_ = lumped_chi_square(probabilities_, counts, df);
+        p_value_ = chi_square_p_value(chi_square_value_, static_cast<double>(df));
+
+        bool passed = p_value_ > significance_level;
+        std::stringstream details;
+        details << "Hands of " << hand_size_ << " digits (base " << digits_ << "): " << hands;
+        result_message_ = format_result(details.str(), chi_square_value_, df, p_value_,
+                                        significance_level, passed);
+        return passed;
+    }
+
+    std::string PokerTest::get_test_name() const
+    {
+        return "Poker Test";
+    }
+
+    std::string PokerTest::get_config() const
+    {
+        return get_test_name() + "|digits=" + std::to_string(digits_) + "|hand=" + std::to_string(hand_size_);
+    }
+
+    std::string PokerTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double PokerTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+    // Coupon-Collector Test Implementation
+    CouponCollectorTest::CouponCollectorTest(size_t digits, size_t max_length)
+        : digits_(digits), max_length_(max_length), counts_(max_length - digits + 1, 0),
+          seen_mask_(0), length_(0), count_(0), part_mask_(0), first_seen_(digits, 0),
+          restarts_(digits, Restart{std::vector<int64_t>(counts_.size(), 0), 0, 0, false}),
+          live_restarts_(0), chi_square_value_(0.0), p_value_(0.0)
+    {
+        if (digits_ < 2 || digits_ > 64)
+        {
+            throw std::invalid_argument("Number of digits must be between 2 and 64");
+        }
+        if (max_length_ <= digits_)
+        {
+            throw std::invalid_argument("Maximum segment length must exceed the number of digits");
+        }
+
+        // distinct[j]: probability of j distinct digits after the current draw;
+        // a segment ends at draw r when the (d-1) -> d transition happens
+        std::vector<double> distinct(digits_ + 1, 0.0);
+        distinct[0] = 1.0;
+        double complete = 0.0;
+        for (size_t r = 1; r < max_length_; ++r)
+        {
+            double finished = distinct[digits_ - 1] / digits_;
+            for (size_t j = std::min(r, digits_); j > 0; --j)
+            {
+                distinct[j] = distinct[j] * j / digits_ + distinct[j - 1] * (digits_ - j + 1) / digits_;
+            }
+            distinct[0] = 0.0;
+            distinct[digits_] = 0.0;
+            if (r >= digits_)
+            {
+                probabilities_.push_back(finished);
+                complete += finished;
+            }
+        }
+        probabilities_.push_back(1.0 - complete);
+    }
+
+    void CouponCollectorTest::reset()
+    {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        seen_mask_ = 0;
+        length_ = 0;
+        count_ = 0;
+        part_mask_ = 0;
+        std::fill(first_seen_.begin(), first_seen_.end(), 0);
+        for (Restart &restart : restarts_)
+            restart = Restart{std::vector<int64_t>(counts_.size(), 0), 0, 0, false};
+        live_restarts_ = 0;
+    }
+
+    uint64_t CouponCollectorTest::all_digits() const
+    {
+        return digits_ == 64 ? ~0ULL : (1ULL << digits_) - 1;
+    }
+
+    size_t CouponCollectorTest::length_class(uint64_t length) const
+    {
+        return static_cast<size_t>(std::min<uint64_t>(length, max_length_) - digits_);
+    }
+
+    // Advances the restarts still apart from the main segmentation, and the
+    // main segmentation once the part has seen every digit
+    void CouponCollectorTest::step(size_t digit)
+    {
+        const uint64_t all = all_digits();
+        const uint64_t bit = 1ULL << digit;
+        for (Restart &restart : restarts_)
+        {
+            if (!restart.live)
+                continue;
+            restart.mask |= bit;
+            ++restart.length;
+            if (restart.mask == all)
+            {
+                restart.diff[length_class(restart.length)]++;
+                restart.mask = 0;
+                restart.length = 0;
+            }
+        }
+
+        if (part_mask_ == all)
+        {
+            seen_mask_ |= bit;
+            ++length_;
+            if (seen_mask_ == all)
+            {
+                size_t length_index = length_class(length_);
+                counts_[length_index]++;
+                for (Restart &restart : restarts_)
+                {
+                    if (restart.live)
+                        restart.diff[length_index]--;
+                }
+                seen_mask_ = 0;
+                length_ = 0;
+            }
+        }
+        else if ((part_mask_ & bit) == 0)
+        {
+            part_mask_ |= bit;
+            first_seen_[digit] = count_;
+            restarts_[digit].live = true;
+            ++live_restarts_;
+        }
+
+        // A restart in the same open segment as the main one stays with it
+        if (part_mask_ == all)
+        {
+            for (Restart &restart : restarts_)
+            {
+                if (restart.live && restart.mask == seen_mask_ && restart.length == length_)
+                {
+                    restart.live = false;
+                    --live_restarts_;
+                }
+            }
+        }
+        ++count_;
+    }
+
+    void CouponCollectorTest::update(const double *numbers, size_t count)
+    {
+        const uint64_t all = all_digits();
+        size_t i = 0;
+        for (; i < count && (part_mask_ != all || live_restarts_ > 0); ++i)
+            step(to_digit(numbers[i], digits_));
+
+        count_ += count - i;
+        for (; i < count; ++i)
+        {
+            seen_mask_ |= 1ULL << to_digit(numbers[i], digits_);
+            ++length_;
+            if (seen_mask_ == all)
+            {
+                counts_[length_class(length_)]++;
+                seen_mask_ = 0;
+                length_ = 0;
+            }
+        }
+    }
+
+    // Adds the segments this part closes when entered with a segment open
+    // on `mask` for `length` numbers, and leaves the segment open at its end
+    void CouponCollectorTest::carry(uint64_t &mask, uint64_t &length, std::vector<int64_t> &counts) const
+    {
+        uint64_t missing = all_digits() & ~mask;
+        if ((missing & ~part_mask_) != 0)
+        {
+            mask |= part_mask_;
+            length += count_;
+            return;
+        }
+
+        // The open segment ends at the last first occurrence of a missing digit
+        size_t closing = digits_;
+        for (size_t digit = 0; digit < digits_; ++digit)
+        {
+            if ((missing >> digit & 1) && (closing == digits_ || first_seen_[digit] > first_seen_[closing]))
+                closing = digit;
+        }
+        if (closing == digits_)
+            return;
+        counts[length_class(length + first_seen_[closing] + 1)]++;
+
+        const Restart &restart = restarts_[closing];
+        for (size_t i = 0; i < counts.size(); ++i)
+            counts[i] += static_cast<int64_t>(counts_[i]) + restart.diff[i];
+        mask = restart.live ? restart.mask : seen_mask_;
+        length = restart.live ? restart.length : length_;
+    }
+
+    void CouponCollectorTest::merge(const StreamingTest &other)
+    {
+        const auto &rhs = dynamic_cast<const CouponCollectorTest &>(other);
+        if (rhs.count_ == 0)
+            return;
+
+        // Every restart of the merged part, run through both parts
+        const uint64_t merged_mask = part_mask_ | rhs.part_mask_;
+        std::vector<std::vector<int64_t>> totals(digits_, std::vector<int64_t>(counts_.size(), 0));
+        std::vector<uint64_t> masks(digits_, 0), lengths(digits_, 0);
+        for (size_t digit = 0; digit < digits_; ++digit)
+        {
+            const CouponCollectorTest *part = (part_mask_ >> digit & 1) ? this : &rhs;
+            if (!(merged_mask >> digit & 1))
+                continue;
+            const Restart &restart = part->restarts_[digit];
+            for (size_t i = 0; i < counts_.size(); ++i)
+                totals[digit][i] = static_cast<int64_t>(part->counts_[i]) + restart.diff[i];
+            masks[digit] = restart.live ? restart.mask : part->seen_mask_;
+            lengths[digit] = restart.live ? restart.length : part->length_;
+            if (part == this)
+                rhs.carry(masks[digit], lengths[digit], totals[digit]);
+            else
+                first_seen_[digit] = count_ + rhs.first_seen_[digit];
+        }
+
+        std::fill(counts_.begin(), counts_.end(), 0);
+        seen_mask_ = 0;
+        length_ = 0;
+        const bool complete = merged_mask == all_digits();
+        if (complete)
+        {
+            size_t main = 0;
+            for (size_t digit = 1; digit < digits_; ++digit)
+            {
+                if (first_seen_[digit] > first_seen_[main])
+                    main = digit;
+            }
+            for (size_t i = 0; i < counts_.size(); ++i)
+                counts_[i] = static_cast<uint64_t>(totals[main][i]);
+            seen_mask_ = masks[main];
+            length_ = lengths[main];
+        }
+
+        live_restarts_ = 0;
+        for (size_t digit = 0; digit < digits_; ++digit)
+        {
+            if (!(merged_mask >> digit & 1))
+                continue;
+            Restart &restart = restarts_[digit];
+            for (size_t i = 0; i < counts_.size(); ++i)
+                restart.diff[i] = totals[digit][i] - static_cast<int64_t>(counts_[i]);
+            restart.mask = masks[digit];
+            restart.length = lengths[digit];
+            restart.live = !complete || masks[digit] != seen_mask_ || lengths[digit] != length_;
+            live_restarts_ += restart.live;
+        }
+        part_mask_ = merged_mask;
+        count_ += rhs.count_;
+    }
+
+    std::unique_ptr<StreamingTest> CouponCollectorTest::clone_empty() const
+    {
+        return std::make_unique<CouponCollectorTest>(digits_, max_length_);
+    }
+
+    void CouponCollectorTest::save_state(BinaryWriter &out) const
+    {
+        out.write_u64_vector(counts_);
+        out.write_u64(seen_mask_);
+        out.write_u64(length_);
+        out.write_u64(count_);
+        out.write_u64(part_mask_);
+        out.write_u64_vector(first_seen_);
+        for (const Restart &restart : restarts_)
+        {
+            out.write_u64_vector(std::vector<uint64_t>(restart.diff.begin(), restart.diff.end()));
+            out.write_u64(restart.mask);
+            out.write_u64(restart.length);
+            out.write_bool(restart.live);
+        }
+    }
+
+    void CouponCollectorTest::load_state(BinaryReader &in)
+    {
+        counts_ = in.read_u64_vector(counts_.size());
+        seen_mask_ = in.read_u64();
+        length_ = in.read_u64();
+        count_ = in.read_u64();
+        part_mask_ = in.read_u64();
+        first_seen_ = in.read_u64_vector(digits_);
+        if ((part_mask_ | seen_mask_) & ~all_digits())
+            throw std::runtime_error("Serialized state holds an invalid digit");
+        live_restarts_ = 0;
+        for (Restart &restart : restarts_)
+        {
+            std::vector<uint64_t> diff = in.read_u64_vector(counts_.size());
+            restart.diff.assign(diff.begin(), diff.end());
+            restart.mask = in.read_u64();
+            restart.length = in.read_u64();
+            restart.live = in.read_bool();
+            live_restarts_ += restart.live;
+        }
+    }
+
+    bool CouponCollectorTest::evaluate(double significance_level)
+    {
+        // The sequence is entered with an empty segment
+        std::vector<int64_t> closed(counts_.size(), 0);
+        uint64_t mask = 0, length = 0;
+        carry(mask, length, closed);
+        std::vector<uint64_t> counts(closed.begin(), closed.end());
+        uint64_t segments = std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+        if (segments == 0)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "No complete segments observed\nTest FAILED";
+            return false;
+        }
+
+        size_t df = 0;
+        chi_square_value_ = lumped_chi_square(probabilities_, counts, df);
+        p_value_ = chi_square_p_value(chi_square_value_, static_cast<double>(df));
+
+        bool passed = p_value_ > significance_level;
+        std::stringstream details;
+        details << "Digits: " << digits_ << ", segments observed: " << segments;
+        result_message_ = format_result(details.str(), chi_square_value_, df, p_value_,
+                                        significance_level, passed);
+        return passed;
+    }
+
+    std::string CouponCollectorTest::get_test_name() const
+    {
+        return "Coupon-Collector Test";
+    }
+
+    std::string CouponCollectorTest::get_config() const
+    {
+        return get_test_name() + "|digits=" + std::to_string(digits_) + "|max_length=" +
+               std::to_string(max_length_);
+    }
+
+    std::string CouponCollectorTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double CouponCollectorTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+    // Maximum-of-t Test Implementation
+    MaximumOfTTest::MaximumOfTTest(size_t group_size, size_t num_bins)
+        : group_size_(group_size), num_bins_(num_bins), chi_square_value_(0.0), p_value_(0.0)
+    {
+        if (group_size_ < 2)
+        {
+            throw std::invalid_argument("Group size must be at least 2");
+        }
+        if (num_bins_ < 2)
+        {
+            throw std::invalid_argument("Number of bins must be at least 2");
+        }
+
+        // max^t >= b / bins exactly when max >= (b / bins)^(1/t), which saves
+        // a pow() per group; the table is made fine enough that a slot
+        // rarely holds more than one threshold
+        double min_gap = 1.0;
+        double previous_threshold = 0.0;
+        for (size_t b = 1; b < num_bins_; ++b)
+        {
+            thresholds_.push_back(std::pow(static_cast<double>(b) / num_bins_, 1.0 / group_size_));
+            min_gap = std::min(min_gap, thresholds_.back() - previous_threshold);
+            previous_threshold = thresholds_.back();
+        }
+        thresholds_.push_back(std::numeric_limits<double>::infinity());
+        size_t slots = MIN_BIN_SLOTS;
+        while (slots < MAX_BIN_SLOTS && slots * min_gap < 2.0)
+            slots *= 2;
+        for (size_t i = 0; i < slots; ++i)
+        {
+            double low = static_cast<double>(i) / slots;
+            bin_table_.push_back(static_cast<uint32_t>(
+                std::upper_bound(thresholds_.begin(), thresholds_.end(), low) - thresholds_.begin()));
+        }
+        counts_.assign(group_size_ * num_bins_, 0);
+        block_.assign(group_size_, 0.0);
+        previous_.assign(group_size_, 0.0);
+        suffix_max_.assign(group_size_, 0.0);
+        reset();
+    }
+
+    void MaximumOfTTest::reset()
+    {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        head_.clear();
+        prefix_max_ = -std::numeric_limits<double>::infinity();
+        count_ = 0;
+    }
+
+    inline size_t MaximumOfTTest::bin(double maximum) const
+    {
+        double clamped = maximum > 0.0 ? std::min(maximum, 1.0) : 0.0;
+        size_t slot = std::min(static_cast<size_t>(clamped * bin_table_.size()), bin_table_.size() - 1);
+        size_t b = bin_table_[slot];
+        b += maximum >= thresholds_[b];
+        while (maximum >= thresholds_[b])
+            ++b;
+        return b;
+    }
+
+    void MaximumOfTTest::update(const double *numbers, size_t count)
+    {
+        const size_t t = group_size_;
+        const size_t bins = num_bins_;
+        uint64_t *counts = counts_.data();
+        double *suffix_max = suffix_max_.data();
+        double *block = block_.data();
+        double *previous = previous_.data();
+        double prefix_max = prefix_max_;
+        uint64_t position = count_;
+        size_t offset = position % t;
+        for (size_t i = 0; i < count; ++i, ++position)
+        {
+            if (position < t - 1)
+                head_.push_back(numbers[i]);
+            block[offset] = numbers[i];
+            prefix_max = std::max(prefix_max, numbers[i]);
+            if (offset == t - 1)
+            {
+                counts[bin(prefix_max)]++;
+
+                // The block becomes the previous one
+                double maximum = -std::numeric_limits<double>::infinity();
+                for (size_t j = t; j-- > 0;)
+                {
+                    maximum = std::max(maximum, block[j]);
+                    suffix_max[j] = maximum;
+                }
+                std::swap(block, previous);
+                prefix_max = -std::numeric_limits<double>::infinity();
+                offset = 0;
+            }
+            else
+            {
+                // The group ending here starts at offset + 1 of the previous block
+                if (position >= t)
+                    counts[(offset + 1) * bins + bin(std::max(suffix_max[offset + 1], prefix_max))]++;
+                ++offset;
+            }
+        }
+        if (block != block_.data())
+            std::swap(block_, previous_);
+        prefix_max_ = prefix_max;
+        count_ = position;
+    }
+
+    std::vector<double> MaximumOfTTest::last_values() const
+    {
+        const size_t t = group_size_;
+        size_t size = static_cast<size_t>(std::min<uint64_t>(count_, t - 1));
+        uint64_t block_start = count_ - count_ % t;
+        std::vector<double> last(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            uint64_t position = count_ - size + i;
+            last[i] = position >= block_start ? block_[position - block_start] : previous_[position + t - block_start];
+        }
+        return last;
+    }
+
+    // Rebuilds the blocks of a part of count_ numbers from its last numbers
+    void MaximumOfTTest::restore_blocks(const std::vector<double> &last)
+    {
+        const size_t t = group_size_;
+        uint64_t block_start = count_ - count_ % t;
+        prefix_max_ = -std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < last.size(); ++i)
+        {
+            uint64_t position = count_ - last.size() + i;
+            if (position >= block_start)
+            {
+                block_[position - block_start] = last[i];
+                prefix_max_ = std::max(prefix_max_, last[i]);
+            }
+            else
+            {
+                previous_[position + t - block_start] = last[i];
+            }
+        }
+        double maximum = -std::numeric_limits<double>::infinity();
+        for (size_t i = t; count_ >= t && i-- > count_ % t + 1;)
+        {
+            maximum = std::max(maximum, previous_[i]);
+            suffix_max_[i] = maximum;
+        }
+    }
+
+    void MaximumOfTTest::merge(const StreamingTest &other)
+    {
+        const auto &rhs = dynamic_cast<const MaximumOfTTest &>(other);
+        const size_t t = group_size_;
+
+        // Groups across the seam lie within the last t - 1 numbers here and
+        // the first t - 1 there
+        std::vector<double> seam = last_values();
+        const uint64_t seam_start = count_ - seam.size();
+        seam.insert(seam.end(), rhs.head_.begin(), rhs.head_.end());
+        for (size_t start = 0; start + t <= seam.size(); ++start)
+        {
+            double maximum = -std::numeric_limits<double>::infinity();
+            for (size_t i = start; i < start + t; ++i)
+                maximum = std::max(maximum, seam[i]);
+            counts_[(seam_start + start) % t * num_bins_ + bin(maximum)]++;
+        }
+
+        // Offsets in the other part are shifted by the length of this one
+        for (size_t row = 0; row < t; ++row)
+        {
+            size_t shifted = (count_ + row) % t;
+            for (size_t b = 0; b < num_bins_; ++b)
+                counts_[shifted * num_bins_ + b] += rhs.counts_[row * num_bins_ + b];
+        }
+
+        for (size_t i = 0; head_.size() < t - 1 && i < rhs.head_.size(); ++i)
+            head_.push_back(rhs.head_[i]);
+        std::vector<double> last = rhs.count_ >= t - 1
+                                       ? rhs.last_values()
+                                       : std::vector<double>(seam.end() - std::min(seam.size(), t - 1), seam.end());
+        count_ += rhs.count_;
+        restore_blocks(last);
+    }
+
+    std::unique_ptr<StreamingTest> MaximumOfTTest::clone_empty() const
+    {
+        return std::make_unique<MaximumOfTTest>(group_size_, num_bins_);
+    }
+
+    void MaximumOfTTest::save_state(BinaryWriter &out) const
+    {
+        out.write_u64_vector(counts_);
+        out.write_u64(count_);
+        for (double value : head_)
+            out.write_f64(value);
+        for (double value : last_values())
+            out.write_f64(value);
+    }
+
+    void MaximumOfTTest::load_state(BinaryReader &in)
+    {
+        counts_ = in.read_u64_vector(counts_.size());
+        count_ = in.read_u64();
+        size_t size = static_cast<size_t>(std::min<uint64_t>(count_, group_size_ - 1));
+        head_.clear();
+        for (size_t i = 0; i < size; ++i)
+            head_.push_back(in.read_f64());
+        std::vector<double> last;
+        for (size_t i = 0; i < size; ++i)
+            last.push_back(in.read_f64());
+        restore_blocks(last);
+    }
+
+    bool MaximumOfTTest::evaluate(double significance_level)
+    {
+        // The sequence starts a group at every multiple of group_size
+        std::vector<uint64_t> counts(counts_.begin(), counts_.begin() + num_bins_);
+        uint64_t groups = std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+        if (groups == 0)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "No complete groups observed\nTest FAILED";
+            return false;
+        }
+
+        double expected = static_cast<double>(groups) / num_bins_;
+        chi_square_value_ = 0.0;
+        for (uint64_t count : counts)
+        {
+            double diff = count - expected;
+            chi_square_value_ += diff * diff / expected;
+        }
+        size_t df = num_bins_ - 1;
+        p_value_ = chi_square_p_value(chi_square_value_, static_cast<double>(df));
+
+        bool passed = p_value_ > significance_level;
+        std::stringstream details;
+        details << "Groups of " << group_size_ << ": " << groups;
+        result_message_ = format_result(details.str(), chi_square_value_, df, p_value_,
+                                        significance_level, passed);
+        return passed;
+    }
+
+    std::string MaximumOfTTest::get_test_name() const
+    {
+        return "Maximum-of-t Test (t = " + std::to_string(group_size_) + ")";
+    }
+
+    std::string MaximumOfTTest::get_config() const
+    {
+        return get_test_name() + "|bins=" + std::to_string(num_bins_);
+    }
+
+    std::string MaximumOfTTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double MaximumOfTTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+    // Runs Up/Down Test Implementation
+    RunsUpDownTest::RunsUpDownTest(RunDirection direction, size_t num_threads)
+        : direction_(direction), num_threads_(num_threads == 0 ? default_thread_count() : num_threads),
+          run_counts_(6, 0), first_closed_(false), first_run_(0), open_run_(0), first_(0.0), last_(0.0),
+          count_(0), statistic_(0.0), p_value_(0.0) {}
+
+    bool RunsUpDownTest::run_test(const std::vector<double> &numbers, double significance_level)
+    {
+        reset();
+        const size_t n = numbers.size();
+        size_t shards = std::min(num_threads_, n / MIN_SHARD_SIZE + 1);
+        std::vector<std::unique_ptr<StreamingTest>> parts(shards);
+        parallel_for_shards(n, shards, [&](size_t shard, size_t begin, size_t end)
+                            {
+            parts[shard] = clone_empty();
+            parts[shard]->update(numbers.data() + begin, end - begin); });
+        for (const auto &part : parts)
+        {
+            if (part)
+                merge(*part);
+        }
+        return evaluate(significance_level);
+    }
+
+    void RunsUpDownTest::reset()
+    {
+        std::fill(run_counts_.begin(), run_counts_.end(), 0);
+        first_closed_ = false;
+        first_run_ = open_run_ = count_ = 0;
+    }
+
+    void RunsUpDownTest::close_run(uint64_t length)
+    {
+        if (first_closed_)
+        {
+            run_counts_[std::min<uint64_t>(length, 6) - 1]++;
+        }
+        else
+        {
+            first_run_ = length;
+            first_closed_ = true;
+        }
+    }
+
+    void RunsUpDownTest::update(const double *numbers, size_t count)
+    {
+        if (count == 0)
+            return;
+
+        const bool up = direction_ == RunDirection::Up;
+        if (count_ == 0)
+        {
+            first_ = numbers[0];
+            open_run_ = 1;
+        }
+        else if (up ? numbers[0] > last_ : numbers[0] < last_)
+        {
+            ++open_run_;
+        }
+        else
+        {
+            close_run(open_run_);
+            open_run_ = 1;
+        }
+
+        // Pairs (numbers[base + i], numbers[base + i + 1]), 64 at a time; a
+        // clear bit means numbers[base + i + 1] starts a new run
+        const auto continuation_mask = kernels().continuation_mask;
+        for (size_t base = 0; base + 1 < count; base += 64)
+        {
+            size_t length = std::min<size_t>(64, count - 1 - base);
+            uint64_t boundaries = ~continuation_mask(numbers + base, length, up);
+            if (length < 64)
+                boundaries &= (1ULL << length) - 1;
+
+            size_t position = 0;
+            while (boundaries != 0)
+            {
+                size_t boundary = static_cast<size_t>(__builtin_ctzll(boundaries));
+                open_run_ += boundary - position;
+                close_run(open_run_);
+                open_run_ = 1;
+                position = boundary + 1;
+                boundaries &= boundaries - 1;
+            }
+            open_run_ += length - position;
+        }
+
+        last_ = numbers[count - 1];
+        count_ += count;
+    }
+
+    void RunsUpDownTest::merge(const StreamingTest &other)
+    {
+        const auto &rhs = dynamic_cast<const RunsUpDownTest &>(other);
+        if (rhs.count_ == 0)
+            return;
+        if (count_ == 0)
+        {
+            run_counts_ = rhs.run_counts_;
+            first_closed_ = rhs.first_closed_;
+            first_run_ = rhs.first_run_;
+            open_run_ = rhs.open_run_;
+            first_ = rhs.first_;
+            last_ = rhs.last_;
+            count_ = rhs.count_;
+            return;
+        }
+
+        // The first run of the other part either continues the run open at
+        // the end of this one or starts after it
+        bool continues = direction_ == RunDirection::Up ? rhs.first_ > last_ : rhs.first_ < last_;
+        uint64_t joined = rhs.first_closed_ ? rhs.first_run_ : rhs.open_run_;
+        if (continues)
+        {
+            joined += open_run_;
+        }
+        else
+        {
+            close_run(open_run_);
+        }
+
+        if (rhs.first_closed_)
+        {
+            close_run(joined);
+            for (size_t i = 0; i < run_counts_.size(); ++i)
+                run_counts_[i] += rhs.run_counts_[i];
+            open_run_ = rhs.open_run_;
+        }
+        else
+        {
+            open_run_ = joined;
+        }
+        last_ = rhs.last_;
+        count_ += rhs.count_;
+    }
+
+    std::unique_ptr<StreamingTest> RunsUpDownTest::clone_empty() const
+    {
+        return std::make_unique<RunsUpDownTest>(direction_, num_threads_);
+    }
+
+    void RunsUpDownTest::save_state(BinaryWriter &out) const
+    {
+        out.write_u64_vector(run_counts_);
+        out.write_bool(first_closed_);
+        out.write_u64(first_run_);
+        out.write_u64(open_run_);
+        out.write_f64(first_);
+        out.write_f64(last_);
+        out.write_u64(count_);
+    }
+
+    void RunsUpDownTest::load_state(BinaryReader &in)
+    {
+        run_counts_ = in.read_u64_vector(run_counts_.size());
+        first_closed_ = in.read_bool();
+        first_run_ = in.read_u64();
+        open_run_ = in.read_u64();
+        first_ = in.read_f64();
+        last_ = in.read_f64();
+        count_ = in.read_u64();
+    }
+
+    bool RunsUpDownTest::evaluate(double significance_level)
+    {
+        if (count_ <= 6)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "At least 7 numbers are needed\nTest FAILED";
+            return false;
+        }
+
+        // The first and last runs count like the others
+        std::vector<uint64_t> counts = run_counts_;
+        if (first_closed_)
+            counts[std::min<uint64_t>(first_run_, 6) - 1]++;
+        counts[std::min<uint64_t>(open_run_, 6) - 1]++;
+
+        double n = static_cast<double>(count_);
+        double deviations[6];
+        for (size_t i = 0; i < 6; ++i)
+            deviations[i] = static_cast<double>(counts[i]) - n * RUNS_B[i];
+        statistic_ = 0.0;
+        for (size_t i = 0; i < 6; ++i)
+        {
+            for (size_t j = 0; j < 6; ++j)
+                statistic_ += deviations[i] * deviations[j] * RUNS_A[i][j];
+        }
+        statistic_ /= n - 6.0;
+        p_value_ = chi_square_p_value(statistic_, 6.0);
+
+        bool passed = p_value_ > significance_level;
+        std::stringstream details;
+        details << "Runs of length 1 / 2 / 3 / 4 / 5 / >=6: " << counts[0];
+        for (size_t i = 1; i < 6; ++i)
+            details << " / " << counts[i];
+        result_message_ = format_result(details.str(), statistic_, 6, p_value_, significance_level, passed);
+        return passed;
+    }
+
+    std::string RunsUpDownTest::get_test_name() const
+    {
+        return direction_ == RunDirection::Up ? "Runs Up Test (run lengths)" : "Runs Down Test (run lengths)";
+    }
+
+    std::string RunsUpDownTest::get_config() const
+    {
+        return get_test_name();
+    }
+
+    std::string RunsUpDownTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double RunsUpDownTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+} // namespace rng
@@ -0,0 +1,209 @@
+#include "../../include/tests/linear_complexity_test.hpp"
+#include "../../include/tests/statistics.hpp"
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/parallel.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        constexpr size_t CLASSES = 7;
+        constexpr std::array<double, CLASSES> CLASS_PROBABILITIES = {
+            0.010417, 0.03125, 0.125, 0.5, 0.25, 0.0625, 0.020833};
+
+        // Scratch buffers reused across the blocks of one shard
+        struct BerlekampMassey
+        {
+            explicit BerlekampMassey(size_t block_size)
+                : block_size(block_size), words(block_size / 64 + 2),
+                  reversed(words + 1), c(words), b(words), t(words) {}
+
+            // Linear complexity of `block_size` bits starting at `offset`
+            size_t run(const uint64_t *stream, size_t offset)
+            {
+                const size_t n_bits = block_size;
+
+                // reversed bit (n_bits - 1 - i) holds s_i, so the window
+                // s_N, s_(N-1), ... starts at bit (n_bits - 1 - N)
+                std::fill(reversed.begin(), reversed.end(), 0);
+                for (size_t i = 0; i < n_bits; ++i)
+                {
+                    if (read_bits(stream, offset + i, 1))
+                    {
+                        size_t r = n_bits - 1 - i;
+                        reversed[r >> 6] |= 1ULL << (r & 63);
+                    }
+                }
+
+                std::fill(c.begin(), c.end(), 0);
+                std::fill(b.begin(), b.end(), 0);
+                c[0] = b[0] = 1;
+
+                size_t complexity = 0;
+                long long m = -1;
+                for (size_t n = 0; n < n_bits; ++n)
+                {
+                    // d = s_n + sum_{i=1..L} c_i s_(n-i) over GF(2)
+                    size_t start = n_bits - 1 - n;
+                    size_t used = complexity / 64 + 1;
+                    uint64_t acc = 0;
+                    for (size_t w = 0; w < used; ++w)
+                    {
+                        size_t bit = start + 64 * w;
+                        if (bit >= n_bits)
+                            break;
+                        acc ^= c[w] & read_bits(reversed.data(), bit, 64);
+                    }
+                    if ((__builtin_popcountll(acc) & 1) == 0)
+                        continue;
+
+                    // C(x) += B(x) * x^(n - m)
+                    size_t degree_words = (n + 1) / 64 + 1;
+                    bool update_b = 2 * complexity <= n;
+                    if (update_b)
+                        std::copy(c.begin(), c.begin() + degree_words, t.begin());
+
+                    size_t shift = static_cast<size_t>(static_cast<long long>(n) - m);
+                    size_t q = shift >> 6;
+                    unsigned r = static_cast<unsigned>(shift & 63);
+                    for (size_t w = 0; w + q < words && w < degree_words; ++w)
+                    {
+                        uint64_t shifted = b[w] << r;
+                        if (r != 0 && w > 0)
+                            shifted |= b[w - 1] >> (64 - r);
+                        c[w + q] ^= shifted;
+                    }
+                    if (r != 0 && degree_words + q < words)
+                        c[degree_words + q] ^= b[degree_words - 1] >> (64 - r);
+
+                    if (update_b)
+                    {
+                        complexity = n + 1 - complexity;
+                        m = static_cast<long long>(n);
+                        std::copy(t.begin(), t.begin() + degree_words, b.begin());
+                        std::fill(b.begin() + degree_words, b.end(), 0);
+                    }
+                }
+                return complexity;
+            }
+
+            size_t block_size;
+            size_t words;
+            std::vector<uint64_t> reversed;
+            std::vector<uint64_t> c;
+            std::vector<uint64_t> b;
+            std::vector<uint64_t> t;
+        };
+    } // namespace
+
+    LinearComplexityTest::LinearComplexityTest(size_t block_size, size_t num_threads)
+        : block_size_(block_size), num_threads_(num_threads == 0 ? default_thread_count() : num_threads),
+          chi_square_value_(0.0), p_value_(0.0)
+    {
+        if (block_size_ < MIN_BLOCK_SIZE || block_size_ > MAX_BLOCK_SIZE)
+        {
+            throw std::invalid_argument("Block size must be between " + std::to_string(MIN_BLOCK_SIZE) +
+                                        " and " + std::to_string(MAX_BLOCK_SIZE));
+        }
+    }
+
+    bool LinearComplexityTest::run_test(const BitSequence &bits, double significance_level)
+    {
+        const size_t blocks = bits.bit_count / block_size_;
+        if (blocks == 0)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "Not enough bits for a single block of " + std::to_string(block_size_) +
+                              " bits\nTest FAILED";
+            return false;
+        }
+
+        // Expected complexity of a random block of M bits
+        const double M = static_cast<double>(block_size_);
+        const double sign = (block_size_ % 2 == 0) ? 1.0 : -1.0;
+        const double mean = M / 2.0 + (9.0 - sign) / 36.0 - (M / 3.0 + 2.0 / 9.0) / std::pow(2.0, M);
+
+        const size_t shards = std::min(num_threads_, blocks);
+        std::vector<std::array<uint64_t, CLASSES>> shard_counts(shards, std::array<uint64_t, CLASSES>{});
+        std::vector<size_t> shard_minimum(shards, block_size_);
+
+        parallel_for_shards(blocks, shards, [&](size_t shard, size_t begin, size_t end)
+                            {
+            BerlekampMassey bm(block_size_);
+            for (size_t block = begin; block < end; ++block)
+            {
+                size_t complexity = bm.run(bits.words.data(), block * block_size_);
+                shard_minimum[shard] = std::min(shard_minimum[shard], complexity);
+
+                double t = sign * (complexity - mean) + 2.0 / 9.0;
+                size_t index;
+                if (t <= -2.5)
+                    index = 0;
+                else if (t > 2.5)
+                    index = 6;
+                else
+                    index = static_cast<size_t>(static_cast<long long>(std::ceil(t - 0.5)) + 3);
+                ++shard_counts[shard][std::min(index, CLASSES - 1)];
+            } });
+
+        std::array<uint64_t, CLASSES> counts{};
+        size_t minimum = block_size_;
+        for (size_t s = 0; s < shards; ++s)
+        {
+            for (size_t i = 0; i < CLASSES; ++i)
+                counts[i] += shard_counts[s][i];
+            minimum = std::min(minimum, shard_minimum[s]);
+        }
+
+        chi_square_value_ = 0.0;
+        for (size_t i = 0; i < CLASSES; ++i)
+        {
+            double expected = blocks * CLASS_PROBABILITIES[i];
+            double diff = counts[i] - expected;
+            chi_square_value_ += diff * diff / expected;
+        }
+        p_value_ = chi_square_p_value(chi_square_value_, CLASSES - 1.0);
+
+        bool passed = p_value_ > significance_level;
+
+        std::stringstream ss;
+        ss << "Blocks: " << blocks << " of " << block_size_ << " bits"
+           << "\nExpected linear complexity: " << std::fixed << std::setprecision(4) << mean
+           << "\nLowest linear complexity: " << minimum
+           << "\nClass counts:";
+        for (size_t i = 0; i < CLASSES; ++i)
+            ss << ' ' << counts[i];
+        ss << "\nChi-square value: " << chi_square_value_
+           << "\nDegrees of freedom: " << CLASSES - 1
+           << "\nP-value: " << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    std::string LinearComplexityTest::get_test_name() const
+    {
+        return "Linear Complexity Test (M = " + std::to_string(block_size_) + ")";
+    }
+
+    std::string LinearComplexityTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double LinearComplexityTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+} // namespace rng
@@ -0,0 +1,331 @@
+#include "../../include/tests/nist_bit_tests.hpp"
+#include "../../include/tests/statistics.hpp"
+#include "../../include/utils/bits.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Ones among the first bit_count bits of a packed stream
+        uint64_t count_ones(const BitSequence &bits)
+        {
+            size_t full = bits.bit_count / 64;
+            uint64_t ones = popcount_words(bits.words.data(), full);
+            unsigned remaining = static_cast<unsigned>(bits.bit_count & 63);
+            if (remaining != 0)
+                ones += static_cast<uint64_t>(__builtin_popcountll(bits.words[full] & ((1ULL << remaining) - 1)));
+            return ones;
+        }
+
+        // Length of the longest run of ones in a word
+        inline unsigned longest_run_in_word(uint64_t x)
+        {
+            unsigned length = 0;
+            while (x != 0)
+            {
+                x &= x >> 1;
+                ++length;
+            }
+            return length;
+        }
+
+        // Longest run of ones in `length` bits starting at bit `offset`
+        size_t longest_run_in_block(const uint64_t *words, size_t offset, size_t length)
+        {
+            size_t longest = 0;
+            size_t run = 0; // ones at the end of the bits seen so far
+            for (size_t done = 0; done < length; done += 64)
+            {
+                unsigned count = static_cast<unsigned>(std::min<size_t>(64, length - done));
+                uint64_t chunk = read_bits(words, offset + done, count);
+                uint64_t all_ones = count == 64 ? ~0ULL : (1ULL << count) - 1;
+                if (chunk == all_ones)
+                {
+                    run += count;
+                    longest = std::max(longest, run);
+                    continue;
+                }
+
+                // The run carried in continues through the low ones of the chunk
+                size_t low = static_cast<size_t>(__builtin_ctzll(~chunk));
+                longest = std::max(longest, run + low);
+                longest = std::max<size_t>(longest, longest_run_in_word(chunk));
+                // Ones at the top of the valid bits carry into the next chunk
+                run = static_cast<size_t>(__builtin_clzll(~(chunk << (64 - count))));
+            }
+            return longest;
+        }
+
+        // Block size, class bounds and class probabilities of the longest
+        // run test for a stream length (NIST SP 800-22 table 2.4)
+        struct LongestRunTable
+        {
+            size_t block_size;
+            size_t lowest;  // class 0 holds runs of at most this length
+            size_t classes; // the last class holds runs of lowest + classes - 1 or more
+            std::array<double, 7> probabilities;
+        };
+
+        LongestRunTable longest_run_table(size_t bit_count)
+        {
+            if (bit_count < 6272)
+                return {8, 1, 4, {0.21484375, 0.3671875, 0.23046875, 0.1875}};
+            if (bit_count < 750000)
+                return {128, 4, 6, {0.1174035788, 0.242955959, 0.249363483, 0.17517706, 0.102701071, 0.112398847}};
+            return {10000, 10, 7, {0.0882, 0.2092, 0.2483, 0.1933, 0.1208, 0.0675, 0.0727}};
+        }
+    } // namespace
+
+    // Monobit Test Implementation
+    bool MonobitTest::run_test(const BitSequence &bits, double significance_level)
+    {
+        if (bits.bit_count < MIN_BITS)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "At least " + std::to_string(MIN_BITS) + " bits are needed\nTest FAILED";
+            return false;
+        }
+
+        double n = static_cast<double>(bits.bit_count);
+        uint64_t ones = count_ones(bits);
+        double sum = 2.0 * static_cast<double>(ones) - n;
+        double statistic = std::abs(sum) / std::sqrt(n);
+        p_value_ = std::erfc(statistic / std::sqrt(2.0));
+
+        bool passed = p_value_ > significance_level;
+
+        std::stringstream ss;
+        ss << "Bits: " << bits.bit_count << " (" << ones << " ones)"
+           << "\nS_n / sqrt(n): " << std::fixed << std::setprecision(4) << statistic
+           << "\nP-value: " << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    std::string MonobitTest::get_test_name() const
+    {
+        return "Frequency (Monobit) Test on Bits";
+    }
+
+    std::string MonobitTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double MonobitTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+    // Block Frequency Test Implementation
+    BlockFrequencyTest::BlockFrequencyTest(size_t block_size)
+        : block_size_(block_size), chi_square_value_(0.0), p_value_(0.0)
+    {
+        if (block_size_ < MIN_BLOCK_SIZE)
+        {
+            throw std::invalid_argument("Block size must be at least " + std::to_string(MIN_BLOCK_SIZE));
+        }
+    }
+
+    bool BlockFrequencyTest::run_test(const BitSequence &bits, double significance_level)
+    {
+        const size_t blocks = bits.bit_count / block_size_;
+        if (blocks == 0)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "Not enough bits for a single block of " + std::to_string(block_size_) +
+                              "\nTest FAILED";
+            return false;
+        }
+
+        chi_square_value_ = 0.0;
+        const double half = static_cast<double>(block_size_) / 2.0;
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            size_t offset = b * block_size_;
+            uint64_t ones = 0;
+            if ((offset & 63) == 0 && (block_size_ & 63) == 0)
+            {
+                ones = popcount_words(bits.words.data() + offset / 64, block_size_ / 64);
+            }
+            else
+            {
+                for (size_t done = 0; done < block_size_; done += 64)
+                {
+                    unsigned count = static_cast<unsigned>(std::min<size_t>(64, block_size_ - done));
+                    ones += static_cast<uint64_t>(__builtin_popcountll(read_bits(bits.words.data(), offset + done, count)));
+                }
+            }
+            double diff = static_cast<double>(ones) - half;
+            chi_square_value_ += diff * diff;
+        }
+        chi_square_value_ *= 4.0 / static_cast<double>(block_size_);
+        p_value_ = chi_square_p_value(chi_square_value_, static_cast<double>(blocks));
+
+        bool passed = p_value_ > significance_level;
+
+        std::stringstream ss;
+        ss << "Blocks: " << blocks << " of " << block_size_ << " bits"
+           << "\nChi-square value: " << std::fixed << std::setprecision(4) << chi_square_value_
+           << "\nDegrees of freedom: " << blocks
+           << "\nP-value: " << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    std::string BlockFrequencyTest::get_test_name() const
+    {
+        return "Block Frequency Test (M=" + std::to_string(block_size_) + ")";
+    }
+
+    std::string BlockFrequencyTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double BlockFrequencyTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+    // Bit Runs Test Implementation
+    bool BitRunsTest::run_test(const BitSequence &bits, double significance_level)
+    {
+        if (bits.bit_count < MIN_BITS)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "At least " + std::to_string(MIN_BITS) + " bits are needed\nTest FAILED";
+            return false;
+        }
+
+        double n = static_cast<double>(bits.bit_count);
+        double proportion = static_cast<double>(count_ones(bits)) / n;
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(4) << "Proportion of ones: " << proportion;
+
+        // Prerequisite: the runs statistic assumes the frequency test passes
+        if (std::abs(proportion - 0.5) >= 2.0 / std::sqrt(n))
+        {
+            p_value_ = 0.0;
+            ss << "\nFrequency prerequisite not met"
+               << "\nP-value: " << p_value_
+               << "\nSignificance level: " << significance_level
+               << "\nTest FAILED";
+            result_message_ = ss.str();
+            return false;
+        }
+
+        uint64_t runs = count_bit_transitions(bits.words.data(), bits.bit_count) + 1;
+        double spread = proportion * (1.0 - proportion);
+        p_value_ = std::erfc(std::abs(static_cast<double>(runs) - 2.0 * n * spread) /
+                             (2.0 * std::sqrt(2.0 * n) * spread));
+
+        bool passed = p_value_ > significance_level;
+
+        ss << "\nNumber of runs: " << runs
+           << "\nExpected runs: " << 2.0 * n * spread
+           << "\nP-value: " << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    std::string BitRunsTest::get_test_name() const
+    {
+        return "Runs Test on Bits";
+    }
+
+    std::string BitRunsTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double BitRunsTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+    // Longest Run Test Implementation
+    bool LongestRunTest::run_test(const BitSequence &bits, double significance_level)
+    {
+        if (bits.bit_count < MIN_BITS)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "At least " + std::to_string(MIN_BITS) + " bits are needed\nTest FAILED";
+            return false;
+        }
+
+        const LongestRunTable table = longest_run_table(bits.bit_count);
+        block_size_ = table.block_size;
+        const size_t blocks = bits.bit_count / block_size_;
+
+        std::array<uint64_t, 7> counts{};
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            size_t longest = longest_run_in_block(bits.words.data(), b * block_size_, block_size_);
+            size_t index = longest <= table.lowest ? 0 : std::min(longest - table.lowest, table.classes - 1);
+            ++counts[index];
+        }
+
+        chi_square_value_ = 0.0;
+        for (size_t i = 0; i < table.classes; ++i)
+        {
+            double expected = blocks * table.probabilities[i];
+            double diff = counts[i] - expected;
+            chi_square_value_ += diff * diff / expected;
+        }
+        p_value_ = chi_square_p_value(chi_square_value_, static_cast<double>(table.classes - 1));
+
+        bool passed = p_value_ > significance_level;
+
+        std::stringstream ss;
+        ss << "Blocks: " << blocks << " of " << block_size_ << " bits"
+           << "\nLongest runs <=" << table.lowest;
+        for (size_t i = 1; i + 1 < table.classes; ++i)
+            ss << " / " << table.lowest + i;
+        ss << " / >=" << table.lowest + table.classes - 1 << ": " << counts[0];
+        for (size_t i = 1; i < table.classes; ++i)
+            ss << " / " << counts[i];
+        ss << "\nChi-square value: " << std::fixed << std::setprecision(4) << chi_square_value_
+           << "\nDegrees of freedom: " << table.classes - 1
+           << "\nP-value: " << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    std::string LongestRunTest::get_test_name() const
+    {
+        return "Longest Run of Ones in a Block Test";
+    }
+
+    std::string LongestRunTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double LongestRunTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+} // namespace rng
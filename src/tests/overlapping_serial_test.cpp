@@ -0,0 +1,289 @@
+#include "../../include/tests/overlapping_serial_test.hpp"
+#include "../../include/tests/statistics.hpp"
+#include "../../include/utils/parallel.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Cell counts above this size are kept in a hash table instead of a dense array
+        constexpr uint64_t DENSE_CELL_LIMIT = 1ULL << 22;
+        constexpr uint64_t EMPTY_KEY = ~0ULL;
+        constexpr size_t MIN_SHARD_SIZE = 1 << 16;
+        // Below this many expected collisions their count is treated as Poisson
+        constexpr double POISSON_COLLISION_LIMIT = 100.0;
+
+        uint64_t mix_hash(uint64_t x)
+        {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33;
+            return x;
+        }
+
+        // Histogram over [0, cells): dense array when it fits, otherwise an
+        // open-addressing (linear probing) hash table of occupied cells.
+        class CellCounter
+        {
+        public:
+            CellCounter(uint64_t cells, size_t expected_entries)
+                : dense_(cells <= DENSE_CELL_LIMIT), size_(0)
+            {
+                if (dense_)
+                {
+                    counts_.assign(static_cast<size_t>(cells), 0);
+                    return;
+                }
+                size_t target = std::min<size_t>(expected_entries, 1 << 20);
+                size_t capacity = 16;
+                while (capacity < 2 * target)
+                    capacity <<= 1;
+                keys_.assign(capacity, EMPTY_KEY);
+                counts_.assign(capacity, 0);
+            }
+
+            void add(uint64_t cell, uint32_t amount = 1)
+            {
+                if (dense_)
+                {
+                    counts_[cell] += amount;
+                    return;
+                }
+                size_t mask = keys_.size() - 1;
+                size_t slot = mix_hash(cell) & mask;
+                while (keys_[slot] != EMPTY_KEY && keys_[slot] != cell)
+                    slot = (slot + 1) & mask;
+                if (keys_[slot] == EMPTY_KEY)
+                {
+                    keys_[slot] = cell;
+                    if (++size_ * 2 > keys_.size())
+                    {
+                        counts_[slot] = amount;
+                        grow();
+                        return;
+                    }
+                }
+                counts_[slot] += amount;
+            }
+
+            void merge(const CellCounter &other)
+            {
+                other.for_each([this](uint64_t cell, uint32_t count)
+                               { add(cell, count); });
+            }
+
+            // Calls fn(cell, count) for every occupied cell
+            template <typename Fn>
+            void for_each(Fn &&fn) const
+            {
+                for (size_t i = 0; i < counts_.size(); ++i)
+                {
+                    if (dense_ ? counts_[i] != 0 : keys_[i] != EMPTY_KEY)
+                        fn(dense_ ? static_cast<uint64_t>(i) : keys_[i], counts_[i]);
+                }
+            }
+
+        private:
+            bool dense_;
+            size_t size_;
+            std::vector<uint32_t> counts_;
+            std::vector<uint64_t> keys_;
+
+            void grow()
+            {
+                std::vector<uint64_t> old_keys(keys_.size() * 2, EMPTY_KEY);
+                std::vector<uint32_t> old_counts(counts_.size() * 2, 0);
+                old_keys.swap(keys_);
+                old_counts.swap(counts_);
+                size_ = 0;
+                for (size_t i = 0; i < old_keys.size(); ++i)
+                {
+                    if (old_keys[i] != EMPTY_KEY)
+                        add(old_keys[i], old_counts[i]);
+                }
+            }
+        };
+
+        // Summary of a merged histogram: occupied cells and sum of squared counts
+        struct CellSummary
+        {
+            uint64_t occupied = 0;
+            long double sum_squares = 0.0L;
+        };
+
+        CellSummary summarize(const CellCounter &counter)
+        {
+            CellSummary summary;
+            counter.for_each([&summary](uint64_t, uint32_t count)
+                             {
+                ++summary.occupied;
+                summary.sum_squares += static_cast<long double>(count) * count; });
+            return summary;
+        }
+
+        // Pearson statistic sum((c - e)^2 / e) over all k cells, e = n / k
+        double psi_square(const CellSummary &summary, uint64_t cells, size_t n)
+        {
+            long double k = static_cast<long double>(cells);
+            return static_cast<double>(k * summary.sum_squares / n - n);
+        }
+    } // namespace
+
+    OverlappingSerialTest::OverlappingSerialTest(size_t dimension, size_t divisions, size_t num_threads)
+        : dimension_(dimension), divisions_(divisions),
+          num_threads_(num_threads == 0 ? default_thread_count() : num_threads),
+          cells_(1), psi_square_(0.0), collisions_(0), expected_collisions_(0.0), p_value_(0.0)
+    {
+        if (dimension_ == 0 || dimension_ > MAX_DIMENSION)
+        {
+            throw std::invalid_argument("Dimension must be between 1 and " + std::to_string(MAX_DIMENSION));
+        }
+        if (divisions_ < 2)
+        {
+            throw std::invalid_argument("Number of divisions must be at least 2");
+        }
+        for (size_t i = 0; i < dimension_; ++i)
+        {
+            if (cells_ > (1ULL << 62) / divisions_)
+            {
+                throw std::invalid_argument("Number of cells (divisions^dimension) is too large");
+            }
+            cells_ *= divisions_;
+        }
+    }
+
+    bool OverlappingSerialTest::run_test(const std::vector<double> &numbers, double significance_level)
+    {
+        const size_t n = numbers.size();
+        const size_t d = dimension_;
+        const uint64_t t = divisions_;
+        const uint64_t lower_cells = cells_ / t;
+
+        if (n < d)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "Not enough numbers for " + std::to_string(d) + "-tuples\nTest FAILED";
+            return false;
+        }
+
+        auto digit = [&numbers, t](size_t i)
+        {
+            uint64_t value = static_cast<uint64_t>(numbers[i] * t);
+            return value >= t ? t - 1 : value;
+        };
+
+        size_t shards = std::min(num_threads_, n / MIN_SHARD_SIZE + 1);
+        std::vector<CellCounter> upper;
+        std::vector<CellCounter> lower;
+        for (size_t s = 0; s < shards; ++s)
+        {
+            upper.emplace_back(cells_, n / shards + 1);
+            lower.emplace_back(lower_cells, n / shards + 1);
+        }
+
+        // Each shard counts the circular windows starting in [begin, end)
+        parallel_for_shards(n, shards, [&](size_t shard, size_t begin, size_t end)
+                            {
+            uint64_t cell = 0;
+            for (size_t j = 0; j < d; ++j)
+                cell = cell * t + digit((begin + j) % n);
+
+            size_t next = (begin + d) % n;
+            for (size_t i = begin; i < end; ++i)
+            {
+                upper[shard].add(cell);
+                if (d > 1)
+                    lower[shard].add(cell / t);
+                cell = (cell % lower_cells) * t + digit(next);
+                if (++next == n)
+                    next = 0;
+            } });
+
+        for (size_t s = 1; s < shards; ++s)
+        {
+            upper[0].merge(upper[s]);
+            lower[0].merge(lower[s]);
+        }
+
+        CellSummary upper_summary = summarize(upper[0]);
+        double psi_upper = psi_square(upper_summary, cells_, n);
+        double psi_lower = d > 1 ? psi_square(summarize(lower[0]), lower_cells, n) : 0.0;
+        psi_square_ = psi_upper - psi_lower;
+
+        double k = static_cast<double>(cells_);
+        collisions_ = n - upper_summary.occupied;
+        expected_collisions_ = n - k + k * std::exp(n * std::log1p(-1.0 / k));
+
+        // Variance of the number of empty cells (and so of the collisions):
+        // k p1 (1 - p1) + k (k - 1) (p2 - p1^2), with p2 - p1^2 rewritten to
+        // avoid cancellation
+        double p1 = std::exp(n * std::log1p(-1.0 / k));
+        double collision_variance = k * p1 * (1.0 - p1) +
+                                    k * (k - 1.0) * p1 * p1 * std::expm1(n * std::log1p(-1.0 / ((k - 1.0) * (k - 1.0))));
+
+        double expected_per_cell = n / k;
+        double df = static_cast<double>(cells_ - lower_cells);
+        std::string regime;
+        if (expected_per_cell >= 1.0)
+        {
+            regime = "chi-square";
+            p_value_ = chi_square_p_value(std::max(psi_square_, 0.0), df);
+        }
+        else if (expected_collisions_ < POISSON_COLLISION_LIMIT)
+        {
+            regime = "collisions, Poisson (sparse cells)";
+            p_value_ = poisson_p_value(collisions_, expected_collisions_);
+        }
+        else
+        {
+            regime = "collisions, normal (sparse cells)";
+            double z = (collisions_ - expected_collisions_) / std::sqrt(collision_variance);
+            p_value_ = 2.0 * (1.0 - normal_cdf(std::abs(z)));
+        }
+
+        bool passed = p_value_ > significance_level;
+
+        std::stringstream ss;
+        ss << "Dimension: " << d << ", divisions: " << t << ", cells: " << cells_
+           << "\nOverlapping psi-square statistic: " << std::fixed << std::setprecision(4) << psi_square_
+           << "\nDegrees of freedom: " << static_cast<uint64_t>(df)
+           << "\nCollisions: " << collisions_ << " (expected " << expected_collisions_ << ")"
+           << "\nVerdict based on: " << regime
+           << "\nP-value: " << p_value_
+           << "\nSignificance level: " << significance_level
+           << "\nTest " << (passed ? "PASSED" : "FAILED");
+        result_message_ = ss.str();
+
+        return passed;
+    }
+
+    std::string OverlappingSerialTest::get_test_name() const
+    {
+        return "Overlapping Serial Test (" + std::to_string(dimension_) + "-tuples)";
+    }
+
+    std::string OverlappingSerialTest::get_config() const
+    {
+        return get_test_name() + "|divisions=" + std::to_string(divisions_);
+    }
+
+    std::string OverlappingSerialTest::get_test_result() const
+    {
+        return result_message_;
+    }
+
+    double OverlappingSerialTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
+} // namespace rng
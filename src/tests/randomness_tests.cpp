@@ -1,54 +1,104 @@
 #include "../../include/tests/randomness_tests.hpp"
+#include "../../include/tests/statistics.hpp"
+#include "../../include/utils/serialization.hpp"
+#include "../../include/utils/cpu_dispatch.hpp"
+#include "../../include/tests/overlapping_serial_test.hpp"
+#include "../../include/tests/edf_tests.hpp"
+#include "../../include/tests/knuth_tests.hpp"
+#include "../../include/tests/binary_matrix_rank_test.hpp"
+#include "../../include/tests/linear_complexity_test.hpp"
+#include "../../include/tests/nist_bit_tests.hpp"
+#include "../../include/tests/hamming_weight_test.hpp"
 #include <cmath>
+#include <limits>
 #include <algorithm>
-#include <numeric>
 #include <sstream>
 #include <iomanip>
 
 namespace rng
 {
 
-    // Helper function to calculate critical values
-    double get_critical_value(double significance_level, size_t df)
+    // Chi-Square Test Implementation
+    ChiSquareTest::ChiSquareTest(size_t num_bins)
+        : num_bins_(num_bins), observed_(num_bins, 0), count_(0), chi_square_value_(0.0), p_value_(0.0) {}
+
+    void ChiSquareTest::reset()
     {
-        // Simplified critical values for chi-square test
-        // In a real implementation, this would use a proper statistical library
-        if (significance_level == 0.01)
-            return df * 1.5;
-        if (significance_level == 0.05)
-            return df * 1.3;
-        return df * 1.2; // For 0.10
+        std::fill(observed_.begin(), observed_.end(), 0);
+        count_ = 0;
     }
 
-    // Helper function to calculate normal distribution p-value
-    double normal_cdf(double z)
+    void ChiSquareTest::update(const double *numbers, size_t count)
     {
-        // Approximation of the normal CDF
-        return 0.5 * (1 + std::erf(z / std::sqrt(2)));
+        if (num_bins_ >= (size_t(1) << 31))
+        {
+            // Count observations in each bin
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t bin = static_cast<size_t>(numbers[i] * num_bins_);
+                if (bin == num_bins_)
+                    bin--; // Handle edge case of 1.0
+                observed_[bin]++;
+            }
+            count_ += count;
+            return;
+        }
+
+        // Bin indices are computed a block at a time by the vector kernel
+        constexpr size_t BIN_BLOCK = 1024;
+        uint32_t bins[BIN_BLOCK];
+        const auto bin_numbers = kernels().bin_numbers;
+        for (size_t offset = 0; offset < count; offset += BIN_BLOCK)
+        {
+            size_t length = std::min(BIN_BLOCK, count - offset);
+            bin_numbers(numbers + offset, length, static_cast<uint32_t>(num_bins_), bins);
+            for (size_t i = 0; i < length; ++i)
+                observed_[bins[i]]++;
+        }
+        count_ += count;
     }
 
-    // Chi-Square Test Implementation
-    ChiSquareTest::ChiSquareTest(size_t num_bins)
-        : num_bins_(num_bins), chi_square_value_(0.0), p_value_(0.0) {}
+    void ChiSquareTest::merge(const StreamingTest &other)
+    {
+        const auto &rhs = dynamic_cast<const ChiSquareTest &>(other);
+        for (size_t i = 0; i < num_bins_; ++i)
+        {
+            observed_[i] += rhs.observed_[i];
+        }
+        count_ += rhs.count_;
+    }
+
+    std::unique_ptr<StreamingTest> ChiSquareTest::clone_empty() const
+    {
+        return std::make_unique<ChiSquareTest>(num_bins_);
+    }
+
+    void ChiSquareTest::save_state(BinaryWriter &out) const
+    {
+        out.write_u64_vector(observed_);
+        out.write_u64(count_);
+    }
 
-    bool ChiSquareTest::run_test(const std::vector<double> &numbers, double significance_level)
+    void ChiSquareTest::load_state(BinaryReader &in)
     {
-        std::vector<size_t> observed(num_bins_, 0);
-        size_t n = numbers.size();
-        double expected = static_cast<double>(n) / num_bins_;
+        observed_ = in.read_u64_vector(num_bins_);
+        count_ = in.read_u64();
+    }
 
-        // Count observations in each bin
-        for (double number : numbers)
+    bool ChiSquareTest::evaluate(double significance_level)
+    {
+        if (count_ == 0)
         {
-            size_t bin = static_cast<size_t>(number * num_bins_);
-            if (bin == num_bins_)
-                bin--; // Handle edge case of 1.0
-            observed[bin]++;
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            result_message_ = "No numbers to test\nTest FAILED";
+            return false;
         }
 
+        double expected = static_cast<double>(count_) / num_bins_;
+
         // Calculate chi-square statistic
         chi_square_value_ = 0.0;
-        for (size_t count : observed)
+        for (uint64_t count : observed_)
         {
             double diff = count - expected;
             chi_square_value_ += (diff * diff) / expected;
@@ -56,13 +106,13 @@ namespace rng
 
         // Degrees of freedom
         size_t df = num_bins_ - 1;
-        double critical_value = get_critical_value(significance_level, df);
-        bool passed = chi_square_value_ <= critical_value;
+        p_value_ = chi_square_p_value(chi_square_value_, static_cast<double>(df));
+        bool passed = p_value_ > significance_level;
 
         std::stringstream ss;
         ss << "Chi-square value: " << std::fixed << std::setprecision(4) << chi_square_value_
-           << "\nCritical value: " << critical_value
            << "\nDegrees of freedom: " << df
+           << "\nP-value: " << p_value_
            << "\nSignificance level: " << significance_level
            << "\nTest " << (passed ? "PASSED" : "FAILED");
         result_message_ = ss.str();
@@ -75,32 +125,129 @@ namespace rng
         return "Chi-Square Test for Uniformity";
     }
 
+    std::string ChiSquareTest::get_config() const
+    {
+        return get_test_name() + "|bins=" + std::to_string(num_bins_);
+    }
+
     std::string ChiSquareTest::get_test_result() const
     {
         return result_message_;
     }
 
+    double ChiSquareTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
     // Runs Test Implementation
-    bool RunsTest::run_test(const std::vector<double> &numbers, double significance_level)
+    RunsTest::RunsTest()
+        : count_(0), changes_(0), first_(0.0), last_(0.0),
+          first_increasing_(false), last_increasing_(false), z_statistic_(0.0), p_value_(0.0) {}
+
+    void RunsTest::reset()
     {
-        if (numbers.size() < 2)
-            return false;
+        count_ = 0;
+        changes_ = 0;
+    }
 
-        size_t runs = 1;
-        bool increasing = numbers[1] > numbers[0];
+    void RunsTest::update(const double *numbers, size_t count)
+    {
+        if (count == 0)
+            return;
 
-        // Count runs
-        for (size_t i = 1; i < numbers.size(); ++i)
+        size_t start = 0;
+        if (count_ == 0)
         {
-            if ((numbers[i] > numbers[i - 1]) != increasing)
-            {
-                increasing = !increasing;
-                runs++;
-            }
+            first_ = numbers[0];
+            start = 1;
+        }
+
+        double previous = count_ == 0 ? numbers[0] : last_;
+        bool have_direction = count_ >= 2;
+        bool increasing = last_increasing_;
+
+        // Count changes of direction
+        for (size_t i = start; i < count; ++i)
+        {
+            bool current = numbers[i] > previous;
+            if (have_direction)
+                changes_ += current != increasing;
+            else
+                first_increasing_ = current;
+            have_direction = true;
+            increasing = current;
+            previous = numbers[i];
+        }
+
+        count_ += count;
+        last_ = previous;
+        last_increasing_ = increasing;
+    }
+
+    void RunsTest::merge(const StreamingTest &other)
+    {
+        const auto &rhs = dynamic_cast<const RunsTest &>(other);
+        if (rhs.count_ == 0)
+            return;
+        if (count_ == 0)
+        {
+            *this = rhs;
+            return;
+        }
+
+        // Direction of the pair that straddles the two parts
+        bool joint = rhs.first_ > last_;
+        if (count_ >= 2)
+            changes_ += joint != last_increasing_;
+        else
+            first_increasing_ = joint;
+        if (rhs.count_ >= 2)
+            changes_ += rhs.first_increasing_ != joint;
+
+        changes_ += rhs.changes_;
+        count_ += rhs.count_;
+        last_ = rhs.last_;
+        last_increasing_ = rhs.count_ >= 2 ? rhs.last_increasing_ : joint;
+    }
+
+    std::unique_ptr<StreamingTest> RunsTest::clone_empty() const
+    {
+        return std::make_unique<RunsTest>();
+    }
+
+    void RunsTest::save_state(BinaryWriter &out) const
+    {
+        out.write_u64(count_);
+        out.write_u64(changes_);
+        out.write_f64(first_);
+        out.write_f64(last_);
+        out.write_bool(first_increasing_);
+        out.write_bool(last_increasing_);
+    }
+
+    void RunsTest::load_state(BinaryReader &in)
+    {
+        count_ = in.read_u64();
+        changes_ = in.read_u64();
+        first_ = in.read_f64();
+        last_ = in.read_f64();
+        first_increasing_ = in.read_bool();
+        last_increasing_ = in.read_bool();
+    }
+
+    bool RunsTest::evaluate(double significance_level)
+    {
+        if (count_ < 2)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            return false;
         }
 
+        size_t runs = changes_ + 1;
+
         // Calculate test statistic
-        double n = static_cast<double>(numbers.size());
+        double n = static_cast<double>(count_);
         double expected_runs = (2.0 * n - 1.0) / 3.0;
         double variance = (16.0 * n - 29.0) / 90.0;
         z_statistic_ = (runs - expected_runs) / std::sqrt(variance);
@@ -124,42 +271,123 @@ namespace rng
         return "Runs Test for Independence";
     }
 
+    std::string RunsTest::get_config() const
+    {
+        return get_test_name();
+    }
+
     std::string RunsTest::get_test_result() const
     {
         return result_message_;
     }
 
+    double RunsTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
     // Serial Correlation Test Implementation
-    bool SerialCorrelationTest::run_test(const std::vector<double> &numbers, double significance_level)
+    SerialCorrelationTest::SerialCorrelationTest()
+        : count_(0), first_(0.0), last_(0.0), sum_x_(0.0), sum_y_(0.0), sum_xx_(0.0),
+          sum_yy_(0.0), sum_xy_(0.0), correlation_coefficient_(0.0), z_statistic_(0.0), p_value_(0.0) {}
+
+    void SerialCorrelationTest::reset()
     {
-        if (numbers.size() < 2)
-            return false;
+        count_ = 0;
+        sum_x_ = sum_y_ = sum_xx_ = sum_yy_ = sum_xy_ = 0.0;
+    }
 
-        size_t n = numbers.size() - 1;
-        std::vector<double> x(n), y(n);
+    void SerialCorrelationTest::update(const double *numbers, size_t count)
+    {
+        if (count == 0)
+            return;
 
-        // Prepare pairs of consecutive numbers
-        for (size_t i = 0; i < n; ++i)
+        double sums[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        if (count_ == 0)
+        {
+            first_ = numbers[0];
+        }
+        else
         {
-            x[i] = numbers[i];
-            y[i] = numbers[i + 1];
+            // Pair that joins the previous block to this one
+            double x = last_ - 0.5;
+            double y = numbers[0] - 0.5;
+            sums[0] = x;
+            sums[1] = y;
+            sums[2] = x * x;
+            sums[3] = y * y;
+            sums[4] = x * y;
         }
 
-        // Calculate means
-        double mean_x = std::accumulate(x.begin(), x.end(), 0.0) / n;
-        double mean_y = std::accumulate(y.begin(), y.end(), 0.0) / n;
+        // Accumulate pairs of consecutive numbers
+        kernels().pair_sums(numbers, count, sums);
 
-        // Calculate correlation coefficient
-        double numerator = 0.0, denom_x = 0.0, denom_y = 0.0;
-        for (size_t i = 0; i < n; ++i)
+        sum_x_ += sums[0];
+        sum_y_ += sums[1];
+        sum_xx_ += sums[2];
+        sum_yy_ += sums[3];
+        sum_xy_ += sums[4];
+        count_ += count;
+        last_ = numbers[count - 1];
+    }
+
+    void SerialCorrelationTest::merge(const StreamingTest &other)
+    {
+        const auto &rhs = dynamic_cast<const SerialCorrelationTest &>(other);
+        if (rhs.count_ == 0)
+            return;
+        if (count_ == 0)
         {
-            double dx = x[i] - mean_x;
-            double dy = y[i] - mean_y;
-            numerator += dx * dy;
-            denom_x += dx * dx;
-            denom_y += dy * dy;
+            *this = rhs;
+            return;
         }
 
+        // Pair that straddles the two parts
+        double x = last_ - 0.5;
+        double y = rhs.first_ - 0.5;
+        sum_x_ += x + rhs.sum_x_;
+        sum_y_ += y + rhs.sum_y_;
+        sum_xx_ += x * x + rhs.sum_xx_;
+        sum_yy_ += y * y + rhs.sum_yy_;
+        sum_xy_ += x * y + rhs.sum_xy_;
+        count_ += rhs.count_;
+        last_ = rhs.last_;
+    }
+
+    std::unique_ptr<StreamingTest> SerialCorrelationTest::clone_empty() const
+    {
+        return std::make_unique<SerialCorrelationTest>();
+    }
+
+    void SerialCorrelationTest::save_state(BinaryWriter &out) const
+    {
+        out.write_u64(count_);
+        for (double value : {first_, last_, sum_x_, sum_y_, sum_xx_, sum_yy_, sum_xy_})
+            out.write_f64(value);
+    }
+
+    void SerialCorrelationTest::load_state(BinaryReader &in)
+    {
+        count_ = in.read_u64();
+        for (double *value : {&first_, &last_, &sum_x_, &sum_y_, &sum_xx_, &sum_yy_, &sum_xy_})
+            *value = in.read_f64();
+    }
+
+    bool SerialCorrelationTest::evaluate(double significance_level)
+    {
+        if (count_ < 2)
+        {
+            p_value_ = std::numeric_limits<double>::quiet_NaN();
+            return false;
+        }
+
+        double n = static_cast<double>(count_ - 1);
+
+        // Calculate correlation coefficient from the centred sums
+        double numerator = sum_xy_ - sum_x_ * sum_y_ / n;
+        double denom_x = sum_xx_ - sum_x_ * sum_x_ / n;
+        double denom_y = sum_yy_ - sum_y_ * sum_y_ / n;
+
         correlation_coefficient_ = numerator / std::sqrt(denom_x * denom_y);
         z_statistic_ = correlation_coefficient_ * std::sqrt(n);
         p_value_ = 2.0 * (1.0 - normal_cdf(std::abs(z_statistic_)));
@@ -183,18 +411,50 @@ namespace rng
         return "Serial Correlation Test";
     }
 
+    std::string SerialCorrelationTest::get_config() const
+    {
+        return get_test_name();
+    }
+
     std::string SerialCorrelationTest::get_test_result() const
     {
         return result_message_;
     }
 
+    double SerialCorrelationTest::get_p_value() const
+    {
+        return p_value_;
+    }
+
     // Factory function implementation
     std::vector<std::unique_ptr<RandomnessTest>> create_test_suite()
     {
         std::vector<std::unique_ptr<RandomnessTest>> tests;
         tests.push_back(std::make_unique<ChiSquareTest>());
         tests.push_back(std::make_unique<RunsTest>());
+        tests.push_back(std::make_unique<RunsUpDownTest>(RunDirection::Up));
+        tests.push_back(std::make_unique<RunsUpDownTest>(RunDirection::Down));
         tests.push_back(std::make_unique<SerialCorrelationTest>());
+        tests.push_back(std::make_unique<GapTest>());
+        tests.push_back(std::make_unique<PokerTest>());
+        tests.push_back(std::make_unique<CouponCollectorTest>());
+        tests.push_back(std::make_unique<MaximumOfTTest>());
+        tests.push_back(std::make_unique<OverlappingSerialTest>());
+        tests.push_back(std::make_unique<KolmogorovSmirnovTest>());
+        tests.push_back(std::make_unique<AndersonDarlingTest>());
+        return tests;
+    }
+
+    std::vector<std::unique_ptr<BitStreamTest>> create_bit_test_suite()
+    {
+        std::vector<std::unique_ptr<BitStreamTest>> tests;
+        tests.push_back(std::make_unique<MonobitTest>());
+        tests.push_back(std::make_unique<BlockFrequencyTest>());
+        tests.push_back(std::make_unique<BitRunsTest>());
+        tests.push_back(std::make_unique<LongestRunTest>());
+        tests.push_back(std::make_unique<HammingWeightDependencyTest>());
+        tests.push_back(std::make_unique<BinaryMatrixRankTest>());
+        tests.push_back(std::make_unique<LinearComplexityTest>());
         return tests;
     }
 
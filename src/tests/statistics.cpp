@@ -0,0 +1,152 @@
+#include "../../include/tests/statistics.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        constexpr int MAX_ITERATIONS = 100000;
+        constexpr double EPSILON = 1e-14;
+        constexpr double TINY = 1e-300;
+
+        // Series expansion of P(a, x), valid for x < a + 1
+        double gamma_series(double a, double x)
+        {
+            double sum = 1.0 / a;
+            double term = sum;
+            double ap = a;
+            for (int n = 0; n < MAX_ITERATIONS; ++n)
+            {
+                ap += 1.0;
+                term *= x / ap;
+                sum += term;
+                if (std::abs(term) < std::abs(sum) * EPSILON)
+                    break;
+            }
+            return sum * std::exp(-x + a * std::log(x) - std::lgamma(a));
+        }
+
+        // Continued fraction (modified Lentz) for Q(a, x), valid for x >= a + 1
+        double gamma_continued_fraction(double a, double x)
+        {
+            double b = x + 1.0 - a;
+            double c = 1.0 / TINY;
+            double d = 1.0 / b;
+            double h = d;
+            for (int i = 1; i < MAX_ITERATIONS; ++i)
+            {
+                double an = -i * (i - a);
+                b += 2.0;
+                d = an * d + b;
+                if (std::abs(d) < TINY)
+                    d = TINY;
+                c = b + an / c;
+                if (std::abs(c) < TINY)
+                    c = TINY;
+                d = 1.0 / d;
+                double delta = d * c;
+                h *= delta;
+                if (std::abs(delta - 1.0) < EPSILON)
+                    break;
+            }
+            return std::exp(-x + a * std::log(x) - std::lgamma(a)) * h;
+        }
+    } // namespace
+
+    double normal_cdf(double z)
+    {
+        return 0.5 * std::erfc(-z / std::sqrt(2.0));
+    }
+
+    double normal_quantile(double p)
+    {
+        if (!(p > 0.0 && p < 1.0))
+            throw std::invalid_argument("Normal quantile needs a probability in (0, 1)");
+
+        // Acklam's rational approximation (relative error 1.15e-9) ...
+        static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                   1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+        static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                   6.680131188771972e+01, -1.328068155288572e+01};
+        static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                   -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+        static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                   3.754408661907416e+00};
+        const double low = 0.02425;
+
+        double z;
+        if (p < low || p > 1.0 - low)
+        {
+            double q = std::sqrt(-2.0 * std::log(std::min(p, 1.0 - p)));
+            z = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+            if (p > 1.0 - low)
+                z = -z;
+        }
+        else
+        {
+            double q = p - 0.5;
+            double r = q * q;
+            z = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+                (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+        }
+
+        // ... polished by one Halley step to full double precision
+        double e = normal_cdf(z) - p;
+        double u = e * 2.50662827463100050 * std::exp(z * z / 2.0); // sqrt(2 pi)
+        return z - u / (1.0 + z * u / 2.0);
+    }
+
+    double regularized_gamma_p(double a, double x)
+    {
+        if (a <= 0.0)
+            throw std::invalid_argument("Gamma shape must be positive");
+        if (x <= 0.0)
+            return 0.0;
+        if (x < a + 1.0)
+            return gamma_series(a, x);
+        return 1.0 - gamma_continued_fraction(a, x);
+    }
+
+    double regularized_gamma_q(double a, double x)
+    {
+        if (a <= 0.0)
+            throw std::invalid_argument("Gamma shape must be positive");
+        if (x <= 0.0)
+            return 1.0;
+        if (x < a + 1.0)
+            return 1.0 - gamma_series(a, x);
+        return gamma_continued_fraction(a, x);
+    }
+
+    double chi_square_p_value(double statistic, double df)
+    {
+        if (df <= 0.0)
+            throw std::invalid_argument("Degrees of freedom must be positive");
+
+        // Wilson-Hilferty approximation once the exact series becomes expensive
+        if (df > 1e6)
+        {
+            double v = 2.0 / (9.0 * df);
+            double z = (std::cbrt(statistic / df) - (1.0 - v)) / std::sqrt(v);
+            return 1.0 - normal_cdf(z);
+        }
+        return regularized_gamma_q(df / 2.0, statistic / 2.0);
+    }
+
+    double poisson_p_value(uint64_t observed, double mean)
+    {
+        if (mean <= 0.0)
+            return observed == 0 ? 1.0 : 0.0;
+
+        double k = static_cast<double>(observed);
+        // P(X <= k) = Q(k + 1, mean), P(X >= k) = P(k, mean)
+        double lower = regularized_gamma_q(k + 1.0, mean);
+        double upper = observed == 0 ? 1.0 : regularized_gamma_p(k, mean);
+        return std::min(1.0, 2.0 * std::min(lower, upper));
+    }
+
+} // namespace rng
@@ -0,0 +1,72 @@
+#include "../../include/utils/bits.hpp"
+#include "../../include/utils/cpu_dispatch.hpp"
+#include <stdexcept>
+
+namespace rng
+{
+
+    uint64_t popcount_words(const uint64_t *words, size_t count)
+    {
+        return kernels().popcount_words(words, count);
+    }
+
+    uint64_t count_bit_transitions(const uint64_t *words, size_t bit_count)
+    {
+        if (bit_count < 2)
+            return 0;
+
+        // Word i XOR the stream shifted down by one bit marks the pairs
+        // (64i + k, 64i + k + 1); words below `full` have all 64 pairs inside
+        // the stream, and the word after them always exists
+        const size_t full = (bit_count - 1) / 64;
+        uint64_t total = kernels().transition_words(words, full);
+
+        // Pairs inside the word holding the last bit
+        unsigned remaining = static_cast<unsigned>((bit_count - 1) & 63);
+        if (remaining != 0)
+        {
+            uint64_t word = words[full];
+            uint64_t pairs = (word ^ (word >> 1)) & ((1ULL << remaining) - 1);
+            total += static_cast<uint64_t>(__builtin_popcountll(pairs));
+        }
+        return total;
+    }
+
+    BitSequence generate_bit_sequence(RandomGenerator &generator, size_t bit_count)
+    {
+        BitSequence sequence;
+        sequence.value_bits = generator.raw_bits();
+        if (sequence.value_bits == 0 || sequence.value_bits > 64)
+        {
+            throw std::invalid_argument("Generator must provide between 1 and 64 raw bits");
+        }
+
+        sequence.bit_count = bit_count;
+        // One spare word so read_bits may always look at the next word
+        sequence.words.assign((bit_count + 63) / 64 + 1, 0);
+
+        const unsigned width = sequence.value_bits;
+        const uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+        size_t position = 0;
+        while (position < bit_count)
+        {
+            uint64_t value = generator.generate_raw() & mask;
+            size_t index = position >> 6;
+            unsigned shift = static_cast<unsigned>(position & 63);
+            sequence.words[index] |= value << shift;
+            if (shift != 0 && shift + width > 64)
+                sequence.words[index + 1] |= value >> (64 - shift);
+            position += width;
+        }
+
+        // Clear the bits past bit_count produced by the last output
+        size_t last = bit_count >> 6;
+        if ((bit_count & 63) != 0)
+            sequence.words[last] &= (1ULL << (bit_count & 63)) - 1;
+        for (size_t i = last + ((bit_count & 63) != 0 ? 1 : 0); i < sequence.words.size(); ++i)
+            sequence.words[i] = 0;
+
+        return sequence;
+    }
+
+} // namespace rng
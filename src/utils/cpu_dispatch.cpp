@@ -0,0 +1,513 @@
+#include "../../include/utils/cpu_dispatch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define RNG_X86_DISPATCH
+#include <immintrin.h>
+#define RNG_ALWAYS_INLINE inline __attribute__((always_inline))
+// No FMA in any of these: contracted multiply-adds would round differently
+// from the baseline build
+#define RNG_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define RNG_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define RNG_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx2,popcnt")))
+#else
+#define RNG_ALWAYS_INLINE inline
+#endif
+
+namespace rng
+{
+
+    namespace
+    {
+        // Portable bodies, compiled into the baseline kernels and, through
+        // forced inlining, into the SSE4.2 ones where popcount is one instruction
+
+        RNG_ALWAYS_INLINE uint64_t popcount_words_scalar(const uint64_t *words, size_t count)
+        {
+            uint64_t total = 0;
+            for (size_t i = 0; i < count; ++i)
+                total += static_cast<uint64_t>(__builtin_popcountll(words[i]));
+            return total;
+        }
+
+        RNG_ALWAYS_INLINE void popcounts_scalar(const uint64_t *values, size_t count, uint64_t mask, uint8_t *out)
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = static_cast<uint8_t>(__builtin_popcountll(values[i] & mask));
+        }
+
+        RNG_ALWAYS_INLINE uint64_t transition_words_scalar(const uint64_t *words, size_t count)
+        {
+            uint64_t total = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint64_t shifted = (words[i] >> 1) | (words[i + 1] << 63);
+                total += static_cast<uint64_t>(__builtin_popcountll(words[i] ^ shifted));
+            }
+            return total;
+        }
+
+        RNG_ALWAYS_INLINE void xor_words_scalar(uint64_t *dst, const uint64_t *src, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                dst[i] ^= src[i];
+        }
+
+        RNG_ALWAYS_INLINE uint64_t continuation_mask_scalar(const double *x, size_t length, bool up)
+        {
+            uint64_t mask = 0;
+            for (size_t i = 0; i < length; ++i)
+            {
+                bool continues = up ? x[i + 1] > x[i] : x[i] > x[i + 1];
+                mask |= static_cast<uint64_t>(continues) << i;
+            }
+            return mask;
+        }
+
+        RNG_ALWAYS_INLINE void bin_numbers_scalar(const double *numbers, size_t count, uint32_t bins, uint32_t *out)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t bin = static_cast<uint32_t>(static_cast<int32_t>(numbers[i] * bins));
+                out[i] = std::min(bin, bins - 1);
+            }
+        }
+
+        // Lane i & 3 of each sum takes pair i; the vector kernels keep the
+        // same lanes, so every level adds the same numbers in the same order
+        RNG_ALWAYS_INLINE void add_pairs_to_lanes(const double *numbers, size_t begin, size_t end, double lanes[5][4])
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                double x = numbers[i] - 0.5;
+                double y = numbers[i + 1] - 0.5;
+                size_t lane = i & 3;
+                lanes[0][lane] += x;
+                lanes[1][lane] += y;
+                lanes[2][lane] += x * x;
+                lanes[3][lane] += y * y;
+                lanes[4][lane] += x * y;
+            }
+        }
+
+        RNG_ALWAYS_INLINE void add_lanes(double lanes[5][4], double *sums)
+        {
+            for (int k = 0; k < 5; ++k)
+                sums[k] += (lanes[k][0] + lanes[k][1]) + (lanes[k][2] + lanes[k][3]);
+        }
+
+        uint64_t popcount_words_baseline(const uint64_t *words, size_t count)
+        {
+            return popcount_words_scalar(words, count);
+        }
+
+        void popcounts_baseline(const uint64_t *values, size_t count, uint64_t mask, uint8_t *out)
+        {
+            popcounts_scalar(values, count, mask, out);
+        }
+
+        uint64_t transition_words_baseline(const uint64_t *words, size_t count)
+        {
+            return transition_words_scalar(words, count);
+        }
+
+        void xor_words_baseline(uint64_t *dst, const uint64_t *src, size_t count)
+        {
+            xor_words_scalar(dst, src, count);
+        }
+
+        uint64_t continuation_mask_baseline(const double *x, size_t length, bool up)
+        {
+            return continuation_mask_scalar(x, length, up);
+        }
+
+        void bin_numbers_baseline(const double *numbers, size_t count, uint32_t bins, uint32_t *out)
+        {
+            bin_numbers_scalar(numbers, count, bins, out);
+        }
+
+        void pair_sums_baseline(const double *numbers, size_t count, double *sums)
+        {
+            double lanes[5][4] = {};
+            if (count > 1)
+                add_pairs_to_lanes(numbers, 0, count - 1, lanes);
+            add_lanes(lanes, sums);
+        }
+
+        const KernelTable BASELINE_KERNELS = {
+            CpuLevel::Baseline,
+            popcount_words_baseline,
+            popcounts_baseline,
+            transition_words_baseline,
+            xor_words_baseline,
+            continuation_mask_baseline,
+            bin_numbers_baseline,
+            pair_sums_baseline};
+
+#ifdef RNG_X86_DISPATCH
+        RNG_TARGET_SSE42 uint64_t popcount_words_sse42(const uint64_t *words, size_t count)
+        {
+            return popcount_words_scalar(words, count);
+        }
+
+        RNG_TARGET_SSE42 void popcounts_sse42(const uint64_t *values, size_t count, uint64_t mask, uint8_t *out)
+        {
+            popcounts_scalar(values, count, mask, out);
+        }
+
+        RNG_TARGET_SSE42 uint64_t transition_words_sse42(const uint64_t *words, size_t count)
+        {
+            return transition_words_scalar(words, count);
+        }
+
+        const KernelTable SSE42_KERNELS = {
+            CpuLevel::Sse42,
+            popcount_words_sse42,
+            popcounts_sse42,
+            transition_words_sse42,
+            xor_words_baseline,
+            continuation_mask_baseline,
+            bin_numbers_baseline,
+            pair_sums_baseline};
+
+        // Per-64-bit-lane popcounts of a vector, by nibble lookup (Mula)
+        RNG_TARGET_AVX2 inline __m256i popcount_lanes_avx2(__m256i v)
+        {
+            const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                   0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i low_mask = _mm256_set1_epi8(0x0f);
+            __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low_mask));
+            __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+            return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+        }
+
+        RNG_TARGET_AVX2 inline uint64_t sum_lanes_avx2(__m256i v)
+        {
+            return static_cast<uint64_t>(_mm256_extract_epi64(v, 0)) + static_cast<uint64_t>(_mm256_extract_epi64(v, 1)) +
+                   static_cast<uint64_t>(_mm256_extract_epi64(v, 2)) + static_cast<uint64_t>(_mm256_extract_epi64(v, 3));
+        }
+
+        RNG_TARGET_AVX2 uint64_t popcount_words_avx2(const uint64_t *words, size_t count)
+        {
+            __m256i sums = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+                sums = _mm256_add_epi64(sums, popcount_lanes_avx2(v));
+            }
+            return sum_lanes_avx2(sums) + popcount_words_scalar(words + i, count - i);
+        }
+
+        RNG_TARGET_AVX2 uint64_t transition_words_avx2(const uint64_t *words, size_t count)
+        {
+            __m256i sums = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+                __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i + 1));
+                __m256i shifted = _mm256_or_si256(_mm256_srli_epi64(v, 1), _mm256_slli_epi64(next, 63));
+                sums = _mm256_add_epi64(sums, popcount_lanes_avx2(_mm256_xor_si256(v, shifted)));
+            }
+            return sum_lanes_avx2(sums) + transition_words_scalar(words + i, count - i);
+        }
+
+        RNG_TARGET_AVX2 void xor_words_avx2(uint64_t *dst, const uint64_t *src, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_xor_si256(a, b));
+            }
+            xor_words_scalar(dst + i, src + i, count - i);
+        }
+
+        RNG_TARGET_AVX2 uint64_t continuation_mask_avx2(const double *x, size_t length, bool up)
+        {
+            uint64_t mask = 0;
+            size_t i = 0;
+            for (; i + 4 <= length; i += 4)
+            {
+                __m256d current = _mm256_loadu_pd(x + i);
+                __m256d next = _mm256_loadu_pd(x + i + 1);
+                __m256d continues = up ? _mm256_cmp_pd(next, current, _CMP_GT_OQ)
+                                       : _mm256_cmp_pd(current, next, _CMP_GT_OQ);
+                mask |= static_cast<uint64_t>(_mm256_movemask_pd(continues)) << i;
+            }
+            if (i < length)
+                mask |= continuation_mask_scalar(x + i, length - i, up) << i;
+            return mask;
+        }
+
+        RNG_TARGET_AVX2 void bin_numbers_avx2(const double *numbers, size_t count, uint32_t bins, uint32_t *out)
+        {
+            const __m256d scale = _mm256_set1_pd(static_cast<double>(bins));
+            const __m128i last = _mm_set1_epi32(static_cast<int>(bins - 1));
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i bin = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_loadu_pd(numbers + i), scale));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_min_epu32(bin, last));
+            }
+            bin_numbers_scalar(numbers + i, count - i, bins, out + i);
+        }
+
+        RNG_TARGET_AVX2 void pair_sums_avx2(const double *numbers, size_t count, double *sums)
+        {
+            double lanes[5][4] = {};
+            const size_t pairs = count > 1 ? count - 1 : 0;
+            const __m256d half = _mm256_set1_pd(0.5);
+            __m256d sx = _mm256_setzero_pd(), sy = _mm256_setzero_pd(), sxx = _mm256_setzero_pd(),
+                    syy = _mm256_setzero_pd(), sxy = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= pairs; i += 4)
+            {
+                __m256d x = _mm256_sub_pd(_mm256_loadu_pd(numbers + i), half);
+                __m256d y = _mm256_sub_pd(_mm256_loadu_pd(numbers + i + 1), half);
+                sx = _mm256_add_pd(sx, x);
+                sy = _mm256_add_pd(sy, y);
+                sxx = _mm256_add_pd(sxx, _mm256_mul_pd(x, x));
+                syy = _mm256_add_pd(syy, _mm256_mul_pd(y, y));
+                sxy = _mm256_add_pd(sxy, _mm256_mul_pd(x, y));
+            }
+            _mm256_storeu_pd(lanes[0], sx);
+            _mm256_storeu_pd(lanes[1], sy);
+            _mm256_storeu_pd(lanes[2], sxx);
+            _mm256_storeu_pd(lanes[3], syy);
+            _mm256_storeu_pd(lanes[4], sxy);
+            add_pairs_to_lanes(numbers, i, pairs, lanes);
+            add_lanes(lanes, sums);
+        }
+
+        // Single values are popcounted faster by POPCNT than by unpacking vectors
+        const KernelTable AVX2_KERNELS = {
+            CpuLevel::Avx2,
+            popcount_words_avx2,
+            popcounts_sse42,
+            transition_words_avx2,
+            xor_words_avx2,
+            continuation_mask_avx2,
+            bin_numbers_avx2,
+            pair_sums_avx2};
+
+        RNG_TARGET_AVX512 inline __m512i popcount_lanes_avx512(__m512i v)
+        {
+            const __m512i table = _mm512_maskz_broadcast_i32x4(0xffff, _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+            const __m512i low_mask = _mm512_set1_epi8(0x0f);
+            __m512i low = _mm512_shuffle_epi8(table, _mm512_and_si512(v, low_mask));
+            __m512i high = _mm512_shuffle_epi8(table, _mm512_and_si512(_mm512_srli_epi16(v, 4), low_mask));
+            return _mm512_sad_epu8(_mm512_add_epi8(low, high), _mm512_setzero_si512());
+        }
+
+        // GCC 12 builds several AVX-512 intrinsics (_mm512_reduce_add_epi64,
+        // the extracts, the shifts by an immediate, broadcast_i32x4,
+        // cvttpd_epi32) on an _mm512_undefined_* value and warns that it is
+        // used uninitialized. The kernels below use a store or the maskz
+        // forms with a full mask instead, which compile to the same
+        // instructions.
+        RNG_TARGET_AVX512 inline uint64_t sum_lanes_avx512(__m512i v)
+        {
+            alignas(64) uint64_t lanes[8];
+            _mm512_store_si512(lanes, v);
+            return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+        }
+
+        RNG_TARGET_AVX512 uint64_t popcount_words_avx512(const uint64_t *words, size_t count)
+        {
+            __m512i sums = _mm512_setzero_si512();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+                sums = _mm512_add_epi64(sums, popcount_lanes_avx512(_mm512_loadu_si512(words + i)));
+            return sum_lanes_avx512(sums) + popcount_words_scalar(words + i, count - i);
+        }
+
+        RNG_TARGET_AVX512 uint64_t transition_words_avx512(const uint64_t *words, size_t count)
+        {
+            __m512i sums = _mm512_setzero_si512();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m512i v = _mm512_loadu_si512(words + i);
+                __m512i next = _mm512_loadu_si512(words + i + 1);
+                __m512i shifted = _mm512_or_si512(_mm512_maskz_srli_epi64(0xff, v, 1), _mm512_maskz_slli_epi64(0xff, next, 63));
+                sums = _mm512_add_epi64(sums, popcount_lanes_avx512(_mm512_xor_si512(v, shifted)));
+            }
+            return sum_lanes_avx512(sums) + transition_words_scalar(words + i, count - i);
+        }
+
+        RNG_TARGET_AVX512 void xor_words_avx512(uint64_t *dst, const uint64_t *src, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m512i a = _mm512_loadu_si512(dst + i);
+                __m512i b = _mm512_loadu_si512(src + i);
+                _mm512_storeu_si512(dst + i, _mm512_xor_si512(a, b));
+            }
+            xor_words_scalar(dst + i, src + i, count - i);
+        }
+
+        RNG_TARGET_AVX512 uint64_t continuation_mask_avx512(const double *x, size_t length, bool up)
+        {
+            uint64_t mask = 0;
+            size_t i = 0;
+            for (; i + 8 <= length; i += 8)
+            {
+                __m512d current = _mm512_loadu_pd(x + i);
+                __m512d next = _mm512_loadu_pd(x + i + 1);
+                __mmask8 continues = up ? _mm512_cmp_pd_mask(next, current, _CMP_GT_OQ)
+                                        : _mm512_cmp_pd_mask(current, next, _CMP_GT_OQ);
+                mask |= static_cast<uint64_t>(continues) << i;
+            }
+            if (i < length)
+                mask |= continuation_mask_scalar(x + i, length - i, up) << i;
+            return mask;
+        }
+
+        RNG_TARGET_AVX512 void bin_numbers_avx512(const double *numbers, size_t count, uint32_t bins, uint32_t *out)
+        {
+            const __m512d scale = _mm512_set1_pd(static_cast<double>(bins));
+            const __m256i last = _mm256_set1_epi32(static_cast<int>(bins - 1));
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i bin = _mm512_maskz_cvttpd_epi32(0xff, _mm512_mul_pd(_mm512_loadu_pd(numbers + i), scale));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_min_epu32(bin, last));
+            }
+            bin_numbers_scalar(numbers + i, count - i, bins, out + i);
+        }
+
+        // The pair sums keep their AVX2 form: eight lanes would add the sums
+        // in a different order
+        const KernelTable AVX512_KERNELS = {
+            CpuLevel::Avx512,
+            popcount_words_avx512,
+            popcounts_sse42,
+            transition_words_avx512,
+            xor_words_avx512,
+            continuation_mask_avx512,
+            bin_numbers_avx512,
+            pair_sums_avx2};
+#endif
+
+        const KernelTable &table_for(CpuLevel level)
+        {
+            switch (level)
+            {
+#ifdef RNG_X86_DISPATCH
+            case CpuLevel::Avx512:
+                return AVX512_KERNELS;
+            case CpuLevel::Avx2:
+                return AVX2_KERNELS;
+            case CpuLevel::Sse42:
+                return SSE42_KERNELS;
+#endif
+            default:
+                return BASELINE_KERNELS;
+            }
+        }
+
+        CpuLevel initial_level()
+        {
+            CpuLevel level = detected_cpu_level();
+            if (const char *name = std::getenv("RNG_CPU_LEVEL"))
+            {
+                try
+                {
+                    level = std::min(level, parse_cpu_level(name));
+                }
+                catch (const std::invalid_argument &)
+                {
+                    // An unknown name keeps the detected level
+                }
+            }
+            return level;
+        }
+
+        std::atomic<const KernelTable *> selected_kernels{nullptr};
+    } // namespace
+
+    const KernelTable &kernels()
+    {
+        const KernelTable *table = selected_kernels.load(std::memory_order_acquire);
+        if (table != nullptr)
+            return *table;
+
+        const KernelTable *initial = &table_for(initial_level());
+        // Another thread may have selected first; its choice stands
+        if (selected_kernels.compare_exchange_strong(table, initial, std::memory_order_acq_rel))
+            return *initial;
+        return *table;
+    }
+
+    CpuLevel detected_cpu_level()
+    {
+#ifdef RNG_X86_DISPATCH
+        static const CpuLevel level = []
+        {
+            // These also check that the operating system saves the wide registers
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("popcnt"))
+                return CpuLevel::Baseline;
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx2"))
+                return CpuLevel::Avx512;
+            if (__builtin_cpu_supports("avx2"))
+                return CpuLevel::Avx2;
+            if (__builtin_cpu_supports("sse4.2"))
+                return CpuLevel::Sse42;
+            return CpuLevel::Baseline;
+        }();
+        return level;
+#else
+        return CpuLevel::Baseline;
+#endif
+    }
+
+    CpuLevel selected_cpu_level()
+    {
+        return kernels().level;
+    }
+
+    void select_cpu_level(CpuLevel level)
+    {
+        if (level > detected_cpu_level())
+        {
+            throw std::invalid_argument("This CPU cannot run the " + cpu_level_name(level) + " kernels (it supports up to " +
+                                        cpu_level_name(detected_cpu_level()) + ")");
+        }
+        selected_kernels.store(&table_for(level), std::memory_order_release);
+    }
+
+    std::string cpu_level_name(CpuLevel level)
+    {
+        switch (level)
+        {
+        case CpuLevel::Sse42:
+            return "sse4.2";
+        case CpuLevel::Avx2:
+            return "avx2";
+        case CpuLevel::Avx512:
+            return "avx512";
+        default:
+            return "baseline";
+        }
+    }
+
+    CpuLevel parse_cpu_level(const std::string &name)
+    {
+        for (CpuLevel level : {CpuLevel::Baseline, CpuLevel::Sse42, CpuLevel::Avx2, CpuLevel::Avx512})
+        {
+            if (name == cpu_level_name(level))
+                return level;
+        }
+        throw std::invalid_argument("Unknown CPU level '" + name + "' (expected baseline, sse4.2, avx2 or avx512)");
+    }
+
+} // namespace rng
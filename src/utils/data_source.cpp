@@ -0,0 +1,146 @@
+#include "../../include/utils/data_source.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rng
+{
+
+    VectorSource::VectorSource(const std::vector<double> &numbers)
+        : numbers_(numbers), position_(0) {}
+
+    size_t VectorSource::read(double *buffer, size_t capacity)
+    {
+        size_t count = std::min(capacity, numbers_.size() - position_);
+        std::copy(numbers_.begin() + position_, numbers_.begin() + position_ + count, buffer);
+        position_ += count;
+        return count;
+    }
+
+    size_t VectorSource::size_hint() const
+    {
+        return numbers_.size();
+    }
+
+    GeneratorSource::GeneratorSource(RandomGenerator &generator, size_t count)
+        : generator_(generator), remaining_(count), count_(count) {}
+
+    size_t GeneratorSource::read(double *buffer, size_t capacity)
+    {
+        size_t count = std::min(capacity, remaining_);
+        for (size_t i = 0; i < count; ++i)
+        {
+            buffer[i] = generator_.generate();
+        }
+        remaining_ -= count;
+        return count;
+    }
+
+    size_t GeneratorSource::size_hint() const
+    {
+        return count_;
+    }
+
+#ifndef _WIN32
+    MappedFileSource::MappedFileSource(const std::string &path)
+        : data_(nullptr), count_(0), position_(0), mapped_bytes_(0)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open " + path);
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+
+        mapped_bytes_ = static_cast<size_t>(info.st_size);
+        count_ = mapped_bytes_ / sizeof(double);
+        if (mapped_bytes_ > 0)
+        {
+            void *address = ::mmap(nullptr, mapped_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            ::madvise(address, mapped_bytes_, MADV_SEQUENTIAL);
+            data_ = static_cast<const double *>(address);
+        }
+        ::close(fd);
+    }
+
+    MappedFileSource::~MappedFileSource()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<double *>(data_), mapped_bytes_);
+        }
+    }
+#else
+    // Without mmap the file is loaded once into memory
+    MappedFileSource::MappedFileSource(const std::string &path)
+        : data_(nullptr), count_(0), position_(0), mapped_bytes_(0)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        mapped_bytes_ = static_cast<size_t>(file.tellg());
+        count_ = mapped_bytes_ / sizeof(double);
+        double *data = new double[count_];
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(data), count_ * sizeof(double));
+        data_ = data;
+    }
+
+    MappedFileSource::~MappedFileSource()
+    {
+        delete[] data_;
+    }
+#endif
+
+    size_t MappedFileSource::read(double *buffer, size_t capacity)
+    {
+        size_t count = std::min(capacity, count_ - position_);
+        std::copy(data_ + position_, data_ + position_ + count, buffer);
+        position_ += count;
+        return count;
+    }
+
+    size_t MappedFileSource::size_hint() const
+    {
+        return count_;
+    }
+
+    StreamSource::StreamSource(std::istream &input, bool binary)
+        : input_(input), binary_(binary) {}
+
+    size_t StreamSource::read(double *buffer, size_t capacity)
+    {
+        if (binary_)
+        {
+            input_.read(reinterpret_cast<char *>(buffer), capacity * sizeof(double));
+            return static_cast<size_t>(input_.gcount()) / sizeof(double);
+        }
+
+        size_t count = 0;
+        while (count < capacity && input_ >> buffer[count])
+        {
+            ++count;
+        }
+        return count;
+    }
+
+} // namespace rng
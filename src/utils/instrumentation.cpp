@@ -0,0 +1,155 @@
+#include "../../include/utils/instrumentation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace rng
+{
+
+    namespace
+    {
+        // Counters of one thread. Only the owner writes them, with plain
+        // load/store pairs; readers may see a slightly stale value.
+        struct alignas(64) ThreadBlock
+        {
+            std::atomic<uint64_t> calls[MAX_PROBES] = {};
+            std::atomic<uint64_t> nanoseconds[MAX_PROBES] = {};
+            std::atomic<uint64_t> items[MAX_PROBES] = {};
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::map<std::string, ProbeId> ids;
+            std::vector<std::string> names;
+            std::vector<ThreadBlock *> live;
+            // Totals of exited threads
+            uint64_t calls[MAX_PROBES] = {};
+            uint64_t nanoseconds[MAX_PROBES] = {};
+            uint64_t items[MAX_PROBES] = {};
+            uint64_t threads[MAX_PROBES] = {};
+        };
+
+        // Never destroyed, so threads exiting during shutdown can still fold in
+        Registry &registry()
+        {
+            static Registry *instance = new Registry();
+            return *instance;
+        }
+
+        void add(std::atomic<uint64_t> &counter, uint64_t amount)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        class ThreadBlockOwner
+        {
+        public:
+            ThreadBlockOwner() : block_(std::make_unique<ThreadBlock>())
+            {
+                Registry &r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.live.push_back(block_.get());
+            }
+
+            ~ThreadBlockOwner()
+            {
+                Registry &r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                for (size_t p = 0; p < MAX_PROBES; ++p)
+                {
+                    uint64_t calls = block_->calls[p].load(std::memory_order_relaxed);
+                    r.calls[p] += calls;
+                    r.nanoseconds[p] += block_->nanoseconds[p].load(std::memory_order_relaxed);
+                    r.items[p] += block_->items[p].load(std::memory_order_relaxed);
+                    r.threads[p] += calls > 0 ? 1 : 0;
+                }
+                r.live.erase(std::find(r.live.begin(), r.live.end(), block_.get()));
+            }
+
+            ThreadBlock &block() { return *block_; }
+
+        private:
+            std::unique_ptr<ThreadBlock> block_;
+        };
+
+        ThreadBlock &this_thread_block()
+        {
+            thread_local ThreadBlockOwner owner;
+            return owner.block();
+        }
+    } // namespace
+
+    ProbeId register_probe(const std::string &name)
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto found = r.ids.find(name);
+        if (found != r.ids.end())
+            return found->second;
+        if (r.names.size() == MAX_PROBES)
+        {
+            throw std::runtime_error("Too many instrumentation probes, cannot add " + name);
+        }
+        ProbeId id = static_cast<ProbeId>(r.names.size());
+        r.names.push_back(name);
+        r.ids.emplace(name, id);
+        return id;
+    }
+
+    void record_probe(ProbeId probe, uint64_t nanoseconds, uint64_t items)
+    {
+        ThreadBlock &block = this_thread_block();
+        add(block.calls[probe], 1);
+        add(block.nanoseconds[probe], nanoseconds);
+        add(block.items[probe], items);
+    }
+
+    std::vector<ProbeTotals> instrumentation_snapshot()
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::vector<ProbeTotals> totals(r.names.size());
+        for (size_t p = 0; p < totals.size(); ++p)
+        {
+            ProbeTotals &t = totals[p];
+            t.name = r.names[p];
+            t.calls = r.calls[p];
+            t.nanoseconds = r.nanoseconds[p];
+            t.items = r.items[p];
+            t.threads = r.threads[p];
+            for (const ThreadBlock *block : r.live)
+            {
+                uint64_t calls = block->calls[p].load(std::memory_order_relaxed);
+                t.calls += calls;
+                t.nanoseconds += block->nanoseconds[p].load(std::memory_order_relaxed);
+                t.items += block->items[p].load(std::memory_order_relaxed);
+                t.threads += calls > 0 ? 1 : 0;
+            }
+        }
+        return totals;
+    }
+
+    void reset_instrumentation()
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::fill(std::begin(r.calls), std::end(r.calls), 0);
+        std::fill(std::begin(r.nanoseconds), std::end(r.nanoseconds), 0);
+        std::fill(std::begin(r.items), std::end(r.items), 0);
+        std::fill(std::begin(r.threads), std::end(r.threads), 0);
+        for (ThreadBlock *block : r.live)
+        {
+            for (size_t p = 0; p < MAX_PROBES; ++p)
+            {
+                block->calls[p].store(0, std::memory_order_relaxed);
+                block->nanoseconds[p].store(0, std::memory_order_relaxed);
+                block->items[p].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+} // namespace rng
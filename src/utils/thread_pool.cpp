@@ -0,0 +1,141 @@
+#include "../../include/utils/thread_pool.hpp"
+#include "../../include/utils/parallel.hpp"
+
+namespace rng
+{
+
+    namespace
+    {
+        // Pool and worker index of the current thread, if it is a pool worker
+        thread_local const WorkStealingPool *current_pool = nullptr;
+        thread_local size_t current_worker = 0;
+    } // namespace
+
+    WorkStealingPool::WorkStealingPool(size_t num_threads)
+        : queued_(0), pending_(0), next_queue_(0), stopping_(false)
+    {
+        size_t count = num_threads == 0 ? default_thread_count() : num_threads;
+        for (size_t i = 0; i < count; ++i)
+        {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            threads_.emplace_back(&WorkStealingPool::worker_loop, this, i);
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            stopping_ = true;
+        }
+        work_available_.notify_all();
+        for (auto &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    size_t WorkStealingPool::size() const
+    {
+        return threads_.size();
+    }
+
+    void WorkStealingPool::submit(Task task)
+    {
+        size_t target;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            ++pending_;
+            ++queued_; // counted before the push so it never drops below zero
+            target = current_pool == this ? current_worker : next_queue_++ % queues_.size();
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+        work_available_.notify_one();
+    }
+
+    void WorkStealingPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        all_done_.wait(lock, [this]
+                       { return pending_ == 0; });
+        if (error_)
+        {
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    bool WorkStealingPool::try_pop(size_t worker, Task &task)
+    {
+        // Own deque: newest first (still warm in cache)
+        {
+            Queue &own = *queues_[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                --queued_;
+                return true;
+            }
+        }
+        // Steal the oldest task of another worker
+        for (size_t offset = 1; offset < queues_.size(); ++offset)
+        {
+            Queue &victim = *queues_[(worker + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                --queued_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkStealingPool::worker_loop(size_t index)
+    {
+        current_pool = this;
+        current_worker = index;
+
+        while (true)
+        {
+            Task task;
+            if (try_pop(index, task))
+            {
+                std::exception_ptr error;
+                try
+                {
+                    task(index);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                if (error && !error_)
+                    error_ = error;
+                if (--pending_ == 0)
+                    all_done_.notify_all();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(state_mutex_);
+            work_available_.wait(lock, [this]
+                                 { return stopping_ || queued_ > 0; });
+            if (stopping_ && queued_ == 0)
+                return;
+        }
+    }
+
+} // namespace rng
@@ -0,0 +1,228 @@
+/*
+ * The C interface exercised from C: creation by kind, fills, state round
+ * trips, splitting, merging of test accumulators and the error paths with
+ * their rng_last_error() messages.
+ */
+
+#include "../include/capi/rng_c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COUNT 100000
+#define STRIDE 1000
+#define STREAMS 4
+
+static int failures = 0;
+
+static void check(int condition, const char *name)
+{
+    printf("%s %s\n", condition ? "PASS" : "FAIL", name);
+    if (!condition)
+        failures++;
+}
+
+static int same_doubles(const double *a, const double *b, size_t count)
+{
+    return memcmp(a, b, count * sizeof(double)) == 0;
+}
+
+static void test_kinds(void)
+{
+    size_t i;
+    int found = 0;
+    check(rng_abi_version() == RNG_C_ABI_VERSION, "abi version");
+    check(rng_generator_kind_count() > 0 && rng_test_kind_count() > 0, "kinds listed");
+    check(rng_generator_kind_name(rng_generator_kind_count()) == NULL, "generator kind past the end");
+    check(rng_test_kind_name(rng_test_kind_count()) == NULL, "test kind past the end");
+    for (i = 0; i < rng_generator_kind_count(); ++i)
+        found |= strcmp(rng_generator_kind_name(i), "mrg32k3a") == 0;
+    check(found, "mrg32k3a listed");
+
+    /* Every listed kind can be created */
+    for (i = 0; i < rng_generator_kind_count(); ++i)
+    {
+        rng_generator *generator = NULL;
+        if (rng_generator_create(rng_generator_kind_name(i), 7, &generator) != RNG_OK)
+        {
+            check(0, rng_generator_kind_name(i));
+            continue;
+        }
+        rng_generator_destroy(generator);
+    }
+    for (i = 0; i < rng_test_kind_count(); ++i)
+    {
+        rng_test *test = NULL;
+        if (rng_test_create(rng_test_kind_name(i), &test) != RNG_OK)
+        {
+            check(0, rng_test_kind_name(i));
+            continue;
+        }
+        rng_test_destroy(test);
+    }
+}
+
+static void test_generator(double *numbers, double *again)
+{
+    rng_generator *generator = NULL;
+    rng_generator *copy = NULL;
+    uint64_t state[16];
+    size_t words = 0;
+    size_t i;
+    int in_range = 1;
+
+    check(rng_generator_create("mrg32k3a", 12345, &generator) == RNG_OK, "create mrg32k3a");
+    check(rng_generator_fill(generator, numbers, COUNT) == RNG_OK, "fill");
+    for (i = 0; i < COUNT; ++i)
+        in_range &= numbers[i] >= 0.0 && numbers[i] < 1.0;
+    check(in_range, "fill in [0, 1)");
+
+    /* Seeding again repeats the sequence */
+    check(rng_generator_seed(generator, 12345) == RNG_OK, "seed");
+    rng_generator_fill(generator, again, COUNT);
+    check(same_doubles(numbers, again, COUNT), "seed repeats");
+
+    /* State round trip: size query, save, draw, restore, draw again */
+    check(rng_generator_get_state(generator, NULL, 0, &words) == RNG_OK && words > 0 && words <= 16,
+          "state size query");
+    check(rng_generator_get_state(generator, state, 16, &words) == RNG_OK, "get state");
+    rng_generator_clone(generator, &copy);
+    rng_generator_fill(generator, numbers, COUNT);
+    check(rng_generator_set_state(generator, state, words) == RNG_OK, "set state");
+    rng_generator_fill(generator, again, COUNT);
+    check(same_doubles(numbers, again, COUNT), "state round trip");
+    rng_generator_fill(copy, again, COUNT);
+    check(same_doubles(numbers, again, COUNT), "clone");
+
+    rng_generator_destroy(copy);
+    rng_generator_destroy(generator);
+}
+
+static void test_split(void)
+{
+    rng_generator *parent = NULL;
+    rng_generator *reference = NULL;
+    rng_generator *children[STREAMS];
+    uint64_t expected[STRIDE];
+    uint64_t actual[STRIDE];
+    size_t i;
+    int same = 1;
+
+    rng_generator_create("mcg", 99, &parent);
+    rng_generator_clone(parent, &reference);
+    check(rng_generator_supports_jump(parent) == 1, "mcg jumps");
+    check(rng_generator_split(parent, STRIDE, STREAMS, children) == RNG_OK, "split");
+
+    /* Child i continues where stepping i * STRIDE outputs would be */
+    for (i = 0; i < STREAMS; ++i)
+    {
+        rng_generator_fill_raw(reference, expected, STRIDE);
+        rng_generator_fill_raw(children[i], actual, STRIDE);
+        same &= memcmp(expected, actual, sizeof(expected)) == 0;
+        rng_generator_destroy(children[i]);
+    }
+    check(same, "split streams are consecutive blocks");
+
+    /* And the parent skipped past all of them */
+    rng_generator_fill_raw(reference, expected, STRIDE);
+    rng_generator_fill_raw(parent, actual, STRIDE);
+    check(memcmp(expected, actual, sizeof(expected)) == 0, "split advances the parent");
+
+    rng_generator_destroy(reference);
+    rng_generator_destroy(parent);
+}
+
+static void test_merge(const double *numbers)
+{
+    rng_test *whole = NULL;
+    rng_test *left = NULL;
+    rng_test *right = NULL;
+    rng_test *restored = NULL;
+    double whole_p = 0.0;
+    double merged_p = 0.0;
+    int passed = -1;
+    size_t size = 0;
+    char *buffer;
+
+    check(rng_test_create("poker", &whole) == RNG_OK, "create poker");
+    rng_test_update(whole, numbers, COUNT);
+    check(rng_test_evaluate(whole, 0.01, &whole_p, &passed) == RNG_OK && (passed == 0 || passed == 1),
+          "evaluate");
+    check(strlen(rng_test_result(whole)) > 0, "result text");
+
+    /* The right part goes through save/load before the merge */
+    rng_test_clone_empty(whole, &left);
+    rng_test_clone_empty(whole, &right);
+    rng_test_update(left, numbers, 12345);
+    rng_test_update(right, numbers + 12345, COUNT - 12345);
+    check(rng_test_save_state(right, NULL, 0, &size) == RNG_OK && size > 0, "state size query");
+    buffer = malloc(size);
+    check(rng_test_save_state(right, buffer, size, &size) == RNG_OK, "save test state");
+    rng_test_create("poker", &restored);
+    check(rng_test_load_state(restored, buffer, size) == RNG_OK, "load test state");
+    free(buffer);
+
+    check(rng_test_merge(left, restored) == RNG_OK, "merge");
+    rng_test_evaluate(left, 0.01, &merged_p, NULL);
+    check(merged_p == whole_p, "merged parts match a single pass");
+
+    rng_test_destroy(restored);
+    rng_test_destroy(right);
+    rng_test_destroy(left);
+    rng_test_destroy(whole);
+}
+
+static void test_errors(void)
+{
+    rng_generator *generator = NULL;
+    rng_test *poker = NULL;
+    rng_test *gap = NULL;
+    uint64_t state[1];
+    size_t words = 0;
+
+    check(rng_generator_create("Multiplicative Congruential Generator", 1, &generator) ==
+                  RNG_ERROR_INVALID_ARGUMENT &&
+              generator == NULL,
+          "display names are not kinds");
+    check(strstr(rng_last_error(), "Unknown generator kind") != NULL, "unknown kind message");
+    check(rng_test_create("no-such-test", &poker) == RNG_ERROR_INVALID_ARGUMENT, "unknown test kind");
+    check(rng_generator_create(NULL, 1, &generator) == RNG_ERROR_INVALID_ARGUMENT, "null kind");
+    check(strcmp(rng_last_error(), "Null argument") == 0, "null argument message");
+
+    rng_generator_create("mrg32k3a", 1, &generator);
+    check(rng_generator_get_state(generator, state, 1, &words) == RNG_ERROR_INVALID_ARGUMENT && words > 1,
+          "state buffer too small");
+    check(rng_generator_set_state(generator, state, 1) == RNG_ERROR_INVALID_ARGUMENT, "wrong state size");
+    check(rng_generator_split(generator, 0, 1, NULL) == RNG_ERROR_INVALID_ARGUMENT, "zero stride");
+    rng_generator_destroy(generator);
+
+    rng_test_create("poker", &poker);
+    rng_test_create("gap", &gap);
+    check(rng_test_merge(poker, gap) == RNG_ERROR_INVALID_ARGUMENT, "merge of different kinds");
+    check(rng_test_evaluate(poker, 0.0, NULL, NULL) == RNG_ERROR_INVALID_ARGUMENT, "significance level");
+    check(rng_test_load_state(poker, "x", 1) != RNG_OK && strlen(rng_last_error()) > 0, "bad test state");
+    rng_test_destroy(gap);
+    rng_test_destroy(poker);
+
+    /* Destroying null handles is a no-op */
+    rng_generator_destroy(NULL);
+    rng_test_destroy(NULL);
+}
+
+int main(void)
+{
+    double *numbers = malloc(COUNT * sizeof(double));
+    double *again = malloc(COUNT * sizeof(double));
+    if (numbers == NULL || again == NULL)
+        return 1;
+
+    test_kinds();
+    test_generator(numbers, again);
+    test_split();
+    test_merge(numbers);
+    test_errors();
+
+    free(again);
+    free(numbers);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include "../include/engine/checkpoint.hpp"
+#include "../include/generators/combined.hpp"
+#include "../include/tests/knuth_tests.hpp"
+#include "../include/tests/randomness_tests.hpp"
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// A run resumed from its last checkpoint must reach the p-values of an
+// uninterrupted run, and a checkpoint must be refused when the generator
+// parameters or seed, a test configuration or the thread count changed, or
+// when the file carries bytes after the checkpoint.
+
+namespace
+{
+    constexpr uint64_t TOTAL = 1 << 20;
+    const std::string PATH = "checkpoint_tests.ckpt";
+
+    struct Run
+    {
+        rng::CheckpointedRunResult result;
+        std::vector<double> p_values;
+    };
+
+    Run run(uint64_t seed, size_t threads, size_t poker_digits, bool keep_file)
+    {
+        rng::MRG32k3a generator = rng::make_mrg32k3a(seed);
+        rng::ChiSquareTest chi_square(64);
+        rng::PokerTest poker(poker_digits, 5);
+        rng::SerialCorrelationTest correlation;
+        std::vector<rng::StreamingTest *> tests = {&chi_square, &poker, &correlation};
+
+        rng::CheckpointOptions options;
+        options.path = PATH;
+        options.total_numbers = TOTAL;
+        options.interval = TOTAL / 3;
+        options.num_threads = threads;
+        options.remove_when_done = !keep_file;
+
+        Run outcome;
+        outcome.result = rng::run_checkpointed(generator, tests, options, 0.01);
+        for (rng::StreamingTest *test : tests)
+            outcome.p_values.push_back(test->get_p_value());
+        return outcome;
+    }
+
+    template <typename Exception>
+    bool refused(const std::string &name, const std::function<void()> &action)
+    {
+        bool pass = false;
+        try
+        {
+            action();
+        }
+        catch (const Exception &)
+        {
+            pass = true;
+        }
+        std::cout << (pass ? "PASS " : "FAIL ") << name << "\n";
+        return pass;
+    }
+} // namespace
+
+int main()
+{
+    std::remove(PATH.c_str());
+    bool pass = true;
+
+    // Keeping the file leaves the last checkpoint behind, as if the run had
+    // been killed after writing it
+    Run whole = run(7, 2, 10, true);
+    Run resumed = run(7, 2, 10, true);
+    bool same = resumed.result.resumed && resumed.result.resumed_at == TOTAL / 3 * 3 &&
+                resumed.p_values == whole.p_values && resumed.result.verdicts == whole.result.verdicts;
+    std::cout << (same ? "PASS " : "FAIL ") << "resumed run matches\n";
+    pass &= same;
+
+    pass &= refused<std::invalid_argument>("other seed", []
+                                           { run(8, 2, 10, true); });
+    pass &= refused<std::invalid_argument>("other thread count", []
+                                           { run(7, 3, 10, true); });
+    pass &= refused<std::invalid_argument>("other test configuration", []
+                                           { run(7, 2, 8, true); });
+
+    {
+        std::ofstream file(PATH, std::ios::binary | std::ios::app);
+        file << "x";
+    }
+    pass &= refused<std::runtime_error>("trailing bytes", []
+                                        { run(7, 2, 10, true); });
+
+    std::remove(PATH.c_str());
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#include "../include/utils/cpu_dispatch.hpp"
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Every kernel level this CPU can run must give bit-for-bit the results of
+// the baseline kernels on the same input, floating-point sums included.
+// Lengths cover empty input, vector tails and several full vectors.
+
+namespace
+{
+    const size_t LENGTHS[] = {0, 1, 2, 3, 7, 8, 15, 31, 63, 64, 65, 100, 1000, 4099};
+
+    // Everything the kernels of one level produce, in a comparable form
+    struct Outputs
+    {
+        std::vector<uint64_t> integers;
+        std::vector<uint8_t> bytes;
+        std::vector<uint32_t> bins;
+        std::vector<double> sums;
+    };
+
+    Outputs run_all(const std::vector<uint64_t> &words, const std::vector<double> &numbers)
+    {
+        const rng::KernelTable &k = rng::kernels();
+        Outputs out;
+        for (size_t length : LENGTHS)
+        {
+            out.integers.push_back(k.popcount_words(words.data(), length));
+            out.integers.push_back(k.transition_words(words.data(), length));
+
+            std::vector<uint8_t> counts(length);
+            for (uint64_t mask : {~0ULL, 0x00ff00ff00ff00ffULL, 1ULL << 63})
+            {
+                k.popcounts(words.data(), length, mask, counts.data());
+                out.bytes.insert(out.bytes.end(), counts.begin(), counts.end());
+            }
+
+            std::vector<uint64_t> mixed(words.begin(), words.begin() + length);
+            k.xor_words(mixed.data(), words.data() + 1, length);
+            out.integers.insert(out.integers.end(), mixed.begin(), mixed.end());
+
+            for (size_t start = 0; start + 64 <= numbers.size() && start < length; start += 61)
+            {
+                size_t span = std::min<size_t>(64, length - start);
+                out.integers.push_back(k.continuation_mask(numbers.data() + start, span, true));
+                out.integers.push_back(k.continuation_mask(numbers.data() + start, span, false));
+            }
+
+            std::vector<uint32_t> binned(length);
+            for (uint32_t bins : {1u, 10u, 64u, 1000003u})
+            {
+                k.bin_numbers(numbers.data(), length, bins, binned.data());
+                out.bins.insert(out.bins.end(), binned.begin(), binned.end());
+            }
+
+            double sums[5] = {0.25, 0.0, 0.0, 0.0, 0.0};
+            k.pair_sums(numbers.data(), length, sums);
+            out.sums.insert(out.sums.end(), sums, sums + 5);
+        }
+        return out;
+    }
+
+    bool same(const Outputs &a, const Outputs &b)
+    {
+        return a.integers == b.integers && a.bytes == b.bytes && a.bins == b.bins &&
+               a.sums.size() == b.sums.size() &&
+               std::memcmp(a.sums.data(), b.sums.data(), a.sums.size() * sizeof(double)) == 0;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937_64 random(2024);
+    std::vector<uint64_t> words(4100 + 1);
+    for (uint64_t &word : words)
+        word = random();
+
+    // Uniforms with ties and the edges 0, 1 and exact bin boundaries mixed in
+    std::vector<double> numbers(4100);
+    for (size_t i = 0; i < numbers.size(); ++i)
+    {
+        numbers[i] = static_cast<double>(random() >> 11) * 0x1.0p-53;
+        if (i % 17 == 0)
+            numbers[i] = numbers[i / 2];
+        if (i % 101 == 0)
+            numbers[i] = static_cast<double>(i % 11) / 10.0;
+    }
+    numbers[5] = 0.0;
+    numbers[6] = 1.0;
+
+    rng::select_cpu_level(rng::CpuLevel::Baseline);
+    Outputs expected = run_all(words, numbers);
+
+    bool pass = true;
+    for (rng::CpuLevel level : {rng::CpuLevel::Sse42, rng::CpuLevel::Avx2, rng::CpuLevel::Avx512})
+    {
+        if (level > rng::detected_cpu_level())
+        {
+            std::cout << "SKIP " << rng::cpu_level_name(level) << ": not supported here\n";
+            continue;
+        }
+        rng::select_cpu_level(level);
+        bool match = same(run_all(words, numbers), expected);
+        std::cout << (match ? "PASS " : "FAIL ") << rng::cpu_level_name(level) << "\n";
+        pass &= match;
+    }
+    return pass ? 0 : 1;
+}
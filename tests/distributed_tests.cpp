@@ -0,0 +1,207 @@
+#include "../include/engine/distributed.hpp"
+#include "../include/engine/fused_runner.hpp"
+#include "../include/generators/combined.hpp"
+#include "../include/tests/randomness_tests.hpp"
+#include "../include/utils/serialization.hpp"
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// A worker that stops answering mid-shard must be killed after the shard
+// timeout, its shard run again elsewhere, and the merged result must match
+// a run without workers. Over either transport and with several threads
+// per worker, the suite's streaming tests must also reach the p-values of
+// an unsharded run_fused() over the same numbers.
+
+namespace
+{
+    // Counts and sums the numbers it sees. With a marker path, the first
+    // copy to create the marker file hangs inside update(), so exactly one
+    // worker stalls across all processes.
+    class StallingTest : public rng::StreamingTest
+    {
+    public:
+        explicit StallingTest(std::string marker = "") : marker_(std::move(marker)) {}
+
+        void reset() override
+        {
+            count_ = 0;
+            sum_ = 0.0;
+        }
+
+        void update(const double *numbers, size_t count) override
+        {
+#ifndef _WIN32
+            if (!marker_.empty() && ::open(marker_.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644) >= 0)
+            {
+                while (true)
+                    ::pause();
+            }
+#endif
+            for (size_t i = 0; i < count; ++i)
+                sum_ += numbers[i];
+            count_ += count;
+        }
+
+        void merge(const rng::StreamingTest &other) override
+        {
+            const auto &part = static_cast<const StallingTest &>(other);
+            count_ += part.count_;
+            sum_ += part.sum_;
+        }
+
+        bool evaluate(double) override { return true; }
+
+        std::unique_ptr<rng::StreamingTest> clone_empty() const override
+        {
+            auto copy = std::make_unique<StallingTest>(marker_);
+            copy->reset();
+            return copy;
+        }
+
+        void save_state(rng::BinaryWriter &out) const override
+        {
+            out.write_u64(count_);
+            out.write_f64(sum_);
+        }
+
+        void load_state(rng::BinaryReader &in) override
+        {
+            count_ = in.read_u64();
+            sum_ = in.read_f64();
+        }
+
+        std::string get_test_name() const override { return "Stalling Test"; }
+        std::string get_config() const override { return get_test_name(); }
+        std::string get_test_result() const override { return ""; }
+        double get_p_value() const override { return 1.0; }
+
+        uint64_t count() const { return count_; }
+        double sum() const { return sum_; }
+
+    private:
+        std::string marker_;
+        uint64_t count_ = 0;
+        double sum_ = 0.0;
+    };
+
+    bool expect(bool condition, const std::string &what)
+    {
+        std::cout << (condition ? "PASS " : "FAIL ") << what << "\n";
+        return condition;
+    }
+
+    std::vector<std::unique_ptr<rng::StreamingTest>> streaming_suite()
+    {
+        std::vector<std::unique_ptr<rng::StreamingTest>> tests;
+        for (auto &test : rng::create_test_suite())
+        {
+            if (auto *streaming = dynamic_cast<rng::StreamingTest *>(test.get()))
+                tests.push_back(streaming->clone_empty());
+        }
+        return tests;
+    }
+
+    std::vector<rng::StreamingTest *> pointers(const std::vector<std::unique_ptr<rng::StreamingTest>> &tests)
+    {
+        std::vector<rng::StreamingTest *> result;
+        for (const auto &test : tests)
+            result.push_back(test.get());
+        return result;
+    }
+
+    // Shards that cut groups of the Knuth tests, several threads per worker
+    bool matches_unsharded(rng::DistributedTransport transport, const std::string &name)
+    {
+        constexpr uint64_t TOTAL = 600001;
+        rng::MRG32k3a source = rng::make_mrg32k3a(7);
+        std::vector<double> numbers(TOTAL);
+        source.fill(numbers.data(), TOTAL);
+        auto expected = streaming_suite();
+        rng::run_fused(pointers(expected), numbers, 0.01, 1);
+
+        rng::DistributedOptions options;
+        options.total_numbers = TOTAL;
+        options.shard_size = 150001;
+        options.workers = 2;
+        options.threads_per_worker = 2;
+        options.transport = transport;
+        auto tests = streaming_suite();
+        rng::MRG32k3a generator = rng::make_mrg32k3a(7);
+        rng::DistributedResult result = rng::run_distributed(generator, pointers(tests), options, 0.01);
+
+        bool pass = result.shards == 4 && generator.get_state() == source.get_state();
+        for (size_t t = 0; t < tests.size(); ++t)
+        {
+            double p = tests[t]->get_p_value();
+            double q = expected[t]->get_p_value();
+            // Serial correlation sums doubles, grouped by shard and thread
+            bool floating = dynamic_cast<rng::SerialCorrelationTest *>(tests[t].get()) != nullptr;
+            bool same = floating ? std::fabs(p - q) <= 1e-9 : p == q;
+            if (!same)
+                std::cout << "  " << tests[t]->get_test_name() << ": " << p << " vs " << q << "\n";
+            pass &= same;
+        }
+        return expect(pass, name + " matches an unsharded run");
+    }
+} // namespace
+
+int main()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    const std::string marker = "/tmp/rng_distributed_stall_" + std::to_string(::getpid());
+    ::unlink(marker.c_str());
+
+    rng::DistributedOptions options;
+    options.total_numbers = 1 << 18;
+    options.shard_size = 1 << 14;
+    options.shard_timeout_seconds = 0.5;
+
+    rng::ChiSquareTest reference_chi(100);
+    StallingTest reference_sum;
+    rng::MRG32k3a reference_generator = rng::make_mrg32k3a(42);
+    options.workers = 0;
+    rng::run_distributed(reference_generator, {&reference_chi, &reference_sum}, options, 0.01);
+
+    rng::ChiSquareTest chi(100);
+    StallingTest sum(marker);
+    rng::MRG32k3a generator = rng::make_mrg32k3a(42);
+    options.workers = 2;
+    rng::DistributedResult result;
+    try
+    {
+        result = rng::run_distributed(generator, {&chi, &sum}, options, 0.01);
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "FAIL distributed run threw: " << e.what() << "\n";
+        ::unlink(marker.c_str());
+        return 1;
+    }
+    bool stalled = ::access(marker.c_str(), F_OK) == 0;
+    ::unlink(marker.c_str());
+
+    bool pass = true;
+    pass &= expect(stalled, "a worker stalled");
+    pass &= expect(result.timed_out_workers == 1, "the stalled worker timed out");
+    pass &= expect(result.worker_failures == 1, "no other worker was lost");
+    pass &= expect(result.reassigned_shards >= 1, "its shard was sent again");
+    pass &= expect(sum.count() == options.total_numbers && sum.count() == reference_sum.count(),
+                   "every number was counted once");
+    pass &= expect(sum.sum() == reference_sum.sum(), "sums match the run without workers");
+    pass &= expect(chi.get_p_value() == reference_chi.get_p_value(), "chi-square matches the run without workers");
+    pass &= expect(generator.get_state() == reference_generator.get_state(), "generator advanced the same");
+
+    pass &= matches_unsharded(rng::DistributedTransport::UnixSocket, "unix socket");
+    pass &= matches_unsharded(rng::DistributedTransport::LoopbackTcp, "loopback tcp");
+    return pass ? 0 : 1;
+#endif
+}
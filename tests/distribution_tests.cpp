@@ -0,0 +1,78 @@
+#include "../include/distributions/distributions.hpp"
+#include "../include/distributions/transformed_generator.hpp"
+#include "../include/generators/combined.hpp"
+#include "../include/tests/statistics.hpp"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Samplers checked through their probability integral transform:
+// TransformedGenerator::fill() draws with sample_batch(), generate() with
+// sample(), and both map every variate through the cdf (randomized for
+// the discrete alias-table distributions), so a correct sampler gives
+// uniforms. The uniforms are binned and compared with a chi-square test.
+
+namespace
+{
+    constexpr size_t SAMPLES = 1 << 20;
+    constexpr size_t BINS = 256;
+    constexpr double SIGNIFICANCE = 1e-6;
+
+    bool check(std::unique_ptr<rng::Distribution> distribution, bool batch = true)
+    {
+        std::string name = distribution->get_name() + (batch ? " batch" : " single");
+        rng::TransformedGenerator generator(std::make_unique<rng::MRG32k3a>(rng::make_mrg32k3a()),
+                                            std::move(distribution));
+        std::vector<double> uniforms(SAMPLES);
+        if (batch)
+        {
+            generator.fill(uniforms.data(), SAMPLES);
+        }
+        else
+        {
+            for (double &u : uniforms)
+                u = generator.generate();
+        }
+
+        std::vector<uint64_t> counts(BINS, 0);
+        for (double u : uniforms)
+        {
+            counts[static_cast<size_t>(u * BINS)]++;
+        }
+        double expected = static_cast<double>(SAMPLES) / BINS;
+        double statistic = 0.0;
+        for (uint64_t count : counts)
+        {
+            double diff = static_cast<double>(count) - expected;
+            statistic += diff * diff / expected;
+        }
+        double p_value = rng::chi_square_p_value(statistic, BINS - 1);
+        bool pass = p_value > SIGNIFICANCE;
+        std::cout << (pass ? "PASS " : "FAIL ") << name << ": p = " << p_value << "\n";
+        return pass;
+    }
+} // namespace
+
+int main()
+{
+    bool pass = true;
+    pass &= check(std::make_unique<rng::NormalDistribution>(1.0, 2.0));
+    pass &= check(std::make_unique<rng::ExponentialDistribution>(0.5));
+    pass &= check(std::make_unique<rng::GammaDistribution>(2.5, 2.0));
+    pass &= check(std::make_unique<rng::GammaDistribution>(0.5));
+    pass &= check(std::make_unique<rng::GammaDistribution>(30.0));
+    pass &= check(std::make_unique<rng::NormalDistribution>(), false);
+    pass &= check(std::make_unique<rng::ExponentialDistribution>(), false);
+
+    // Alias tables, their inverted tails and the randomized transform
+    for (bool batch : {true, false})
+    {
+        pass &= check(std::make_unique<rng::PoissonDistribution>(0.3), batch);
+        pass &= check(std::make_unique<rng::PoissonDistribution>(12.5), batch);
+        pass &= check(std::make_unique<rng::PoissonDistribution>(1000.0), batch);
+        pass &= check(std::make_unique<rng::BinomialDistribution>(1, 0.5), batch);
+        pass &= check(std::make_unique<rng::BinomialDistribution>(20, 0.3), batch);
+        pass &= check(std::make_unique<rng::BinomialDistribution>(1000, 0.02), batch);
+    }
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include "../include/generators/lcg.hpp"
+#include "../include/generators/mcg.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// jump_ahead(n) must leave a generator exactly where n calls to
+// generate_raw() would, including moduli above 2^32 where a * x no longer
+// fits in 64 bits.
+
+namespace
+{
+    constexpr uint64_t PRIME_64 = 18446744073709551557ULL; // 2^64 - 59
+
+    bool check(const std::string &name, const rng::RandomGenerator &generator)
+    {
+        bool pass = true;
+        for (uint64_t steps : {1ULL, 2ULL, 7ULL, 1000ULL, 123457ULL})
+        {
+            auto stepped = generator.clone();
+            for (uint64_t i = 0; i < steps; ++i)
+                stepped->generate_raw();
+            auto jumped = generator.clone();
+            jumped->jump_ahead(steps);
+            pass &= stepped->get_state() == jumped->get_state();
+            pass &= stepped->generate_raw() == jumped->generate_raw();
+        }
+        std::cout << (pass ? "PASS " : "FAIL ") << name << "\n";
+        return pass;
+    }
+} // namespace
+
+int main()
+{
+    bool pass = true;
+    pass &= check("lcg default", rng::LCG(42));
+    pass &= check("mcg default", rng::MCG(42));
+    pass &= check("lcg 2^32", rng::LCG(4294967295ULL, 1664525, 1013904223, 1ULL << 32));
+    pass &= check("lcg 2^64-59", rng::LCG(PRIME_64 - 2, 13891176665706064842ULL, 1442695040888963407ULL, PRIME_64));
+    pass &= check("mcg 2^64-59", rng::MCG(PRIME_64 - 2, 13891176665706064842ULL, PRIME_64));
+
+    // One step by hand across the 2^64 boundary of a * x
+    rng::MCG mcg(PRIME_64 - 1, PRIME_64 - 1, PRIME_64);
+    bool first = mcg.generate_raw() == 1; // (-1) * (-1) = 1 mod p
+    std::cout << (first ? "PASS " : "FAIL ") << "mcg wide product\n";
+    pass &= first;
+
+    // Zero is absorbing for an MCG, so it is no more valid as a state than as a seed
+    bool rejected = false;
+    try
+    {
+        mcg.set_state({0});
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected = true;
+    }
+    std::cout << (rejected ? "PASS " : "FAIL ") << "mcg rejects zero state\n";
+    pass &= rejected;
+    return pass ? 0 : 1;
+}
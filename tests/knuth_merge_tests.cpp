@@ -0,0 +1,150 @@
+#include "../include/engine/fused_runner.hpp"
+#include "../include/generators/combined.hpp"
+#include "../include/tests/knuth_tests.hpp"
+#include "../include/utils/serialization.hpp"
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// The streaming Knuth tests must reach the same statistic however the
+// sequence is cut into parts: the parts are fed separately (some through a
+// save/load round trip) and merged with their neighbours in random order,
+// and the result is compared with a single pass and with the fused runner
+// on several threads.
+
+namespace
+{
+    constexpr size_t COUNT = 300007;
+    constexpr int SPLITS = 20;
+
+    using Factory = std::function<std::unique_ptr<rng::StreamingTest>()>;
+
+    struct Outcome
+    {
+        double p_value;
+        std::string result;
+    };
+
+    Outcome evaluate(rng::StreamingTest &test)
+    {
+        test.evaluate(0.01);
+        return {test.get_p_value(), test.get_test_result()};
+    }
+
+    bool same(const Outcome &a, const Outcome &b)
+    {
+        return a.result == b.result && (a.p_value == b.p_value || (a.p_value != a.p_value && b.p_value != b.p_value));
+    }
+
+    Outcome split_run(const Factory &make, const std::vector<double> &numbers, std::mt19937_64 &random)
+    {
+        auto whole = make();
+        std::vector<std::unique_ptr<rng::StreamingTest>> parts;
+        size_t offset = 0;
+        while (offset < numbers.size() || parts.empty())
+        {
+            // Mostly short parts so that many seams fall inside a group
+            size_t limit = random() % 4 == 0 ? 5000 : 12;
+            size_t length = std::min<size_t>(random() % limit, numbers.size() - offset);
+            auto part = whole->clone_empty();
+            for (size_t fed = 0; fed < length;)
+            {
+                size_t chunk = std::min<size_t>(1 + random() % 97, length - fed);
+                part->update(numbers.data() + offset + fed, chunk);
+                fed += chunk;
+            }
+            if (random() % 3 == 0)
+            {
+                rng::BinaryWriter out;
+                part->save_state(out);
+                auto restored = whole->clone_empty();
+                rng::BinaryReader in(out.data());
+                restored->load_state(in);
+                part = std::move(restored);
+            }
+            parts.push_back(std::move(part));
+            offset += length;
+        }
+
+        // Neighbours are merged in random order, so merged parts get merged again
+        while (parts.size() > 1)
+        {
+            size_t i = random() % (parts.size() - 1);
+            parts[i]->merge(*parts[i + 1]);
+            parts.erase(parts.begin() + i + 1);
+        }
+        whole->merge(*parts.front());
+        return evaluate(*whole);
+    }
+
+    bool check(const std::string &name, const Factory &make, const std::vector<double> &numbers)
+    {
+        auto single = make();
+        single->reset();
+        single->update(numbers.data(), numbers.size());
+        Outcome expected = evaluate(*single);
+
+        bool pass = true;
+        std::mt19937_64 random(12345);
+        for (int split = 0; split < SPLITS && pass; ++split)
+        {
+            pass = same(split_run(make, numbers, random), expected);
+        }
+        for (size_t threads : {1, 2, 3, 4})
+        {
+            auto fused = make();
+            rng::feed_fused({fused.get()}, numbers.data(), numbers.size(), threads);
+            pass &= same(evaluate(*fused), expected);
+        }
+
+        std::cout << (pass ? "PASS " : "FAIL ") << name << ": p = " << expected.p_value << "\n";
+        return pass;
+    }
+
+    bool check_all(const std::string &sequence, const std::vector<double> &numbers)
+    {
+        bool pass = true;
+        pass &= check(sequence + " poker 10/5", []
+                      { return std::make_unique<rng::PokerTest>(10, 5); }, numbers);
+        pass &= check(sequence + " poker 4/2", []
+                      { return std::make_unique<rng::PokerTest>(4, 2); }, numbers);
+        pass &= check(sequence + " poker 6/12", []
+                      { return std::make_unique<rng::PokerTest>(6, 12); }, numbers);
+        pass &= check(sequence + " coupon 5/30", []
+                      { return std::make_unique<rng::CouponCollectorTest>(5, 30); }, numbers);
+        pass &= check(sequence + " coupon 2/3", []
+                      { return std::make_unique<rng::CouponCollectorTest>(2, 3); }, numbers);
+        pass &= check(sequence + " coupon 12/60", []
+                      { return std::make_unique<rng::CouponCollectorTest>(12, 60); }, numbers);
+        pass &= check(sequence + " max-of-t 5/10", []
+                      { return std::make_unique<rng::MaximumOfTTest>(5, 10); }, numbers);
+        pass &= check(sequence + " max-of-t 2/3", []
+                      { return std::make_unique<rng::MaximumOfTTest>(2, 3); }, numbers);
+        pass &= check(sequence + " max-of-t 20/50", []
+                      { return std::make_unique<rng::MaximumOfTTest>(20, 50); }, numbers);
+        pass &= check(sequence + " gap", []
+                      { return std::make_unique<rng::GapTest>(0.2, 0.6, 12); }, numbers);
+        pass &= check(sequence + " runs up", []
+                      { return std::make_unique<rng::RunsUpDownTest>(rng::RunDirection::Up, 1); }, numbers);
+        return pass;
+    }
+} // namespace
+
+int main()
+{
+    rng::MRG32k3a generator = rng::make_mrg32k3a();
+    std::vector<double> uniform(COUNT);
+    generator.fill(uniform.data(), COUNT);
+
+    // Short cycles keep the coupon-collector restarts apart for the whole part
+    std::vector<double> periodic(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        periodic[i] = ((i * 7) % 13 + 0.5) / 13.0 * (i % 1000 < 990 ? 1.0 : uniform[i]);
+
+    bool pass = true;
+    pass &= check_all("uniform", uniform);
+    pass &= check_all("periodic", periodic);
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#include "../include/generators/icg.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Every lane of MultiStreamICG must be the scalar ICG with the same
+// parameters started from that lane's state: output k * N + i is the k-th
+// output of lane i. The batch inversion (one inverse per round through
+// prefix products) must also handle lanes at zero like ICG does, by going
+// on from one.
+
+namespace
+{
+    constexpr size_t ROUNDS = 3000;
+
+    bool check(const std::string &name, rng::MultiStreamICG &generator, uint64_t a, uint64_t b, uint64_t m)
+    {
+        const size_t n = generator.streams();
+        std::vector<uint64_t> state = generator.get_state();
+        std::vector<rng::ICG> lanes;
+        for (size_t i = 0; i < n; ++i)
+            lanes.emplace_back(state[i + 1], a, b, m);
+
+        bool pass = true;
+        size_t zeros = 0;
+        for (size_t round = 0; round < ROUNDS && pass; ++round)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                uint64_t expected = lanes[i].generate_raw();
+                zeros += expected == 0;
+                pass &= generator.generate_raw() == expected;
+            }
+        }
+        std::cout << (pass ? "PASS " : "FAIL ") << name << " (" << zeros << " zero outputs)\n";
+        return pass;
+    }
+
+    // Starts every lane at the given values, due to step on the next output
+    void start_at(rng::MultiStreamICG &generator, const std::vector<uint64_t> &values)
+    {
+        std::vector<uint64_t> state = {generator.streams()};
+        state.insert(state.end(), values.begin(), values.end());
+        generator.set_state(state);
+    }
+} // namespace
+
+int main()
+{
+    bool pass = true;
+
+    rng::MultiStreamICG seeded(12345);
+    pass &= check("64 streams, seeded", seeded, 1288490188, 1, 2147483647);
+
+    rng::MultiStreamICG odd(7, 7, 1288490188, 1, 2147483647);
+    pass &= check("7 streams, seeded", odd, 1288490188, 1, 2147483647);
+
+    rng::MultiStreamICG single(3, 1, 1288490188, 1, 2147483647);
+    pass &= check("1 stream", single, 1288490188, 1, 2147483647);
+
+    // Zero lanes at the start, first, inside and last in the product
+    rng::MultiStreamICG zero_start(1, 5, 1288490188, 1, 2147483647);
+    start_at(zero_start, {0, 17, 0, 2147483646, 0});
+    pass &= check("zero lanes", zero_start, 1288490188, 1, 2147483647);
+
+    // With a small prime the lanes reach zero on their own along the way
+    rng::MultiStreamICG small(99, 64, 1234, 5, 65521);
+    start_at(small, std::vector<uint64_t>(64, 0));
+    pass &= check("all lanes zero, m = 65521", small, 1234, 5, 65521);
+    rng::MultiStreamICG small_seeded(2024, 33, 1234, 5, 65521);
+    pass &= check("33 streams, m = 65521", small_seeded, 1234, 5, 65521);
+
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+#include "../include/tests/nist_bit_tests.hpp"
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// The worked examples of NIST SP 800-22 rev. 1a (sections 2.1.8, 2.3.8 and
+// 2.4.8) with the P-values printed there. Bit i of the example is bit
+// i % 64 of word i / 64, the order generate_bit_sequence() packs in.
+
+namespace
+{
+    // The 100-bit example of sections 2.1.8 and 2.3.8
+    const std::string EXAMPLE_100 =
+        "11001001000011111101101010100010001000010110100011"
+        "00001000110100110001001100011001100010100010111000";
+
+    // The 128-bit example of section 2.4.8
+    const std::string EXAMPLE_128 =
+        "11001100000101010110110001001100111000000000001001"
+        "00110101010001000100111101011010000000110101111100"
+        "1100111001101101100010110010";
+
+    rng::BitSequence to_bits(const std::string &text)
+    {
+        rng::BitSequence bits;
+        bits.bit_count = text.size();
+        bits.value_bits = 1;
+        bits.words.assign((text.size() + 63) / 64, 0);
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            if (text[i] == '1')
+                bits.words[i / 64] |= 1ULL << (i % 64);
+        }
+        return bits;
+    }
+
+    bool check(rng::BitStreamTest &test, const std::string &example, double expected)
+    {
+        bool passed = test.run_test(to_bits(example), 0.01);
+        double p_value = test.get_p_value();
+        // The standard prints six decimals
+        bool pass = std::fabs(p_value - expected) < 5e-7 && passed == (expected >= 0.01);
+        std::cout << (pass ? "PASS " : "FAIL ") << test.get_test_name() << ": p = " << p_value
+                  << " (expected " << expected << ")\n";
+        return pass;
+    }
+} // namespace
+
+int main()
+{
+    bool pass = true;
+    rng::MonobitTest monobit;
+    pass &= check(monobit, EXAMPLE_100, 0.109599);
+    rng::BitRunsTest runs;
+    pass &= check(runs, EXAMPLE_100, 0.500798);
+    rng::LongestRunTest longest_run;
+    pass &= check(longest_run, EXAMPLE_128, 0.180609);
+    return pass ? 0 : 1;
+}